@@ -0,0 +1,392 @@
+#include "AudioThreadGuard.h"
+
+#if MIH_AUDIO_THREAD_GUARD
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+
+#if defined(_WIN32)
+ #include <malloc.h>
+#endif
+
+#if defined(__linux__)
+ #include <dlfcn.h>
+ #include <pthread.h>
+#elif defined(__APPLE__)
+ #include <mach/mach.h>
+ #include <malloc/malloc.h>
+#endif
+
+namespace
+{
+    thread_local int guardDepth = 0;
+
+    [[noreturn]] void reportViolation(const char* what) noexcept
+    {
+        // Drop the guard so that the report itself can't recurse into us
+        guardDepth = 0;
+
+        std::fputs("AudioThreadGuard: ", stderr);
+        std::fputs(what, stderr);
+        std::fputs(" on the audio thread inside processBlock\n", stderr);
+        std::fflush(stderr);
+        std::abort();
+    }
+
+    void* allocate(std::size_t size) noexcept
+    {
+        if (guardDepth > 0)
+            reportViolation("heap allocation");
+
+        return std::malloc(size == 0 ? 1 : size);
+    }
+
+    void* allocateAligned(std::size_t size, std::align_val_t alignment) noexcept
+    {
+        if (guardDepth > 0)
+            reportViolation("heap allocation");
+
+        const auto align = std::max(sizeof(void*), static_cast<std::size_t>(alignment));
+        size = size == 0 ? 1 : size;
+
+#if defined(_WIN32)
+        return _aligned_malloc(size, align);
+#else
+        void* ptr = nullptr;
+        return posix_memalign(&ptr, align, size) == 0 ? ptr : nullptr;
+#endif
+    }
+
+    void release(void* ptr) noexcept
+    {
+        if (ptr != nullptr && guardDepth > 0)
+            reportViolation("heap deallocation");
+
+        std::free(ptr);
+    }
+
+    void releaseAligned(void* ptr) noexcept
+    {
+        if (ptr != nullptr && guardDepth > 0)
+            reportViolation("heap deallocation");
+
+#if defined(_WIN32)
+        _aligned_free(ptr);
+#else
+        std::free(ptr);
+#endif
+    }
+}
+
+namespace AudioThreadGuard
+{
+    Scope::Scope() noexcept    { ++guardDepth; }
+    Scope::~Scope() noexcept   { --guardDepth; }
+
+    Suspend::Suspend() noexcept : savedDepth(guardDepth) { guardDepth = 0; }
+    Suspend::~Suspend() noexcept { guardDepth = savedDepth; }
+
+    bool isActive() noexcept { return guardDepth > 0; }
+}
+
+//==============================================================================
+// Global allocation hooks
+void* operator new(std::size_t size)
+{
+    if (auto* ptr = allocate(size))
+        return ptr;
+
+    throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size)
+{
+    if (auto* ptr = allocate(size))
+        return ptr;
+
+    throw std::bad_alloc();
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept   { return allocate(size); }
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept { return allocate(size); }
+
+void* operator new(std::size_t size, std::align_val_t alignment)
+{
+    if (auto* ptr = allocateAligned(size, alignment))
+        return ptr;
+
+    throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size, std::align_val_t alignment)
+{
+    if (auto* ptr = allocateAligned(size, alignment))
+        return ptr;
+
+    throw std::bad_alloc();
+}
+
+void operator delete(void* ptr) noexcept                                    { release(ptr); }
+void operator delete[](void* ptr) noexcept                                  { release(ptr); }
+void operator delete(void* ptr, std::size_t) noexcept                       { release(ptr); }
+void operator delete[](void* ptr, std::size_t) noexcept                     { release(ptr); }
+void operator delete(void* ptr, const std::nothrow_t&) noexcept             { release(ptr); }
+void operator delete[](void* ptr, const std::nothrow_t&) noexcept           { release(ptr); }
+void operator delete(void* ptr, std::align_val_t) noexcept                  { releaseAligned(ptr); }
+void operator delete[](void* ptr, std::align_val_t) noexcept                { releaseAligned(ptr); }
+void operator delete(void* ptr, std::size_t, std::align_val_t) noexcept     { releaseAligned(ptr); }
+void operator delete[](void* ptr, std::size_t, std::align_val_t) noexcept   { releaseAligned(ptr); }
+
+//==============================================================================
+// C allocator hooks. juce::HeapBlock (and so AudioBuffer::setSize, MemoryBlock
+// etc.) allocates with std::malloc and friends rather than operator new.
+#if defined(__linux__)
+namespace
+{
+    // dlsym() may itself allocate while it looks the real allocator up; those
+    // requests are served from here, zeroed, and never given back
+    alignas(std::max_align_t) char bootstrapArena[16384];
+    std::atomic<std::size_t> bootstrapUsed{0};
+    thread_local bool resolving = false;
+
+    void* bootstrapAllocate(std::size_t size) noexcept
+    {
+        size = (size + alignof(std::max_align_t) - 1) & ~(alignof(std::max_align_t) - 1);
+        const auto offset = bootstrapUsed.fetch_add(size);
+
+        return offset + size <= sizeof(bootstrapArena) ? bootstrapArena + offset : nullptr;
+    }
+
+    bool isBootstrap(const void* ptr) noexcept
+    {
+        return ptr >= bootstrapArena && ptr < bootstrapArena + sizeof(bootstrapArena);
+    }
+
+    // The next definition of name after ours (libc's), looked up once
+    template <typename Function>
+    Function getReal(std::atomic<Function>& cache, const char* name) noexcept
+    {
+        auto function = cache.load(std::memory_order_acquire);
+
+        if (function == nullptr)
+        {
+            resolving = true;
+            function = reinterpret_cast<Function>(dlsym(RTLD_NEXT, name));
+            resolving = false;
+            cache.store(function, std::memory_order_release);
+        }
+
+        return function;
+    }
+}
+
+// The executable's definitions interpose the libc ones for every library
+extern "C" void* malloc(std::size_t size) noexcept
+{
+    static std::atomic<void* (*)(std::size_t)> real{nullptr};
+
+    if (resolving)
+        return bootstrapAllocate(size);
+
+    if (guardDepth > 0)
+        reportViolation("heap allocation");
+
+    return getReal(real, "malloc")(size);
+}
+
+extern "C" void* calloc(std::size_t count, std::size_t size) noexcept
+{
+    static std::atomic<void* (*)(std::size_t, std::size_t)> real{nullptr};
+
+    if (resolving)
+        return bootstrapAllocate(count * size);
+
+    if (guardDepth > 0)
+        reportViolation("heap allocation");
+
+    return getReal(real, "calloc")(count, size);
+}
+
+extern "C" void* realloc(void* ptr, std::size_t size) noexcept
+{
+    static std::atomic<void* (*)(void*, std::size_t)> real{nullptr};
+
+    if (resolving)
+        return bootstrapAllocate(size);
+
+    if (guardDepth > 0)
+        reportViolation("heap allocation");
+
+    // Bootstrap blocks don't know their size; copy what the arena holds
+    if (isBootstrap(ptr))
+    {
+        auto* moved = getReal(real, "realloc")(nullptr, size);
+        const auto available = (std::size_t)(bootstrapArena + sizeof(bootstrapArena) - static_cast<char*>(ptr));
+
+        if (moved != nullptr)
+            std::memcpy(moved, ptr, std::min(size, available));
+
+        return moved;
+    }
+
+    return getReal(real, "realloc")(ptr, size);
+}
+
+extern "C" void free(void* ptr) noexcept
+{
+    static std::atomic<void (*)(void*)> real{nullptr};
+
+    if (ptr == nullptr || isBootstrap(ptr))
+        return;
+
+    if (guardDepth > 0)
+        reportViolation("heap deallocation");
+
+    getReal(real, "free")(ptr);
+}
+
+extern "C" int posix_memalign(void** result, std::size_t alignment, std::size_t size) noexcept
+{
+    static std::atomic<int (*)(void**, std::size_t, std::size_t)> real{nullptr};
+
+    if (guardDepth > 0)
+        reportViolation("heap allocation");
+
+    return getReal(real, "posix_memalign")(result, alignment, size);
+}
+
+extern "C" void* aligned_alloc(std::size_t alignment, std::size_t size) noexcept
+{
+    static std::atomic<void* (*)(std::size_t, std::size_t)> real{nullptr};
+
+    if (guardDepth > 0)
+        reportViolation("heap allocation");
+
+    return getReal(real, "aligned_alloc")(alignment, size);
+}
+#elif defined(__APPLE__)
+namespace
+{
+    // The default zone's functions as they were before ours replaced them
+    malloc_zone_t originalZone;
+
+    void* zoneMalloc(malloc_zone_t* zone, size_t size)
+    {
+        if (guardDepth > 0)
+            reportViolation("heap allocation");
+
+        return originalZone.malloc(zone, size);
+    }
+
+    void* zoneCalloc(malloc_zone_t* zone, size_t count, size_t size)
+    {
+        if (guardDepth > 0)
+            reportViolation("heap allocation");
+
+        return originalZone.calloc(zone, count, size);
+    }
+
+    void* zoneValloc(malloc_zone_t* zone, size_t size)
+    {
+        if (guardDepth > 0)
+            reportViolation("heap allocation");
+
+        return originalZone.valloc(zone, size);
+    }
+
+    void* zoneRealloc(malloc_zone_t* zone, void* ptr, size_t size)
+    {
+        if (guardDepth > 0)
+            reportViolation("heap allocation");
+
+        return originalZone.realloc(zone, ptr, size);
+    }
+
+    void* zoneMemalign(malloc_zone_t* zone, size_t alignment, size_t size)
+    {
+        if (guardDepth > 0)
+            reportViolation("heap allocation");
+
+        return originalZone.memalign(zone, alignment, size);
+    }
+
+    void zoneFree(malloc_zone_t* zone, void* ptr)
+    {
+        if (ptr != nullptr && guardDepth > 0)
+            reportViolation("heap deallocation");
+
+        originalZone.free(zone, ptr);
+    }
+
+    void zoneFreeDefiniteSize(malloc_zone_t* zone, void* ptr, size_t size)
+    {
+        if (ptr != nullptr && guardDepth > 0)
+            reportViolation("heap deallocation");
+
+        originalZone.free_definite_size(zone, ptr, size);
+    }
+
+    // malloc, calloc, realloc, free and posix_memalign all go through the
+    // default zone, so its function table is patched at static initialisation
+    struct ZoneHooks
+    {
+        ZoneHooks() noexcept
+        {
+            auto* zone = malloc_default_zone();
+            originalZone = *zone;
+
+            // The table is read-only since macOS 10.7
+            const auto address = reinterpret_cast<vm_address_t>(zone);
+            vm_protect(mach_task_self(), address, sizeof(malloc_zone_t), 0, VM_PROT_READ | VM_PROT_WRITE);
+
+            zone->malloc = zoneMalloc;
+            zone->calloc = zoneCalloc;
+            zone->valloc = zoneValloc;
+            zone->realloc = zoneRealloc;
+            zone->free = zoneFree;
+
+            if (zone->version >= 5)
+                zone->memalign = zoneMemalign;
+
+            if (zone->version >= 6)
+                zone->free_definite_size = zoneFreeDefiniteSize;
+
+            vm_protect(mach_task_self(), address, sizeof(malloc_zone_t), 0, VM_PROT_READ);
+        }
+    };
+
+    ZoneHooks zoneHooks;
+}
+#endif
+
+//==============================================================================
+// Lock hook (Linux only: the executable's definition interposes the libc one)
+#if defined(__linux__)
+extern "C" int pthread_mutex_lock(pthread_mutex_t* mutex)
+{
+    using LockFunction = int (*)(pthread_mutex_t*);
+
+    // Constant-initialised, so no static-init guard (which could itself lock) is involved
+    static std::atomic<LockFunction> realLock{nullptr};
+
+    if (guardDepth > 0)
+        reportViolation("mutex lock");
+
+    auto lock = realLock.load(std::memory_order_acquire);
+
+    if (lock == nullptr)
+    {
+        lock = reinterpret_cast<LockFunction>(dlsym(RTLD_NEXT, "pthread_mutex_lock"));
+        realLock.store(lock, std::memory_order_release);
+    }
+
+    return lock(mutex);
+}
+#endif
+
+#endif // MIH_AUDIO_THREAD_GUARD
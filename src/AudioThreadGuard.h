@@ -0,0 +1,69 @@
+#pragma once
+
+// Debug/test aid for keeping processBlock realtime-safe.
+//
+// When the project is configured with -DMIH_AUDIO_THREAD_GUARD=ON, every heap
+// allocation or deallocation and (on Linux) every pthread_mutex_lock made on a
+// thread that currently holds an AudioThreadGuard::Scope aborts the process with a
+// message naming the violation. In normal builds the scope is an empty object and
+// compiles away.
+//
+// Allocations are caught in the global operator new/delete and, on Linux and
+// macOS, in malloc, calloc, realloc, free and posix_memalign too, which is what
+// juce::HeapBlock (AudioBuffer::setSize, MemoryBlock etc.) uses. On Linux the C
+// functions are interposed and forward to libc through dlsym(RTLD_NEXT); on macOS
+// the default malloc zone's functions are wrapped. Windows has operator new/delete
+// only.
+//
+// The hooks replace process-wide symbols, so they are reliable in the Standalone
+// app and the console tools. Inside a host the host's allocator usually wins.
+// `MakeItHappenOTTBenchmark --verify-guard` checks that they fire.
+
+#ifndef MIH_AUDIO_THREAD_GUARD
+ #define MIH_AUDIO_THREAD_GUARD 0
+#endif
+
+namespace AudioThreadGuard
+{
+#if MIH_AUDIO_THREAD_GUARD
+    // Marks the calling thread as an audio thread for the lifetime of the scope
+    struct Scope
+    {
+        Scope() noexcept;
+        ~Scope() noexcept;
+
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+    };
+
+    // Temporarily allows allocations (e.g. for code that is known to run off the
+    // audio thread but is called from inside a guarded scope in a test harness)
+    struct Suspend
+    {
+        Suspend() noexcept;
+        ~Suspend() noexcept;
+
+        Suspend(const Suspend&) = delete;
+        Suspend& operator=(const Suspend&) = delete;
+
+    private:
+        int savedDepth;
+    };
+
+    bool isActive() noexcept;
+    constexpr bool isCompiledIn() noexcept { return true; }
+#else
+    struct Scope
+    {
+        Scope() noexcept {}
+    };
+
+    struct Suspend
+    {
+        Suspend() noexcept {}
+    };
+
+    inline bool isActive() noexcept { return false; }
+    constexpr bool isCompiledIn() noexcept { return false; }
+#endif
+}
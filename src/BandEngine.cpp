@@ -0,0 +1,35 @@
+#include "BandEngine.h"
+
+namespace
+{
+    template <int NumChannels, typename SampleType>
+    std::unique_ptr<BandEngineBase> createForChannels(int numBands)
+    {
+        switch (numBands)
+        {
+            case 3: return std::make_unique<BandEngine<3, NumChannels, SampleType>>();
+            case 4: return std::make_unique<BandEngine<4, NumChannels, SampleType>>();
+            case 5: return std::make_unique<BandEngine<5, NumChannels, SampleType>>();
+            default: break;
+        }
+
+        jassertfalse;
+        return std::make_unique<BandEngine<3, NumChannels, SampleType>>();
+    }
+
+    template <typename SampleType>
+    std::unique_ptr<BandEngineBase> createForPrecision(int numBands, int numChannels)
+    {
+        if (numChannels == 1)
+            return createForChannels<1, SampleType>(numBands);
+
+        jassert(numChannels == 2);
+        return createForChannels<2, SampleType>(numBands);
+    }
+}
+
+std::unique_ptr<BandEngineBase> createBandEngine(int numBands, int numChannels, bool doublePrecision)
+{
+    return doublePrecision ? createForPrecision<double>(numBands, numChannels)
+                           : createForPrecision<float>(numBands, numChannels);
+}
@@ -0,0 +1,508 @@
+#pragma once
+#include <juce_dsp/juce_dsp.h>
+#include "CompressorKernel.h"
+#include "LinearPhaseCrossover.h"
+#include "LinkwitzRileyCrossover.h"
+#include "Lookahead.h"
+#include "ParameterSnapshot.h"
+
+// Crossover layout for each band count: the parameter set (slot) each band reads,
+// low to high, and the crossover frequencies between neighbouring bands.
+template <int NumBands>
+struct BandLayout;
+
+template <>
+struct BandLayout<3>
+{
+    static constexpr int slots[] = { ParameterSnapshot::lowSlot, ParameterSnapshot::midSlot,
+                                     ParameterSnapshot::highSlot };
+    static constexpr float crossovers[] = { 250.0f, 2000.0f };
+};
+
+template <>
+struct BandLayout<4>
+{
+    static constexpr int slots[] = { ParameterSnapshot::lowSlot, ParameterSnapshot::lowMidSlot,
+                                     ParameterSnapshot::midSlot, ParameterSnapshot::highSlot };
+    static constexpr float crossovers[] = { 120.0f, 500.0f, 2000.0f };
+};
+
+template <>
+struct BandLayout<5>
+{
+    static constexpr int slots[] = { ParameterSnapshot::lowSlot, ParameterSnapshot::lowMidSlot,
+                                     ParameterSnapshot::midSlot, ParameterSnapshot::highMidSlot,
+                                     ParameterSnapshot::highSlot };
+    static constexpr float crossovers[] = { 100.0f, 400.0f, 1500.0f, 5000.0f };
+};
+
+// Interface shared by every BandEngine instantiation, so the processor can switch
+// band modes with one virtual call per block instead of branching per band.
+// process() depends on the sample type, so it lives in TypedBandEngine.
+class BandEngineBase
+{
+public:
+    virtual ~BandEngineBase() = default;
+
+    virtual int getNumBands() const noexcept = 0;
+    virtual int getNumChannels() const noexcept = 0;
+
+    // Allocates the band buffers and prepares the crossovers; call from prepareToPlay
+    virtual void prepare(double sampleRate, int maxBlockSize) = 0;
+
+    // Clears filter and envelope state
+    virtual void reset() noexcept = 0;
+
+    virtual void setCompressorMode(CompressorKernelBase::Mode mode) noexcept = 0;
+    virtual void setGainPrecision(GainMath::Precision precision) noexcept = 0;
+    virtual void setControlInterval(int samples) noexcept = 0;
+
+    // Designs this layout's linear-phase band kernels; safe to call from any thread
+    virtual std::unique_ptr<LinearPhaseKernels> buildLinearPhaseKernels(double sampleRate) const = 0;
+
+    // Hands kernels from buildLinearPhaseKernels() (same sample rate as prepare())
+    // to the linear-phase crossover. The caller keeps them alive; nullptr drops them.
+    virtual void setLinearPhaseKernels(const LinearPhaseKernels* kernels) noexcept = 0;
+    virtual bool hasLinearPhaseKernels() const noexcept = 0;
+
+    virtual bool isDoublePrecision() const noexcept = 0;
+
+    // RMS of a band's output over the last block, by parameter slot (0 if unused)
+    float getBandLevel(int slot) const noexcept { return bandLevels[slot]; }
+
+    // Compressor gain in dB at the end of the last block, by parameter slot,
+    // without makeup: negative for downward, positive for upward compression.
+    // Of several channels, the one furthest from 0 dB.
+    float getBandGainDb(int slot) const noexcept { return bandGainDb[slot]; }
+
+protected:
+    float bandLevels[ParameterSnapshot::numBandSlots] = {};
+    float bandGainDb[ParameterSnapshot::numBandSlots] = {};
+};
+
+// The processing half of the interface, for float or double buffers
+template <typename SampleType>
+class TypedBandEngine : public BandEngineBase
+{
+public:
+    bool isDoublePrecision() const noexcept override { return std::is_same_v<SampleType, double>; }
+
+    // Splits the first getNumChannels() channels of buffer into bands, compresses
+    // them, applies each band's width and sums them back in place (only soloed
+    // bands if any band is soloed). At most maxBlockSize samples per call.
+    // With "linkedDetection" on, each band has one detector for all channels.
+    // With "lookahead", the bands (and dry) are delayed by lookaheadSamples while
+    // the detectors read them undelayed, through a running peak over that span.
+    // dry receives the uncompressed band sum: the input with the crossover's
+    // phase response (or delay, for the linear-phase crossover), so the depth mix
+    // doesn't comb-filter.
+    // workers (offline only) spreads the band/channel lanes over a thread pool;
+    // the output is identical to the serial path, which nullptr selects.
+    virtual void process(juce::AudioBuffer<SampleType>& buffer, juce::AudioBuffer<SampleType>& dry,
+                         const ParameterSnapshot& parameters, WorkStealingPool* workers = nullptr) noexcept = 0;
+};
+
+// Crossover, compressor and width stage for a fixed number of bands and channels.
+//
+// Band signals live in one buffer, band-major (channel band * NumChannels + ch),
+// which is also the lane order of the compressor kernel. The crossover (IIR or
+// linear-phase, per "crossoverMode") fills it in a single pass over the input.
+// Every per-band step is expanded at compile time, so there is no loop or branch
+// over bands at runtime.
+//
+// SampleType is the host's precision. A double engine runs the IIR crossover,
+// envelopes, gain computer and width in double; parameter ramps stay float.
+template <int NumBands, int NumChannels, typename SampleType = float>
+class BandEngine final : public TypedBandEngine<SampleType>
+{
+public:
+    static_assert(NumBands >= 2 && NumChannels >= 1, "need at least two bands and one channel");
+
+    using Layout = BandLayout<NumBands>;
+    static constexpr int numLanes = NumBands * NumChannels;
+
+    BandEngine() = default;
+
+    int getNumBands() const noexcept override { return NumBands; }
+    int getNumChannels() const noexcept override { return NumChannels; }
+
+    void prepare(double sampleRate, int maxBlockSize) override
+    {
+        crossover.prepare(sampleRate, Layout::crossovers);
+        linearPhaseCrossover.prepare(sampleRate);
+
+        bandBuffer.setSize(numLanes, juce::jmax(1, maxBlockSize));
+
+        if constexpr (NumChannels > 1)
+            detectorBuffer.setSize(NumBands, juce::jmax(1, maxBlockSize));
+
+        const int maxLookahead = ParameterSnapshot::lookaheadToSamples(ParameterSnapshot::maxLookaheadMs, sampleRate);
+        const int lookaheadFade = juce::roundToInt(ParameterSnapshot::rampSeconds * sampleRate);
+        laneDelay.prepare(maxLookahead, lookaheadFade);
+        dryDelay.prepare(maxLookahead, lookaheadFade);
+        lanePeaks.prepare(maxLookahead);
+        detectorPeaks.prepare(maxLookahead);
+        peakBuffer.setSize(numLanes, juce::jmax(1, maxBlockSize));
+
+        reset();
+    }
+
+    void reset() noexcept override
+    {
+        crossover.reset();
+        linearPhaseCrossover.reset();
+        compressor.reset();
+        linkedCompressor.reset();
+        resetLookahead();
+        std::fill(std::begin(bandLevels), std::end(bandLevels), 0.0f);
+    }
+
+    void setCompressorMode(CompressorKernelBase::Mode mode) noexcept override
+    {
+        compressor.setMode(mode);
+        linkedCompressor.setMode(mode);
+    }
+
+    void setGainPrecision(GainMath::Precision precision) noexcept override
+    {
+        compressor.setPrecision(precision);
+        linkedCompressor.setPrecision(precision);
+    }
+
+    void setControlInterval(int samples) noexcept override
+    {
+        compressor.setControlInterval(samples);
+        linkedCompressor.setControlInterval(samples);
+    }
+
+    std::unique_ptr<LinearPhaseKernels> buildLinearPhaseKernels(double sampleRate) const override
+    {
+        return LinearPhaseKernels::build(sampleRate, Layout::crossovers, NumBands);
+    }
+
+    void setLinearPhaseKernels(const LinearPhaseKernels* kernels) noexcept override { linearPhaseCrossover.setKernels(kernels); }
+    bool hasLinearPhaseKernels() const noexcept override { return linearPhaseCrossover.hasKernels(); }
+
+    void process(juce::AudioBuffer<SampleType>& buffer, juce::AudioBuffer<SampleType>& dry,
+                 const ParameterSnapshot& parameters, WorkStealingPool* workers = nullptr) noexcept override
+    {
+        jassert(buffer.getNumChannels() >= NumChannels && dry.getNumChannels() >= NumChannels);
+        jassert(dry.getNumSamples() >= buffer.getNumSamples());
+        jassert(buffer.getNumSamples() <= bandBuffer.getNumSamples());
+
+        const int numSamples = buffer.getNumSamples();
+        SampleType* const* lanes = bandBuffer.getArrayOfWritePointers();
+
+        // A newly selected crossover starts from cleared state
+        const bool linearPhase = parameters.getGlobal().linearPhase;
+        if (linearPhase != linearPhaseActive)
+        {
+            if (linearPhase)
+                linearPhaseCrossover.reset();
+            else
+                crossover.reset();
+
+            linearPhaseActive = linearPhase;
+        }
+
+        if (linearPhase)
+            linearPhaseCrossover.process(buffer.getArrayOfReadPointers(), lanes, dry.getArrayOfWritePointers(), numSamples, workers);
+        else
+            crossover.process(buffer.getArrayOfReadPointers(), lanes, dry.getArrayOfWritePointers(), numSamples);
+
+        // The delay lines always run, so a new lookahead, including switching it
+        // on or off, crossfades between their old and new read positions (the same
+        // fade on lanes and dry keeps them aligned). The running peaks only run
+        // with lookahead on and start over when it is switched on.
+        const int lookahead = juce::jmin(parameters.getGlobal().lookaheadSamples, laneDelay.getMaxDelay());
+        if (lookahead > 0 && activeLookahead == 0)
+        {
+            lanePeaks.reset();
+            detectorPeaks.reset();
+        }
+
+        activeLookahead = lookahead;
+        dryDelay.process(dry.getArrayOfWritePointers(), numSamples, lookahead);
+
+        forEachBand([&](auto band)
+        {
+            constexpr int b = decltype(band)::value;
+
+            const auto& p = parameters.getBand(Layout::slots[b]);
+            const auto lane = getLaneParameters(p);
+            const auto ramps = getLaneRamps(parameters, Layout::slots[b]);
+
+            for (int ch = 0; ch < NumChannels; ++ch)
+            {
+                compressor.setLaneParameters(b * NumChannels + ch, lane);
+                compressor.setLaneRamps(b * NumChannels + ch, ramps);
+
+                if constexpr (std::is_same_v<SampleType, double>)
+                    compressor.setLaneCoefficients(b * NumChannels + ch, p.preciseAttackCoeff, p.preciseReleaseCoeff);
+            }
+
+            linkedCompressor.setLaneParameters(b, lane);
+            linkedCompressor.setLaneRamps(b, ramps);
+
+            if constexpr (std::is_same_v<SampleType, double>)
+                linkedCompressor.setLaneCoefficients(b, p.preciseAttackCoeff, p.preciseReleaseCoeff);
+        });
+
+        // A newly selected detector starts from cleared envelopes
+        const bool linked = NumChannels > 1 && parameters.getGlobal().linkedDetection;
+        if (linked != linkedActive)
+        {
+            if (linked)
+            {
+                linkedCompressor.reset();
+                detectorPeaks.reset();
+            }
+            else
+            {
+                compressor.reset();
+                lanePeaks.reset();
+            }
+
+            linkedActive = linked;
+        }
+
+        if (linked)
+        {
+            compressLinked(lanes, numSamples, lookahead, workers);
+        }
+        else if (laneDelay.isDelaying(lookahead))
+        {
+            compressAhead(lanes, numSamples, lookahead, workers);
+        }
+        else
+        {
+            laneDelay.process(lanes, numSamples, 0); // only records the lanes
+            compressor.process(lanes, numSamples, workers); // every band/channel envelope is a lane, run in lock-step
+        }
+
+        bool anySolo = false;
+        forEachBand([&](auto band)
+        {
+            constexpr int b = decltype(band)::value;
+            const auto& p = parameters.getBand(Layout::slots[b]);
+
+            if constexpr (NumChannels == 2)
+            {
+                if (const float* widthRamp = parameters.getRamp(Layout::slots[b], ParameterSnapshot::widthRamp))
+                    applyStereoWidth(lanes[b * 2], lanes[b * 2 + 1], widthRamp, numSamples);
+                else
+                    applyStereoWidth(lanes[b * 2], lanes[b * 2 + 1], p.width, numSamples);
+            }
+
+            float level = 0.0f;
+            for (int ch = 0; ch < NumChannels; ++ch)
+                level = juce::jmax(level, (float)bandBuffer.getRMSLevel(b * NumChannels + ch, 0, numSamples));
+
+            bandLevels[Layout::slots[b]] = level;
+            bandGainDb[Layout::slots[b]] = measureGainDb(b, getLaneParameters(p), linked);
+            anySolo = anySolo || p.solo;
+        });
+
+        // Sum the bands, each weighted 1 or 0 for solo, in one pass per channel
+        SampleType bandMix[NumBands];
+        forEachBand([&](auto band)
+        {
+            constexpr int b = decltype(band)::value;
+            bandMix[b] = (! anySolo || parameters.getBand(Layout::slots[b]).solo) ? (SampleType)1 : (SampleType)0;
+        });
+
+        for (int ch = 0; ch < NumChannels; ++ch)
+        {
+            const SampleType* bandData[NumBands];
+            for (int b = 0; b < NumBands; ++b)
+                bandData[b] = lanes[b * NumChannels + ch];
+
+            auto* output = buffer.getWritePointer(ch);
+
+            for (int i = 0; i < numSamples; ++i)
+            {
+                SampleType sum = 0;
+                for (int b = 0; b < NumBands; ++b)
+                    sum += bandData[b][i] * bandMix[b];
+
+                output[i] = sum;
+            }
+        }
+    }
+
+private:
+    using BandEngineBase::bandLevels;
+    using BandEngineBase::bandGainDb;
+
+    LinkwitzRileyCrossover<NumBands, NumChannels, SampleType> crossover;
+    LinearPhaseCrossover<NumBands, NumChannels, SampleType> linearPhaseCrossover;
+    bool linearPhaseActive = false;
+
+    // Band signals, band-major; sized in prepare() and never resized on the audio thread
+    juce::AudioBuffer<SampleType> bandBuffer;
+
+    CompressorKernel<numLanes, SampleType> compressor;
+
+    // Linked detection: one lane per band, fed the loudest channel
+    CompressorKernel<NumBands, SampleType> linkedCompressor;
+    juce::AudioBuffer<SampleType> detectorBuffer;
+    bool linkedActive = false;
+
+    // Lookahead: delays for the band lanes and the dry channels, and running
+    // peaks of the undelayed lanes (per lane, or per band when linked)
+    LookaheadDelay<numLanes, SampleType> laneDelay;
+    LookaheadDelay<NumChannels, SampleType> dryDelay;
+    SlidingMaximum<numLanes, SampleType> lanePeaks;
+    SlidingMaximum<NumBands, SampleType> detectorPeaks;
+    juce::AudioBuffer<SampleType> peakBuffer;
+    int activeLookahead = 0;
+
+    void resetLookahead() noexcept
+    {
+        laneDelay.reset();
+        dryDelay.reset();
+        lanePeaks.reset();
+        detectorPeaks.reset();
+    }
+
+    // Calls function(std::integral_constant<int, band>) for every band, in order
+    template <typename Function>
+    static void forEachBand(Function&& function)
+    {
+        [&]<int... Bands>(std::integer_sequence<int, Bands...>)
+        {
+            (function(std::integral_constant<int, Bands>()), ...);
+        }(std::make_integer_sequence<int, NumBands>());
+    }
+
+    static CompressorKernelBase::LaneParameters getLaneParameters(const ParameterSnapshot::Band& p) noexcept
+    {
+        return { p.attackCoeff, p.releaseCoeff, p.threshDownDb, p.slopeDown, p.threshUpDb, p.slopeUp, p.gain };
+    }
+
+    static CompressorKernelBase::LaneRamps getLaneRamps(const ParameterSnapshot& parameters, int slot) noexcept
+    {
+        return { parameters.getRamp(slot, ParameterSnapshot::threshDownRamp),
+                 parameters.getRamp(slot, ParameterSnapshot::slopeDownRamp),
+                 parameters.getRamp(slot, ParameterSnapshot::threshUpRamp),
+                 parameters.getRamp(slot, ParameterSnapshot::slopeUpRamp),
+                 parameters.getRamp(slot, ParameterSnapshot::gainRamp) };
+    }
+
+    // Static gain of a band's settled envelopes; a few log/exp per block
+    float measureGainDb(int band, const CompressorKernelBase::LaneParameters& lane, bool linked) const noexcept
+    {
+        const auto precision = compressor.getPrecision();
+
+        auto gainDb = [&](float envelopeValue)
+        {
+            return juce::Decibels::gainToDecibels(CompressorKernelBase::computeGain(envelopeValue, lane, precision), -100.0f);
+        };
+
+        if (linked)
+            return gainDb((float)linkedCompressor.getEnvelope(band));
+
+        float result = 0.0f;
+        for (int ch = 0; ch < NumChannels; ++ch)
+        {
+            const float db = gainDb((float)compressor.getEnvelope(band * NumChannels + ch));
+            if (std::abs(db) > std::abs(result))
+                result = db;
+        }
+
+        return result;
+    }
+
+    // Lookahead without linking: each lane's detector reads the lane's running
+    // peak over the next lookahead samples, and its gain goes onto the delayed lane.
+    // Also runs at no lookahead while the delay fades out.
+    void compressAhead(SampleType* const* lanes, int numSamples, int lookahead, WorkStealingPool* workers) noexcept
+    {
+        SampleType* const* peaks = peakBuffer.getArrayOfWritePointers();
+
+        lanePeaks.process(lanes, peaks, numSamples, lookahead);
+        laneDelay.process(lanes, numSamples, lookahead);
+        compressor.computeGains(peaks, numSamples, workers);
+
+        for (int lane = 0; lane < numLanes; ++lane)
+            juce::FloatVectorOperations::multiply(lanes[lane], peaks[lane], numSamples);
+    }
+
+    // Runs one detector per band on the channels' peak and applies its gain to
+    // every channel of the band; with lookahead, the detector reads the running
+    // peak and the lanes are delayed
+    void compressLinked(SampleType* const* lanes, int numSamples, int lookahead, WorkStealingPool* workers) noexcept
+    {
+        SampleType* const* detectors = detectorBuffer.getArrayOfWritePointers();
+
+        for (int b = 0; b < NumBands; ++b)
+        {
+            SampleType* detector = detectors[b];
+
+            for (int i = 0; i < numSamples; ++i)
+                detector[i] = std::abs(lanes[b * NumChannels][i]);
+
+            for (int ch = 1; ch < NumChannels; ++ch)
+            {
+                const SampleType* lane = lanes[b * NumChannels + ch];
+
+                for (int i = 0; i < numSamples; ++i)
+                    detector[i] = juce::jmax(detector[i], std::abs(lane[i]));
+            }
+        }
+
+        if (lookahead > 0)
+            detectorPeaks.process(detectors, detectors, numSamples, lookahead);
+
+        laneDelay.process(lanes, numSamples, lookahead);
+
+        linkedCompressor.computeGains(detectors, numSamples, workers);
+
+        for (int b = 0; b < NumBands; ++b)
+        {
+            for (int ch = 0; ch < NumChannels; ++ch)
+            {
+                SampleType* lane = lanes[b * NumChannels + ch];
+
+                for (int i = 0; i < numSamples; ++i)
+                    lane[i] *= detectors[b][i];
+            }
+        }
+    }
+
+    // Mid-Side width; width is the side gain (0-2)
+    static void applyStereoWidth(SampleType* left, SampleType* right, float width, int numSamples) noexcept
+    {
+        const SampleType half = (SampleType)0.5, sideGain = (SampleType)width;
+
+        for (int i = 0; i < numSamples; ++i)
+        {
+            const SampleType mid = (left[i] + right[i]) * half;
+            const SampleType side = (left[i] - right[i]) * half * sideGain;
+
+            left[i] = mid + side;
+            right[i] = mid - side;
+        }
+    }
+
+    // Same, with the width ramping per sample
+    static void applyStereoWidth(SampleType* left, SampleType* right, const float* width, int numSamples) noexcept
+    {
+        const SampleType half = (SampleType)0.5;
+
+        for (int i = 0; i < numSamples; ++i)
+        {
+            const SampleType mid = (left[i] + right[i]) * half;
+            const SampleType side = (left[i] - right[i]) * half * (SampleType)width[i];
+
+            left[i] = mid + side;
+            right[i] = mid - side;
+        }
+    }
+
+    JUCE_DECLARE_NON_COPYABLE(BandEngine)
+};
+
+// Creates the engine for a band count (3-5) and channel count (1 or 2), as a
+// TypedBandEngine<double> if doublePrecision, else a TypedBandEngine<float>
+std::unique_ptr<BandEngineBase> createBandEngine(int numBands, int numChannels, bool doublePrecision = false);
@@ -0,0 +1,158 @@
+#include "BinaryState.h"
+
+namespace
+{
+    void writeUint32(char* destination, juce::uint32 value) noexcept
+    {
+        value = juce::ByteOrder::swapIfBigEndian(value);
+        std::memcpy(destination, &value, sizeof(value));
+    }
+
+    void writeUint16(char* destination, juce::uint16 value) noexcept
+    {
+        value = juce::ByteOrder::swapIfBigEndian(value);
+        std::memcpy(destination, &value, sizeof(value));
+    }
+
+    float readFloat(const char* source) noexcept
+    {
+        const juce::uint32 bits = juce::ByteOrder::littleEndianInt(source);
+        float value;
+        std::memcpy(&value, &bits, sizeof(value));
+        return value;
+    }
+}
+
+BinaryState::BinaryState(juce::AudioProcessor& processor)
+{
+    juce::MemoryOutputStream table(idTable, false);
+
+    for (auto* parameter : processor.getParameters())
+    {
+        if (auto* ranged = dynamic_cast<juce::RangedAudioParameter*>(parameter))
+        {
+            parameters.add(ranged);
+            table.write(ranged->paramID.toRawUTF8(), ranged->paramID.getNumBytesAsUTF8() + 1);
+        }
+    }
+}
+
+bool BinaryState::isBinaryState(const void* data, int sizeInBytes) noexcept
+{
+    return data != nullptr && sizeInBytes >= 4 && juce::ByteOrder::littleEndianInt(data) == magic;
+}
+
+size_t BinaryState::getSize(const void* data, int sizeInBytes) noexcept
+{
+    if (! isBinaryState(data, sizeInBytes) || sizeInBytes < headerSize)
+        return 0;
+
+    const auto* bytes = static_cast<const char*>(data);
+    const auto size = (juce::uint64)headerSize + juce::ByteOrder::littleEndianInt(bytes + 12)
+                    + sizeof(float) * (juce::uint64)juce::ByteOrder::littleEndianInt(bytes + 8);
+
+    return size <= (juce::uint64)sizeInBytes ? (size_t)size : 0;
+}
+
+void BinaryState::write(juce::MemoryBlock& destination) const
+{
+    const auto tableSize = idTable.getSize();
+    destination.setSize((size_t)headerSize + tableSize + sizeof(float) * (size_t)parameters.size(), false);
+    auto* bytes = static_cast<char*>(destination.getData());
+
+    writeUint32(bytes, magic);
+    writeUint16(bytes + 4, formatVersion);
+    writeUint16(bytes + 6, 0);
+    writeUint32(bytes + 8, (juce::uint32)parameters.size());
+    writeUint32(bytes + 12, (juce::uint32)tableSize);
+    std::memcpy(bytes + headerSize, idTable.getData(), tableSize);
+
+    auto* values = bytes + headerSize + tableSize;
+    for (int i = 0; i < parameters.size(); ++i)
+    {
+        const float value = parameters[i]->convertFrom0to1(parameters[i]->getValue());
+        juce::uint32 bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        writeUint32(values + sizeof(float) * (size_t)i, bits);
+    }
+}
+
+bool BinaryState::read(const void* data, int sizeInBytes) const
+{
+    if (! isBinaryState(data, sizeInBytes) || sizeInBytes < headerSize)
+        return false;
+
+    const auto* bytes = static_cast<const char*>(data);
+    const auto version = juce::ByteOrder::littleEndianShort(bytes + 4);
+    const auto count = juce::ByteOrder::littleEndianInt(bytes + 8);
+    const auto tableSize = juce::ByteOrder::littleEndianInt(bytes + 12);
+
+    // Later versions may add to the format, but not change what version 1 holds
+    if (version < 1 || (juce::uint64)headerSize + tableSize + sizeof(float) * (juce::uint64)count > (juce::uint64)sizeInBytes)
+        return false;
+
+    const char* table = bytes + headerSize;
+    const char* values = table + tableSize;
+
+    // Written by this parameter layout: one comparison, then values by index
+    if (count == (juce::uint32)parameters.size() && tableSize == idTable.getSize()
+        && std::memcmp(table, idTable.getData(), tableSize) == 0)
+    {
+        for (int i = 0; i < parameters.size(); ++i)
+            setValue(*parameters[i], readFloat(values + sizeof(float) * (size_t)i));
+
+        return true;
+    }
+
+    // Another layout. The table must hold exactly count IDs, or nothing changes.
+    juce::uint32 numIds = 0;
+    for (const char* id = table; id < values; ++numIds)
+    {
+        const auto* end = static_cast<const char*>(std::memchr(id, 0, (size_t)(values - id)));
+        if (end == nullptr)
+            return false;
+
+        id = end + 1;
+    }
+
+    if (numIds != count)
+        return false;
+
+    for (auto* parameter : parameters)
+    {
+        const int index = findId(table, tableSize, parameter->paramID);
+        setValue(*parameter, index >= 0 ? readFloat(values + sizeof(float) * (size_t)index)
+                                        : parameter->convertFrom0to1(parameter->getDefaultValue()));
+    }
+
+    return true;
+}
+
+int BinaryState::findId(const char* table, size_t tableSize, const juce::String& id) noexcept
+{
+    const char* wanted = id.toRawUTF8();
+    const size_t length = id.getNumBytesAsUTF8();
+    int index = 0;
+
+    for (size_t position = 0; position < tableSize; ++index)
+    {
+        const char* candidate = table + position;
+        const size_t candidateLength = std::strlen(candidate);
+
+        if (candidateLength == length && std::memcmp(candidate, wanted, length) == 0)
+            return index;
+
+        position += candidateLength + 1;
+    }
+
+    return -1;
+}
+
+void BinaryState::setValue(juce::RangedAudioParameter& parameter, float value)
+{
+    // A damaged value falls back to the default; a changed range clamps
+    const float normalised = std::isfinite(value) ? parameter.convertTo0to1(value) : parameter.getDefaultValue();
+
+    if (parameter.getValue() != normalised)
+        parameter.setValueNotifyingHost(normalised);
+}
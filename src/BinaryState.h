@@ -0,0 +1,60 @@
+#pragma once
+#include <juce_audio_processors/juce_audio_processors.h>
+
+// Compact, versioned session state: every parameter's value, in a fixed order,
+// after the table of their IDs.
+//
+//   uint32  magic "MIHS"
+//   uint16  format version
+//   uint16  reserved, 0
+//   uint32  parameter count
+//   uint32  ID table size in bytes
+//   char    ID table: each parameter ID followed by a 0 byte
+//   float32 values, in ID table order, in the parameters' own units
+//
+// Whatever follows the values is not part of the state; the processor stores its
+// preset bank there.
+//
+// All integers and floats are little-endian. The processor's own ID table is
+// built once. A state written by the same parameter layout carries exactly that
+// table, so restoring compares the tables once and then assigns the values by
+// index, without parsing or allocating. A state from another layout (an older
+// version with fewer parameters, say) is matched ID by ID instead; parameters it
+// doesn't mention return to their defaults, as with the XML state.
+class BinaryState
+{
+public:
+    static constexpr juce::uint32 magic = 0x5348494d; // "MIHS", little-endian
+    static constexpr juce::uint16 formatVersion = 1;
+
+    // Collects the processor's parameters in getParameters() order; call once
+    // every parameter has been added
+    explicit BinaryState(juce::AudioProcessor& processor);
+
+    // Replaces destination's contents with the current parameter values
+    void write(juce::MemoryBlock& destination) const;
+
+    // Restores the parameter values; returns false, changing nothing, if data is
+    // not a complete binary state
+    bool read(const void* data, int sizeInBytes) const;
+
+    // True if data starts with the binary state's magic
+    static bool isBinaryState(const void* data, int sizeInBytes) noexcept;
+
+    // Bytes the binary state at the start of data takes up, so callers can store
+    // more after it; 0 if it is incomplete
+    static size_t getSize(const void* data, int sizeInBytes) noexcept;
+
+private:
+    static constexpr int headerSize = 16;
+
+    juce::Array<juce::RangedAudioParameter*> parameters;
+    juce::MemoryBlock idTable;
+
+    // Index of id in a state's ID table of tableSize bytes; -1 if it isn't there
+    static int findId(const char* table, size_t tableSize, const juce::String& id) noexcept;
+
+    static void setValue(juce::RangedAudioParameter& parameter, float value);
+
+    JUCE_DECLARE_NON_COPYABLE(BinaryState)
+};
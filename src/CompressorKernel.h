@@ -0,0 +1,632 @@
+#pragma once
+#include <juce_dsp/juce_dsp.h>
+#include "GainMath.h"
+#include "WorkStealingPool.h"
+
+// Envelope follower + upward/downward gain computer for a set of independent
+// "lanes" (one lane per band and channel), run in lock-step.
+//
+// The lane count is a template argument, so every loop over lanes and SIMD
+// registers has a compile-time trip count. CompressorKernelBase holds the parts
+// that don't depend on it.
+//
+// processVector() packs the lanes into juce::dsp::SIMDRegister<float>s;
+// processScalar() runs the same arithmetic one lane at a time, in the same order,
+// so both paths produce bit-identical output. The mode can be switched at runtime,
+// which is also how the vector path is checked against the scalar one.
+//
+// The gain computer works in log2 units (see GainMath.h). Its log/exp can use
+// either libm or the fast polynomials; the choice is made once per block, so each
+// combination is its own loop with no per-sample branching.
+//
+// Lanes are processed in blocks of one SIMD register, each with its own scratch.
+// Blocks are independent, so offline processing can spread them over a
+// WorkStealingPool without changing the result.
+//
+// While a lane's thresholds, slopes or makeup ramp (see ParameterSnapshot), the
+// caller hands per-sample arrays with setLaneRamps(). Only lane blocks with a
+// ramp take the slower path that reads them; the others run as before.
+//
+// With a control interval above 1, the envelope still runs per sample but the
+// log2/curve/exp2 gain computer runs once per sub-block of that many samples, on
+// the sub-block's loudest envelope value (and the parameters at its last
+// sample). The gain moves linearly from the previous sub-block's value to the
+// new one across the sub-block. Sub-blocks start at each process() call, so host
+// blocks that are a multiple of the interval give the same output at any size.
+//
+// The sample type is a template argument too: a double kernel keeps its envelopes,
+// coefficients and gain computer in double (with SIMDRegister<double>, half as
+// many lanes per register), for hosts that process in double. Parameters still
+// arrive as floats, except the envelope coefficients (setLaneCoefficients()),
+// which need the extra precision at long time constants.
+class CompressorKernelBase
+{
+public:
+    // Largest setControlInterval(); divides chunkSize
+    static constexpr int maxControlInterval = 32;
+
+    enum class Mode
+    {
+        vector,
+        scalar
+    };
+
+    // Precomputed per-lane values (see ParameterSnapshot)
+    struct LaneParameters
+    {
+        float attackCoeff = 0.0f;
+        float releaseCoeff = 0.0f;
+        float threshDownDb = -20.0f;
+        float slopeDown = 0.0f;    // 1 - 1/ratioDown
+        float threshUpDb = -40.0f;
+        float slopeUp = 0.0f;      // 1 - 1/ratioUp
+        float makeupGain = 1.0f;
+    };
+
+    // Per-sample values for the block passed to process(), for lanes whose
+    // parameters are ramping; nullptr where the LaneParameters value holds for the
+    // whole block. Thresholds are in dB, like LaneParameters.
+    struct LaneRamps
+    {
+        const float* threshDownDb = nullptr;
+        const float* slopeDown = nullptr;
+        const float* threshUpDb = nullptr;
+        const float* slopeUp = nullptr;
+        const float* makeupGain = nullptr;
+
+        bool isStatic() const noexcept
+        {
+            return threshDownDb == nullptr && slopeDown == nullptr && threshUpDb == nullptr
+                && slopeUp == nullptr && makeupGain == nullptr;
+        }
+    };
+
+    // Static gain for a settled envelope value, using exactly the per-sample
+    // arithmetic of process(). Used to validate the fast math against the reference.
+    static float computeGain(float envelopeValue, const LaneParameters& p, GainMath::Precision math) noexcept
+    {
+        const float thrDown = GainMath::decibelsToLog2(p.threshDownDb);
+        const float thrUp = GainMath::decibelsToLog2(p.threshUpDb);
+
+        return math == GainMath::Precision::fast
+                 ? gainFromEnvelope<GainMath::Fast>(envelopeValue, thrDown, p.slopeDown, thrUp, p.slopeUp)
+                 : gainFromEnvelope<GainMath::Precise>(envelopeValue, thrDown, p.slopeDown, thrUp, p.slopeUp);
+    }
+
+protected:
+    static constexpr float envelopeFloor = 0.00001f;
+
+    // Samples per pass; the SIMD path interleaves up to 8 lanes per chunk
+    static constexpr int chunkSize = 64;
+    static constexpr int maxRegisterWidth = 8;
+
+    // Ramped curve parameters, in the order of the per-block ramp scratch
+    enum RampedParameter
+    {
+        rampedThreshDown, // log2 units
+        rampedSlopeDown,
+        rampedThreshUp,   // log2 units
+        rampedSlopeUp,
+        rampedMakeup,
+        numRampedParameters
+    };
+
+    // Writes n values, stride apart, from ramp[start...] (converted from dB to
+    // log2 units if toLog2) or, without a ramp, copies of value
+    template <typename SampleType>
+    static void fillRamped(SampleType* destination, int stride, const float* ramp, int start, int n,
+                           SampleType value, bool toLog2) noexcept
+    {
+        if (ramp == nullptr)
+        {
+            for (int i = 0; i < n; ++i)
+                destination[i * stride] = value;
+        }
+        else if (toLog2)
+        {
+            for (int i = 0; i < n; ++i)
+                destination[i * stride] = GainMath::decibelsToLog2(ramp[start + i]);
+        }
+        else
+        {
+            for (int i = 0; i < n; ++i)
+                destination[i * stride] = ramp[start + i];
+        }
+    }
+
+    template <typename Math>
+    static float gainFromEnvelope(float env, float thrDown, float sloDown, float thrUp, float sloUp) noexcept
+    {
+        const float level = Math::log2(env + envelopeFloor);
+        const float boost = juce::jmax(thrUp - level, 0.0f) * sloUp;
+        const float cut = juce::jmax(level - thrDown, 0.0f) * sloDown;
+        return Math::exp2(boost - cut);
+    }
+};
+
+template <int NumLanes, typename SampleType = float>
+class CompressorKernel : public CompressorKernelBase
+{
+public:
+    static_assert(NumLanes > 0, "a kernel needs at least one lane");
+
+    static constexpr int numLanes = NumLanes;
+
+    // Lane arrays are padded to a whole number of (up to 8-wide) registers
+    static constexpr int paddedLanes = (NumLanes + maxRegisterWidth - 1) / maxRegisterWidth * maxRegisterWidth;
+
+    // Lanes per independent block: one register, or one lane without SIMD
+#if JUCE_USE_SIMD
+    static constexpr int laneBlockWidth = (int)juce::dsp::SIMDRegister<SampleType>::SIMDNumElements;
+#else
+    static constexpr int laneBlockWidth = 1;
+#endif
+    static constexpr int numLaneBlocks = (NumLanes + laneBlockWidth - 1) / laneBlockWidth;
+
+    CompressorKernel()
+    {
+#if ! JUCE_USE_SIMD
+        mode = Mode::scalar;
+#endif
+        reset();
+    }
+
+    void setPrecision(GainMath::Precision newPrecision) noexcept { precision = newPrecision; }
+    GainMath::Precision getPrecision() const noexcept { return precision; }
+
+    // Samples per gain computer update: 1 (every sample), 4, 8, 16 or 32
+    void setControlInterval(int samples) noexcept
+    {
+        jassert(samples >= 1 && samples <= maxControlInterval && juce::isPowerOfTwo(samples));
+        controlInterval = juce::jlimit(1, maxControlInterval, samples);
+    }
+
+    int getControlInterval() const noexcept { return controlInterval; }
+
+    void setMode(Mode newMode) noexcept
+    {
+#if JUCE_USE_SIMD
+        mode = newMode;
+#else
+        juce::ignoreUnused(newMode);
+#endif
+    }
+
+    Mode getMode() const noexcept { return mode; }
+
+    void reset() noexcept
+    {
+        std::fill(std::begin(envelope), std::end(envelope), (SampleType)0);
+        std::fill(std::begin(controlGain), std::end(controlGain), (SampleType)1);
+    }
+
+    // Envelope after the last processed sample, for metering
+    SampleType getEnvelope(int lane) const noexcept { return envelope[lane]; }
+
+    void setLaneParameters(int lane, const LaneParameters& p) noexcept
+    {
+        jassert(lane >= 0 && lane < NumLanes);
+
+        attackCoeff[lane] = p.attackCoeff;
+        releaseCoeff[lane] = p.releaseCoeff;
+        threshDown[lane] = GainMath::decibelsToLog2(p.threshDownDb);
+        slopeDown[lane] = p.slopeDown;
+        threshUp[lane] = GainMath::decibelsToLog2(p.threshUpDb);
+        slopeUp[lane] = p.slopeUp;
+        makeup[lane] = p.makeupGain;
+    }
+
+    // Overrides the envelope coefficients of the last setLaneParameters() call with
+    // values computed at this kernel's precision
+    void setLaneCoefficients(int lane, SampleType attack, SampleType release) noexcept
+    {
+        jassert(lane >= 0 && lane < NumLanes);
+
+        attackCoeff[lane] = attack;
+        releaseCoeff[lane] = release;
+    }
+
+    // Ramps for the next process() call; static lanes pass a default LaneRamps
+    void setLaneRamps(int lane, const LaneRamps& r) noexcept
+    {
+        jassert(lane >= 0 && lane < NumLanes);
+        ramps[lane] = r;
+    }
+
+    // Applies compression in place: laneData[lane][i] *= gain(lane, i) * makeup.
+    // With workers, the lane blocks run in parallel (offline only).
+    void process(SampleType* const* laneData, int numSamples, WorkStealingPool* workers = nullptr) noexcept
+    {
+        if (precision == GainMath::Precision::fast)
+            processBlocks<GainMath::Fast, true>(laneData, numSamples, workers);
+        else
+            processBlocks<GainMath::Precise, true>(laneData, numSamples, workers);
+    }
+
+    // Detector only: replaces laneData[lane][i] (a non-negative detector signal)
+    // with gain(lane, i) * makeup, for linked detection where one lane's gain is
+    // applied to several channels
+    void computeGains(SampleType* const* laneData, int numSamples, WorkStealingPool* workers = nullptr) noexcept
+    {
+        if (precision == GainMath::Precision::fast)
+            processBlocks<GainMath::Fast, false>(laneData, numSamples, workers);
+        else
+            processBlocks<GainMath::Precise, false>(laneData, numSamples, workers);
+    }
+
+private:
+    Mode mode = Mode::vector;
+    GainMath::Precision precision = GainMath::defaultPrecision;
+    int controlInterval = 1;
+
+    // Structure-of-arrays lane state, aligned for SIMDRegister loads.
+    // Thresholds are stored in log2 units.
+    alignas(32) SampleType envelope[paddedLanes];
+    alignas(32) SampleType attackCoeff[paddedLanes] = {};
+    alignas(32) SampleType releaseCoeff[paddedLanes] = {};
+    alignas(32) SampleType threshDown[paddedLanes] = {};
+    alignas(32) SampleType slopeDown[paddedLanes] = {};
+    alignas(32) SampleType threshUp[paddedLanes] = {};
+    alignas(32) SampleType slopeUp[paddedLanes] = {};
+    alignas(32) SampleType makeup[paddedLanes] = {};
+    LaneRamps ramps[NumLanes];
+
+    // Gain at the end of the last sub-block, with a control interval above 1
+    alignas(32) SampleType controlGain[paddedLanes];
+
+    // Per-chunk scratch for each lane block: lane-interleaved inputs and the
+    // log/gain work array
+    alignas(32) SampleType blockInterleaved[numLaneBlocks][chunkSize * laneBlockWidth] = {};
+    alignas(32) SampleType blockWork[numLaneBlocks][chunkSize * laneBlockWidth] = {};
+
+    // Per-chunk ramped parameters for each lane block, lane-interleaved like
+    // blockInterleaved; only written while one of the block's lanes ramps
+    alignas(32) SampleType blockRamps[numLaneBlocks][numRampedParameters][chunkSize * laneBlockWidth] = {};
+
+    // Fills a lane's ramped parameters for one chunk into destination[p][offset + i * stride]
+    void fillLaneRamps(int lane, SampleType (*destination)[chunkSize * laneBlockWidth], int offset, int stride,
+                       int start, int n) const noexcept
+    {
+        const auto& r = ramps[lane];
+        fillRamped(destination[rampedThreshDown] + offset, stride, r.threshDownDb, start, n, threshDown[lane], true);
+        fillRamped(destination[rampedSlopeDown] + offset, stride, r.slopeDown, start, n, slopeDown[lane], false);
+        fillRamped(destination[rampedThreshUp] + offset, stride, r.threshUpDb, start, n, threshUp[lane], true);
+        fillRamped(destination[rampedSlopeUp] + offset, stride, r.slopeUp, start, n, slopeUp[lane], false);
+        fillRamped(destination[rampedMakeup] + offset, stride, r.makeupGain, start, n, makeup[lane], false);
+    }
+
+    template <typename Math, bool ApplyGain>
+    void processBlocks(SampleType* const* laneData, int numSamples, WorkStealingPool* workers) noexcept
+    {
+        auto processLaneBlock = [&](int block)
+        {
+#if JUCE_USE_SIMD
+            if (mode == Mode::vector)
+            {
+                processVector<Math, ApplyGain>(block, laneData, numSamples);
+                return;
+            }
+#endif
+            processScalar<Math, ApplyGain>(block, laneData, numSamples);
+        };
+
+        if (workers != nullptr)
+        {
+            workers->parallelFor(numLaneBlocks, processLaneBlock);
+            return;
+        }
+
+        for (int block = 0; block < numLaneBlocks; ++block)
+            processLaneBlock(block);
+    }
+
+    // Each block is processed in chunks, as separate passes: envelope (serial in
+    // time), log2, gain curve, exp2, apply. Keeping the passes apart lets the
+    // log/exp loops run over contiguous arrays and avoids store-forwarding stalls
+    // between the SIMD registers and the per-lane gathers.
+    template <typename Math, bool ApplyGain>
+    void processScalar(int block, SampleType* const* laneData, int numSamples) noexcept
+    {
+        auto* work = blockWork[block];
+        const int endLane = juce::jmin(NumLanes, (block + 1) * laneBlockWidth);
+
+        auto* rampWork = blockRamps[block];
+
+        for (int lane = block * laneBlockWidth; lane < endLane; ++lane)
+        {
+            auto* data = laneData[lane];
+            SampleType env = envelope[lane];
+            const bool ramped = ! ramps[lane].isStatic();
+
+            for (int start = 0; start < numSamples; start += chunkSize)
+            {
+                const int n = juce::jmin(chunkSize, numSamples - start);
+                auto* input = data + start;
+
+                for (int i = 0; i < n; ++i)
+                {
+                    const SampleType level = juce::jmax(input[i], (SampleType)0 - input[i]);
+                    const SampleType coeff = level > env ? attackCoeff[lane] : releaseCoeff[lane];
+                    env = coeff * env + ((SampleType)1 - coeff) * level;
+                    work[i] = env + (SampleType)envelopeFloor;
+                }
+
+                if (ramped)
+                    fillLaneRamps(lane, rampWork, 0, 1, start, n);
+
+                if (controlInterval > 1)
+                {
+                    controlRateGains<Math>(lane, work, rampWork, ramped, n);
+                }
+                else
+                {
+                    for (int i = 0; i < n; ++i)
+                        work[i] = Math::log2(work[i]);
+
+                    if (ramped)
+                    {
+                        for (int i = 0; i < n; ++i)
+                        {
+                            const SampleType boost = juce::jmax(rampWork[rampedThreshUp][i] - work[i], (SampleType)0) * rampWork[rampedSlopeUp][i];
+                            const SampleType cut = juce::jmax(work[i] - rampWork[rampedThreshDown][i], (SampleType)0) * rampWork[rampedSlopeDown][i];
+                            work[i] = boost - cut;
+                        }
+                    }
+                    else
+                    {
+                        for (int i = 0; i < n; ++i)
+                        {
+                            const SampleType boost = juce::jmax(threshUp[lane] - work[i], (SampleType)0) * slopeUp[lane];
+                            const SampleType cut = juce::jmax(work[i] - threshDown[lane], (SampleType)0) * slopeDown[lane];
+                            work[i] = boost - cut;
+                        }
+                    }
+
+                    for (int i = 0; i < n; ++i)
+                        work[i] = Math::exp2(work[i]);
+                }
+
+                const SampleType* gainMakeup = rampWork[rampedMakeup];
+
+                if constexpr (ApplyGain)
+                {
+                    if (ramped)
+                        for (int i = 0; i < n; ++i)
+                            input[i] = input[i] * work[i] * gainMakeup[i];
+                    else
+                        for (int i = 0; i < n; ++i)
+                            input[i] = input[i] * work[i] * makeup[lane];
+                }
+                else
+                {
+                    if (ramped)
+                        for (int i = 0; i < n; ++i)
+                            input[i] = work[i] * gainMakeup[i];
+                    else
+                        for (int i = 0; i < n; ++i)
+                            input[i] = work[i] * makeup[lane];
+                }
+            }
+
+            envelope[lane] = env;
+        }
+    }
+
+    // Decimated gain computer for one lane's chunk of n samples: work holds
+    // envelope + floor on entry and the gain (without makeup) on exit
+    template <typename Math>
+    void controlRateGains(int lane, SampleType* work, const SampleType (*rampWork)[chunkSize * laneBlockWidth],
+                          bool ramped, int n) noexcept
+    {
+        SampleType previous = controlGain[lane];
+
+        for (int start = 0; start < n; start += controlInterval)
+        {
+            const int m = juce::jmin(controlInterval, n - start);
+            const int last = start + m - 1;
+
+            SampleType peak = work[start];
+            for (int i = 1; i < m; ++i)
+                peak = juce::jmax(peak, work[start + i]);
+
+            const SampleType level = Math::log2(peak);
+            const SampleType thrUp = ramped ? rampWork[rampedThreshUp][last] : threshUp[lane];
+            const SampleType sloUp = ramped ? rampWork[rampedSlopeUp][last] : slopeUp[lane];
+            const SampleType thrDown = ramped ? rampWork[rampedThreshDown][last] : threshDown[lane];
+            const SampleType sloDown = ramped ? rampWork[rampedSlopeDown][last] : slopeDown[lane];
+
+            const SampleType boost = juce::jmax(thrUp - level, (SampleType)0) * sloUp;
+            const SampleType cut = juce::jmax(level - thrDown, (SampleType)0) * sloDown;
+            const SampleType target = Math::exp2(boost - cut);
+
+            const SampleType step = (SampleType)1 / (SampleType)m;
+            for (int i = 0; i < m; ++i)
+                work[start + i] = previous + (target - previous) * ((SampleType)(i + 1) * step);
+
+            previous = target;
+        }
+
+        controlGain[lane] = previous;
+    }
+
+#if JUCE_USE_SIMD
+    template <typename Math, bool ApplyGain>
+    void processVector(int block, SampleType* const* laneData, int numSamples) noexcept
+    {
+        using Vec = juce::dsp::SIMDRegister<SampleType>;
+        constexpr int width = (int)Vec::SIMDNumElements;
+        static_assert(width <= maxRegisterWidth && paddedLanes % width == 0, "lane arrays must hold whole registers");
+        static_assert(width == laneBlockWidth, "a lane block is one register");
+
+        auto* interleaved = blockInterleaved[block];
+        auto* work = blockWork[block];
+        auto* rampWork = blockRamps[block];
+
+        const auto zero = Vec::expand((SampleType)0);
+        const auto one = Vec::expand((SampleType)1);
+        const auto floor = Vec::expand((SampleType)envelopeFloor);
+
+        const int first = block * width;
+        const int active = juce::jmin(width, NumLanes - first);
+
+        bool ramped = false;
+        for (int k = 0; k < active; ++k)
+            ramped = ramped || ! ramps[first + k].isStatic();
+
+        const auto attack = Vec::fromRawArray(attackCoeff + first);
+        const auto release = Vec::fromRawArray(releaseCoeff + first);
+        const auto thrDown = Vec::fromRawArray(threshDown + first);
+        const auto sloDown = Vec::fromRawArray(slopeDown + first);
+        const auto thrUp = Vec::fromRawArray(threshUp + first);
+        const auto sloUp = Vec::fromRawArray(slopeUp + first);
+        const auto gainMakeup = Vec::fromRawArray(makeup + first);
+        auto env = Vec::fromRawArray(envelope + first);
+
+        // Unused lanes of a partial register keep reading zeros
+        if (active < width)
+            std::fill(interleaved, interleaved + chunkSize * width, (SampleType)0);
+
+        for (int start = 0; start < numSamples; start += chunkSize)
+        {
+            const int n = juce::jmin(chunkSize, numSamples - start);
+
+            // Gather into [sample][lane] order
+            for (int k = 0; k < active; ++k)
+            {
+                const auto* input = laneData[first + k] + start;
+
+                for (int i = 0; i < n; ++i)
+                    interleaved[i * width + k] = input[i];
+            }
+
+            for (int i = 0; i < n; ++i)
+            {
+                const auto input = Vec::fromRawArray(interleaved + i * width);
+                const auto level = Vec::max(input, zero - input);
+
+                // Exact select (one side is always +0), so it rounds like the scalar ternary
+                const auto coeff = (attack & Vec::greaterThan(level, env))
+                                 + (release & Vec::greaterThanOrEqual(env, level));
+                env = coeff * env + (one - coeff) * level;
+                (env + floor).copyToRawArray(work + i * width);
+            }
+
+            // Static lanes fill in their constants, padding lanes stay zero
+            if (ramped)
+                for (int k = 0; k < active; ++k)
+                    fillLaneRamps(first + k, rampWork, k, width, start, n);
+
+            if (controlInterval > 1)
+            {
+                controlRateGainsVector<Math>(first, work, rampWork, ramped, n);
+            }
+            else
+            {
+                for (int i = 0; i < n * width; ++i)
+                    work[i] = Math::log2(work[i]);
+
+                if (ramped)
+                {
+                    for (int i = 0; i < n; ++i)
+                    {
+                        const auto envelopeLog2 = Vec::fromRawArray(work + i * width);
+                        const auto boost = Vec::max(Vec::fromRawArray(rampWork[rampedThreshUp] + i * width) - envelopeLog2, zero)
+                                         * Vec::fromRawArray(rampWork[rampedSlopeUp] + i * width);
+                        const auto cut = Vec::max(envelopeLog2 - Vec::fromRawArray(rampWork[rampedThreshDown] + i * width), zero)
+                                       * Vec::fromRawArray(rampWork[rampedSlopeDown] + i * width);
+                        (boost - cut).copyToRawArray(work + i * width);
+                    }
+                }
+                else
+                {
+                    for (int i = 0; i < n; ++i)
+                    {
+                        const auto envelopeLog2 = Vec::fromRawArray(work + i * width);
+                        const auto boost = Vec::max(thrUp - envelopeLog2, zero) * sloUp;
+                        const auto cut = Vec::max(envelopeLog2 - thrDown, zero) * sloDown;
+                        (boost - cut).copyToRawArray(work + i * width);
+                    }
+                }
+
+                for (int i = 0; i < n * width; ++i)
+                    work[i] = Math::exp2(work[i]);
+            }
+
+            for (int i = 0; i < n; ++i)
+            {
+                const auto gain = Vec::fromRawArray(work + i * width);
+                const auto laneMakeup = ramped ? Vec::fromRawArray(rampWork[rampedMakeup] + i * width) : gainMakeup;
+
+                if constexpr (ApplyGain)
+                    (Vec::fromRawArray(interleaved + i * width) * gain * laneMakeup).copyToRawArray(work + i * width);
+                else
+                    (gain * laneMakeup).copyToRawArray(work + i * width);
+            }
+
+            // Scatter back to the lanes
+            for (int k = 0; k < active; ++k)
+            {
+                auto* output = laneData[first + k] + start;
+
+                for (int i = 0; i < n; ++i)
+                    output[i] = work[i * width + k];
+            }
+        }
+
+        env.copyToRawArray(envelope + first);
+    }
+
+    // controlRateGains() for the register of lanes starting at first; work and
+    // rampWork are lane-interleaved
+    template <typename Math>
+    void controlRateGainsVector(int first, SampleType* work, const SampleType (*rampWork)[chunkSize * laneBlockWidth],
+                                bool ramped, int n) noexcept
+    {
+        using Vec = juce::dsp::SIMDRegister<SampleType>;
+        constexpr int width = (int)Vec::SIMDNumElements;
+
+        const auto zero = Vec::expand((SampleType)0);
+        auto previous = Vec::fromRawArray(controlGain + first);
+        alignas(32) SampleType control[maxRegisterWidth] = {};
+
+        for (int start = 0; start < n; start += controlInterval)
+        {
+            const int m = juce::jmin(controlInterval, n - start);
+            const int last = (start + m - 1) * width;
+
+            auto peak = Vec::fromRawArray(work + start * width);
+            for (int i = 1; i < m; ++i)
+                peak = Vec::max(peak, Vec::fromRawArray(work + (start + i) * width));
+
+            peak.copyToRawArray(control);
+            for (int k = 0; k < width; ++k)
+                control[k] = Math::log2(control[k]);
+
+            const auto level = Vec::fromRawArray(control);
+            const auto thrUp = Vec::fromRawArray(ramped ? rampWork[rampedThreshUp] + last : threshUp + first);
+            const auto sloUp = Vec::fromRawArray(ramped ? rampWork[rampedSlopeUp] + last : slopeUp + first);
+            const auto thrDown = Vec::fromRawArray(ramped ? rampWork[rampedThreshDown] + last : threshDown + first);
+            const auto sloDown = Vec::fromRawArray(ramped ? rampWork[rampedSlopeDown] + last : slopeDown + first);
+
+            const auto boost = Vec::max(thrUp - level, zero) * sloUp;
+            const auto cut = Vec::max(level - thrDown, zero) * sloDown;
+            (boost - cut).copyToRawArray(control);
+
+            for (int k = 0; k < width; ++k)
+                control[k] = Math::exp2(control[k]);
+
+            const auto target = Vec::fromRawArray(control);
+            const SampleType step = (SampleType)1 / (SampleType)m;
+
+            for (int i = 0; i < m; ++i)
+                (previous + (target - previous) * Vec::expand((SampleType)(i + 1) * step)).copyToRawArray(work + (start + i) * width);
+
+            previous = target;
+        }
+
+        previous.copyToRawArray(controlGain + first);
+    }
+#endif
+
+    JUCE_DECLARE_NON_COPYABLE(CompressorKernel)
+};
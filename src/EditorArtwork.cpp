@@ -0,0 +1,91 @@
+#include "EditorArtwork.h"
+
+#if MIH_EMBEDDED_ARTWORK
+ #include "EditorArtworkData.h"
+#endif
+
+namespace
+{
+    // An embedded PNG, decoded; invalid if this build doesn't have it
+    juce::Image decode(const char* resourceName)
+    {
+       #if MIH_EMBEDDED_ARTWORK
+        int size = 0;
+        if (const char* data = EditorArtworkData::getNamedResource(resourceName, size))
+            return juce::ImageFileFormat::loadFrom(data, (size_t)size);
+       #else
+        juce::ignoreUnused(resourceName);
+       #endif
+
+        return {};
+    }
+}
+
+EditorArtwork::EditorArtwork()
+    : juce::Thread("Editor artwork")
+{
+   #if MIH_EMBEDDED_ARTWORK
+    startThread(juce::Thread::Priority::low);
+   #else
+    ready = true;
+   #endif
+}
+
+EditorArtwork::~EditorArtwork()
+{
+    // run() checks before each decode and scale, so this waits for one at most
+    stopThread(5000);
+}
+
+juce::Image EditorArtwork::getBackground(float scale) const
+{
+    if (! isReady())
+        return {};
+
+    for (int i = 0; i < numScales; ++i)
+        if (juce::approximatelyEqual(scale, (float)(i + 1)) && scaledBackgrounds[i].isValid())
+            return scaledBackgrounds[i];
+
+    return background;
+}
+
+juce::Image EditorArtwork::getKnob() const
+{
+    return isReady() ? knob : juce::Image();
+}
+
+void EditorArtwork::run()
+{
+    // On exit the artwork is being destroyed, so it is never reported ready
+    background = decode("background_png");
+
+    for (int i = 0; i < numScales && background.isValid(); ++i)
+    {
+        if (threadShouldExit())
+            return;
+
+        scaledBackgrounds[i] = fillEditor(background, i + 1);
+    }
+
+    if (threadShouldExit())
+        return;
+
+    knob = decode("knob_png");
+
+    ready = true;
+    sendChangeMessage();
+}
+
+juce::Image EditorArtwork::fillEditor(const juce::Image& image, int scale)
+{
+    const juce::Rectangle<float> area(0.0f, 0.0f, (float)(editorWidth * scale), (float)(editorHeight * scale));
+    juce::Image scaled(juce::Image::RGB, editorWidth * scale, editorHeight * scale, false, juce::SoftwareImageType());
+
+    // Transparent parts show the plain background colour
+    juce::Graphics g(scaled);
+    g.fillAll(juce::Colour(0xff1a1a1a));
+    g.setImageResamplingQuality(juce::Graphics::highResamplingQuality);
+    g.drawImage(image, area, juce::RectanglePlacement::fillDestination);
+
+    return scaled;
+}
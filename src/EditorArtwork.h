@@ -0,0 +1,52 @@
+#pragma once
+#include <juce_gui_basics/juce_gui_basics.h>
+
+// The editor artwork, compiled into the binary (assets/background.png and
+// assets/knob.png, see ARTWORK_GUIDE.md) and decoded off the message thread.
+//
+// One instance is shared by every plugin instance (each processor holds it
+// through a juce::SharedResourcePointer from its first editor on, so closing
+// and reopening an editor doesn't decode again). Creating it starts a
+// background thread that decodes the PNGs and pre-scales the background to the
+// editor's size at 1x and 2x, so drawing it is a copy. Editors draw their vector look
+// until isReady() and then pick the images up; a change message is sent on the
+// message thread when they are. A build without the artwork is ready at once,
+// with no images.
+class EditorArtwork : public juce::ChangeBroadcaster,
+                      private juce::Thread
+{
+public:
+    // The size the background is pre-scaled to: the editor's
+    static constexpr int editorWidth = 600;
+    static constexpr int editorHeight = 620;
+
+    EditorArtwork();
+    ~EditorArtwork() override;
+
+    // True once decoding has finished; the images below don't change after that
+    bool isReady() const noexcept { return ready.load(); }
+
+    // The background for a display scale: pre-scaled if one matches (1 or 2),
+    // otherwise as decoded. Invalid before isReady() or without artwork.
+    juce::Image getBackground(float scale) const;
+
+    // Vertical filmstrip of knobFrames frames; invalid before isReady() or without one
+    juce::Image getKnob() const;
+
+    static constexpr int knobFrames = 100;
+
+private:
+    static constexpr int numScales = 2; // 1x, 2x
+
+    juce::Image background, knob;
+    juce::Image scaledBackgrounds[numScales];
+    std::atomic<bool> ready { false };
+
+    void run() override;
+
+    // Draws image into an image of the editor's size times scale, as
+    // RectanglePlacement::fillDestination would
+    static juce::Image fillEditor(const juce::Image& image, int scale);
+
+    JUCE_DECLARE_NON_COPYABLE(EditorArtwork)
+};
@@ -0,0 +1,94 @@
+#include "LinearPhaseCrossover.h"
+
+LinearPhaseKernels::LinearPhaseKernels(int bands, int partitions)
+    : numBands(bands),
+      numPartitions(partitions),
+      spectra((size_t)(bands * partitions * 2 * numBins), 0.0f)
+{
+}
+
+int LinearPhaseKernels::getNumPartitions(double sampleRate) noexcept
+{
+    // Long enough for a steep split at the lowest (~100 Hz) crossover; doubling
+    // with the rate keeps the frequency resolution the same
+    const int length = juce::nextPowerOfTwo(juce::jmax(1, (int)(sampleRate * 0.085)));
+    return juce::jmax(1, length / partitionSize);
+}
+
+int LinearPhaseKernels::getLatencySamples(double sampleRate) noexcept
+{
+    const int numTaps = getNumPartitions(sampleRate) * partitionSize - 1;
+    return (numTaps - 1) / 2 + partitionSize;
+}
+
+std::unique_ptr<LinearPhaseKernels> LinearPhaseKernels::build(double sampleRate, const float* crossovers, int numBands)
+{
+    jassert(numBands >= 2);
+
+    const int numPartitions = getNumPartitions(sampleRate);
+    std::unique_ptr<LinearPhaseKernels> kernels(new LinearPhaseKernels(numBands, numPartitions));
+
+    // Odd length, so the centre tap is a whole sample
+    const int numTaps = numPartitions * partitionSize - 1;
+    const int centre = (numTaps - 1) / 2;
+    constexpr double pi = juce::MathConstants<double>::pi;
+
+    // One unit-DC-gain low-pass per crossover
+    std::vector<std::vector<double>> lowPasses((size_t)(numBands - 1), std::vector<double>((size_t)numTaps));
+
+    for (int k = 0; k < numBands - 1; ++k)
+    {
+        jassert(k == 0 || crossovers[k] > crossovers[k - 1]);
+        const double cutoff = (double)crossovers[k] / sampleRate;
+        auto& lowPass = lowPasses[(size_t)k];
+        double sum = 0.0;
+
+        for (int n = 0; n < numTaps; ++n)
+        {
+            const double x = (double)(n - centre);
+            const double sinc = n == centre ? 2.0 * cutoff : std::sin(2.0 * pi * cutoff * x) / (pi * x);
+            const double phase = 2.0 * pi * (double)n / (double)(numTaps - 1);
+            const double window = 0.42 - 0.5 * std::cos(phase) + 0.08 * std::cos(2.0 * phase);
+
+            lowPass[(size_t)n] = sinc * window;
+            sum += lowPass[(size_t)n];
+        }
+
+        for (auto& tap : lowPass)
+            tap /= sum;
+    }
+
+    juce::dsp::FFT fft(fftOrder);
+    std::vector<float> impulse((size_t)numTaps);
+    std::vector<float> frame((size_t)(2 * fftSize));
+
+    for (int b = 0; b < numBands; ++b)
+    {
+        for (int n = 0; n < numTaps; ++n)
+        {
+            const double upper = b < numBands - 1 ? lowPasses[(size_t)b][(size_t)n] : (n == centre ? 1.0 : 0.0);
+            const double lower = b > 0 ? lowPasses[(size_t)(b - 1)][(size_t)n] : 0.0;
+            impulse[(size_t)n] = (float)(upper - lower);
+        }
+
+        // Each partition zero-padded to the FFT size, as overlap-save expects
+        for (int p = 0; p < numPartitions; ++p)
+        {
+            std::fill(frame.begin(), frame.end(), 0.0f);
+
+            for (int i = 0; i < partitionSize; ++i)
+            {
+                const int n = p * partitionSize + i;
+                if (n < numTaps)
+                    frame[(size_t)i] = impulse[(size_t)n];
+            }
+
+            fft.performRealOnlyForwardTransform(frame.data(), true);
+
+            const auto offset = kernels->getSpectrum(b, p) - kernels->spectra.data();
+            std::copy(frame.begin(), frame.begin() + 2 * numBins, kernels->spectra.begin() + offset);
+        }
+    }
+
+    return kernels;
+}
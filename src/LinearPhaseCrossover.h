@@ -0,0 +1,251 @@
+#pragma once
+#include <juce_dsp/juce_dsp.h>
+#include "WorkStealingPool.h"
+
+// Linear-phase FIR band filters for one crossover layout and sample rate, stored
+// as the spectra of uniform partitions ready for LinearPhaseCrossover.
+//
+// Each crossover is a Blackman-windowed sinc low-pass. Band b is the difference
+// of the low-passes on either side of it (the lowest band is the first low-pass,
+// the highest is a delayed impulse minus the last), so the bands sum to a pure
+// delay of (numTaps - 1) / 2 samples. Kernels are immutable once built and are
+// shared by every channel and every engine of the same layout.
+class LinearPhaseKernels
+{
+public:
+    // Convolution partition (and FFT hop) size; also the extra buffering latency
+    static constexpr int partitionSize = 128;
+    static constexpr int fftOrder = 8;
+    static constexpr int fftSize = 1 << fftOrder;
+    static constexpr int numBins = partitionSize + 1;
+
+    static_assert(fftSize == 2 * partitionSize, "overlap-save needs an FFT of two partitions");
+
+    // FIR length for a sample rate: about 85 ms, a whole number of partitions
+    static int getNumPartitions(double sampleRate) noexcept;
+
+    // FIR group delay plus one partition of input buffering
+    static int getLatencySamples(double sampleRate) noexcept;
+
+    // Designs and transforms the band filters. Allocates and runs FFTs, so call it
+    // off the audio thread. crossovers: numBands - 1 ascending frequencies.
+    static std::unique_ptr<LinearPhaseKernels> build(double sampleRate, const float* crossovers, int numBands);
+
+    int getNumBands() const noexcept { return numBands; }
+    int getNumPartitions() const noexcept { return numPartitions; }
+
+    // One partition's spectrum: numBins interleaved (re, im) pairs
+    const float* getSpectrum(int band, int partition) const noexcept
+    {
+        return spectra.data() + ((size_t)band * (size_t)numPartitions + (size_t)partition) * (size_t)(2 * numBins);
+    }
+
+private:
+    LinearPhaseKernels(int numBands, int numPartitions);
+
+    int numBands = 0;
+    int numPartitions = 0;
+    std::vector<float> spectra;
+
+    JUCE_DECLARE_NON_COPYABLE(LinearPhaseKernels)
+};
+
+// Linear-phase crossover using uniformly partitioned (overlap-save) FFT
+// convolution, with the same interface as LinkwitzRileyCrossover.
+//
+// Input is collected one partition at a time. For every full partition each
+// channel takes one forward FFT into its frequency-domain delay line; each band
+// then multiply-accumulates that line against its kernel partitions and takes
+// one inverse FFT. The kernels come from LinearPhaseKernels and are shared
+// between channels. They are handed over with setKernels() from whichever thread
+// built them; until then the bands are silent but the delay line keeps filling.
+//
+// Every band/channel lane has its own accumulator and inverse FFT, so offline
+// processing can convolve the lanes in parallel with identical results.
+//
+// juce::dsp::FFT is single precision, so the convolution runs in float whatever
+// SampleType is; a double crossover converts at its input and output.
+template <int NumBands, int NumChannels, typename SampleType = float>
+class LinearPhaseCrossover
+{
+public:
+    static constexpr int partitionSize = LinearPhaseKernels::partitionSize;
+    static constexpr int numBins = LinearPhaseKernels::numBins;
+    static constexpr int spectrumSize = 2 * numBins;
+    static constexpr int numLanes = NumBands * NumChannels;
+
+    LinearPhaseCrossover()
+    {
+        for (auto& laneFFT : laneFFTs)
+            laneFFT = std::make_unique<juce::dsp::FFT>(LinearPhaseKernels::fftOrder);
+    }
+
+    // Sizes the delay lines for the kernel length at this rate; drops the kernels
+    void prepare(double sampleRate)
+    {
+        kernels.store(nullptr);
+        numPartitions = LinearPhaseKernels::getNumPartitions(sampleRate);
+
+        delayLine.assign((size_t)(NumChannels * numPartitions * spectrumSize), 0.0f);
+        reset();
+    }
+
+    void reset() noexcept
+    {
+        std::fill(std::begin(inputBlocks), std::end(inputBlocks), 0.0f);
+        std::fill(std::begin(bandOutput), std::end(bandOutput), 0.0f);
+        std::fill(delayLine.begin(), delayLine.end(), 0.0f);
+        position = 0;
+        newestPartition = 0;
+    }
+
+    // Publishes kernels built for this layout and sample rate (nullptr to drop them).
+    // The caller keeps them alive while they are in use.
+    void setKernels(const LinearPhaseKernels* newKernels) noexcept
+    {
+        jassert(newKernels == nullptr || (newKernels->getNumBands() == NumBands
+                                          && newKernels->getNumPartitions() == numPartitions));
+        kernels.store(newKernels, std::memory_order_release);
+    }
+
+    bool hasKernels() const noexcept { return kernels.load(std::memory_order_acquire) != nullptr; }
+
+    // input: NumChannels channels. bands: NumBands * NumChannels channels,
+    // band-major (band * NumChannels + channel). dry: NumChannels channels and
+    // may alias input. Output lags input by LinearPhaseKernels::getLatencySamples().
+    // With workers, the lanes of each partition are convolved in parallel (offline only).
+    void process(const SampleType* const* input, SampleType* const* bands, SampleType* const* dry, int numSamples,
+                 WorkStealingPool* workers = nullptr) noexcept
+    {
+        const auto* currentKernels = kernels.load(std::memory_order_acquire);
+
+        for (int done = 0; done < numSamples;)
+        {
+            const int n = juce::jmin(partitionSize - position, numSamples - done);
+
+            // Input is read before dry is written, so the two may alias
+            for (int ch = 0; ch < NumChannels; ++ch)
+                std::copy(input[ch] + done, input[ch] + done + n, inputBlocks + ch * 2 * partitionSize + partitionSize + position);
+
+            for (int ch = 0; ch < NumChannels; ++ch)
+            {
+                auto* dryOut = dry[ch] + done;
+                std::fill(dryOut, dryOut + n, (SampleType)0);
+
+                for (int b = 0; b < NumBands; ++b)
+                {
+                    const float* source = bandOutput + (b * NumChannels + ch) * partitionSize + position;
+                    SampleType* bandOut = bands[b * NumChannels + ch] + done;
+
+                    for (int i = 0; i < n; ++i)
+                    {
+                        bandOut[i] = source[i];
+                        dryOut[i] += source[i];
+                    }
+                }
+            }
+
+            position += n;
+            done += n;
+
+            if (position == partitionSize)
+            {
+                convolvePartition(currentKernels, workers);
+                position = 0;
+            }
+        }
+    }
+
+private:
+    std::atomic<const LinearPhaseKernels*> kernels { nullptr };
+    int numPartitions = 1;
+
+    juce::dsp::FFT fft { LinearPhaseKernels::fftOrder };
+
+    // Per channel: the previous and the current input partition (the FFT frame)
+    float inputBlocks[NumChannels * 2 * partitionSize] = {};
+
+    // Output of the last convolved partition, band-major like the band lanes
+    float bandOutput[NumBands * NumChannels * partitionSize] = {};
+
+    // Per channel: spectra of the last numPartitions input frames, as a ring
+    std::vector<float> delayLine;
+    int newestPartition = 0;
+    int position = 0;
+
+    alignas(32) float frame[2 * LinearPhaseKernels::fftSize] = {};
+
+    // Per lane, so lanes can be convolved concurrently
+    alignas(32) float accumulators[numLanes][2 * LinearPhaseKernels::fftSize] = {};
+    std::unique_ptr<juce::dsp::FFT> laneFFTs[numLanes];
+
+    float* getDelayLine(int ch, int partition) noexcept
+    {
+        return delayLine.data() + (size_t)((ch * numPartitions + partition) * spectrumSize);
+    }
+
+    static void multiplyAccumulate(float* sum, const float* a, const float* b) noexcept
+    {
+        for (int k = 0; k < spectrumSize; k += 2)
+        {
+            sum[k] += a[k] * b[k] - a[k + 1] * b[k + 1];
+            sum[k + 1] += a[k] * b[k + 1] + a[k + 1] * b[k];
+        }
+    }
+
+    void convolvePartition(const LinearPhaseKernels* currentKernels, WorkStealingPool* workers) noexcept
+    {
+        newestPartition = newestPartition + 1 < numPartitions ? newestPartition + 1 : 0;
+
+        for (int ch = 0; ch < NumChannels; ++ch)
+        {
+            float* block = inputBlocks + ch * 2 * partitionSize;
+
+            std::copy(block, block + 2 * partitionSize, frame);
+            fft.performRealOnlyForwardTransform(frame, true);
+            std::copy(frame, frame + spectrumSize, getDelayLine(ch, newestPartition));
+
+            // The current partition becomes the first half of the next frame
+            std::copy(block + partitionSize, block + 2 * partitionSize, block);
+        }
+
+        if (currentKernels == nullptr)
+        {
+            std::fill(std::begin(bandOutput), std::end(bandOutput), 0.0f);
+            return;
+        }
+
+        auto convolveLane = [this, currentKernels](int lane)
+        {
+            const int b = lane / NumChannels;
+            const int ch = lane % NumChannels;
+            float* accumulator = accumulators[lane];
+
+            std::fill(accumulator, accumulator + 2 * LinearPhaseKernels::fftSize, 0.0f);
+
+            // Kernel partition p meets the input frame from p partitions ago;
+            // walking the ring backwards in two runs avoids a modulo per partition
+            int p = 0;
+            for (int slot = newestPartition; slot >= 0; --slot, ++p)
+                multiplyAccumulate(accumulator, getDelayLine(ch, slot), currentKernels->getSpectrum(b, p));
+
+            for (int slot = numPartitions - 1; slot > newestPartition; --slot, ++p)
+                multiplyAccumulate(accumulator, getDelayLine(ch, slot), currentKernels->getSpectrum(b, p));
+
+            // The second half of the circular convolution is the linear part
+            laneFFTs[lane]->performRealOnlyInverseTransform(accumulator);
+            std::copy(accumulator + partitionSize, accumulator + 2 * partitionSize, bandOutput + lane * partitionSize);
+        };
+
+        if (workers != nullptr)
+        {
+            workers->parallelFor(numLanes, convolveLane);
+            return;
+        }
+
+        for (int lane = 0; lane < numLanes; ++lane)
+            convolveLane(lane);
+    }
+
+    JUCE_DECLARE_NON_COPYABLE(LinearPhaseCrossover)
+};
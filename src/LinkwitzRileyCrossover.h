@@ -0,0 +1,201 @@
+#pragma once
+#include <juce_dsp/juce_dsp.h>
+
+// Single-pass Linkwitz-Riley (4th order) crossover tree.
+//
+// The input is split at a middle crossover, and each half is split again until
+// every band is separate. The LP and HP outputs of a split sum to a 2nd-order
+// allpass, so the bands only sum flat if each one has been through every
+// split's phase response. After each split, the low half therefore goes
+// through the allpasses of the crossovers that will split the high half, and
+// vice versa. All bands end up with the same total phase, and their sum is
+// the input through that one allpass chain. Splitting in the middle first
+// needs fewer compensation allpasses than a low-to-high ladder (4 instead of 6
+// for five bands).
+//
+// process() reads each input sample once and writes every band plus that summed
+// (phase-aligned) dry signal. The tree is a compile-time list of stages, so it
+// unrolls completely. Each channel's filter state is one struct, and all
+// channels' state is held in locals for the whole block.
+//
+// The filters are the same TPT state-variable structure as
+// juce::dsp::LinkwitzRileyFilter, including its combined low/high output.
+// Coefficients, state and arithmetic are all SampleType (float or double).
+template <int NumBands, int NumChannels, typename SampleType = float>
+class LinkwitzRileyCrossover
+{
+public:
+    static_assert(NumBands >= 2, "need at least one crossover");
+
+    static constexpr int numSplits = NumBands - 1;
+
+    LinkwitzRileyCrossover() { reset(); }
+
+    // frequencies: numSplits crossover frequencies, ascending
+    void prepare(double sampleRate, const float* frequencies) noexcept
+    {
+        for (int k = 0; k < numSplits; ++k)
+        {
+            jassert(k == 0 || frequencies[k] > frequencies[k - 1]);
+            jassert(frequencies[k] > 0.0f && frequencies[k] < (float)sampleRate * 0.5f);
+
+            g[k] = (SampleType)std::tan(juce::MathConstants<double>::pi * (double)frequencies[k] / sampleRate);
+            h[k] = (SampleType)1 / ((SampleType)1 + sqrt2 * g[k] + g[k] * g[k]);
+            r2PlusG[k] = sqrt2 + g[k];
+        }
+
+        reset();
+    }
+
+    void reset() noexcept
+    {
+        for (auto& channelState : state)
+            channelState = {};
+    }
+
+    // input: NumChannels channels. bands: NumBands * NumChannels channels,
+    // band-major (band * NumChannels + channel). dry: NumChannels channels and
+    // may alias input.
+    void process(const SampleType* const* input, SampleType* const* bands, SampleType* const* dry, int numSamples) noexcept
+    {
+        // Channels are interleaved within each sample, so their (serial) filter
+        // chains overlap in the pipeline
+        ChannelState s[NumChannels];
+        std::copy(std::begin(state), std::end(state), s);
+
+        for (int i = 0; i < numSamples; ++i)
+        {
+            for (int ch = 0; ch < NumChannels; ++ch)
+            {
+                // A signal covering bands [lo, hi] is kept in band[lo] until it is fully split
+                SampleType band[NumBands];
+                band[0] = input[ch][i];
+
+                unrolled<numStages>([&](auto index)
+                {
+                    constexpr Stage stage = program.stages[index];
+
+                    if constexpr (stage.isSplit)
+                        split(stage.crossover, s[ch].stages[index], band[stage.band], band[stage.band], band[stage.highBand]);
+                    else
+                        band[stage.band] = applyAllpass(stage.crossover, s[ch].stages[index], band[stage.band]);
+                });
+
+                SampleType sum = 0;
+                for (int b = 0; b < NumBands; ++b)
+                {
+                    bands[b * NumChannels + ch][i] = band[b];
+                    sum += band[b];
+                }
+
+                dry[ch][i] = sum;
+            }
+        }
+
+        std::copy(std::begin(s), std::end(s), state);
+    }
+
+private:
+    static constexpr SampleType sqrt2 = (SampleType)1.41421356237309515;
+
+    // One step of the tree: an LR4 split of band into band (low) and highBand,
+    // or a compensation allpass on band
+    struct Stage
+    {
+        bool isSplit = false;
+        int crossover = 0;
+        int band = 0;
+        int highBand = 0;
+    };
+
+    struct Program
+    {
+        Stage stages[numSplits * numSplits] {};
+        int size = 0;
+    };
+
+    // Splits bands [lo, hi] (held in band[lo]) at the middle crossover, compensates
+    // each half for the other half's crossovers, then recurses
+    static constexpr void addStages(Program& program, int lo, int hi)
+    {
+        if (lo == hi)
+            return;
+
+        const int middle = (lo + hi - 1) / 2;
+        program.stages[program.size++] = { true, middle, lo, middle + 1 };
+
+        for (int k = middle + 1; k < hi; ++k)
+            program.stages[program.size++] = { false, k, lo, 0 };
+
+        for (int k = lo; k < middle; ++k)
+            program.stages[program.size++] = { false, k, middle + 1, 0 };
+
+        addStages(program, lo, middle);
+        addStages(program, middle + 1, hi);
+    }
+
+    static constexpr Program makeProgram()
+    {
+        Program program;
+        addStages(program, 0, NumBands - 1);
+        return program;
+    }
+
+    static constexpr Program program = makeProgram();
+    static constexpr int numStages = program.size;
+
+    struct ChannelState
+    {
+        SampleType stages[numStages][4]; // two SVFs per split, one per allpass
+    };
+
+    SampleType g[numSplits] = {};
+    SampleType h[numSplits] = {};
+    SampleType r2PlusG[numSplits] = {};
+
+    ChannelState state[NumChannels];
+
+    // Calls function(std::integral_constant<int, i>) for i in [0, Count), expanded
+    // at compile time so the filter state can stay in registers
+    template <int Count, typename Function>
+    static void unrolled(Function&& function)
+    {
+        [&]<int... Indices>(std::integer_sequence<int, Indices...>)
+        {
+            (function(std::integral_constant<int, Indices>()), ...);
+        }(std::make_integer_sequence<int, Count>());
+    }
+
+    // LR4 split: low = LP4, high = AP2 - LP4, so low + high is the allpass
+    void split(int k, SampleType (&s)[4], SampleType x, SampleType& low, SampleType& high) const noexcept
+    {
+        const SampleType yH = (x - r2PlusG[k] * s[0] - s[1]) * h[k];
+        const SampleType yB = g[k] * yH + s[0];
+        s[0] = g[k] * yH + yB;
+        const SampleType yL = g[k] * yB + s[1];
+        s[1] = g[k] * yB + yL;
+
+        const SampleType yH2 = (yL - r2PlusG[k] * s[2] - s[3]) * h[k];
+        const SampleType yB2 = g[k] * yH2 + s[2];
+        s[2] = g[k] * yH2 + yB2;
+        const SampleType yL2 = g[k] * yB2 + s[3];
+        s[3] = g[k] * yB2 + yL2;
+
+        low = yL2;
+        high = yL - sqrt2 * yB + yH - yL2;
+    }
+
+    // 2nd-order allpass matching split k's LP + HP sum
+    SampleType applyAllpass(int k, SampleType (&s)[4], SampleType x) const noexcept
+    {
+        const SampleType yH = (x - r2PlusG[k] * s[0] - s[1]) * h[k];
+        const SampleType yB = g[k] * yH + s[0];
+        s[0] = g[k] * yH + yB;
+        const SampleType yL = g[k] * yB + s[1];
+        s[1] = g[k] * yB + yL;
+
+        return yL - sqrt2 * yB + yH;
+    }
+
+    JUCE_DECLARE_NON_COPYABLE(LinkwitzRileyCrossover)
+};
@@ -0,0 +1,238 @@
+#pragma once
+#include <juce_audio_basics/juce_audio_basics.h>
+
+// Building blocks of the compressor lookahead: the audio is delayed while the
+// detector keeps reading the undelayed signal, so a gain change starts before
+// the transient that caused it reaches the output.
+//
+// Both keep their history in rings allocated by prepare() for the longest
+// delay, and cost the same per sample whatever the delay.
+
+// A fixed number of lanes delayed by the same, variable, number of samples.
+//
+// A new delay doesn't jump: the output crossfades linearly from the old read
+// position to the new one over the fade length given to prepare(), and a change
+// that arrives during a fade starts once it is done. The rings are written with
+// every sample even at no delay (a plain copy then), so switching the delay on
+// fades in audio that was really there rather than silence.
+template <int NumLanes, typename SampleType = float>
+class LookaheadDelay
+{
+public:
+    LookaheadDelay() = default;
+
+    // Allocates the rings for delays up to maxDelaySamples and sets the length of
+    // the crossfade between delays; call from prepare()
+    void prepare(int maxDelaySamples, int fadeSamples)
+    {
+        ringSize = juce::nextPowerOfTwo(juce::jmax(1, maxDelaySamples) + 1);
+        maxDelay = maxDelaySamples;
+        fadeLength = juce::jmax(1, fadeSamples);
+
+        for (auto& ring : rings)
+            ring.assign((size_t)ringSize, (SampleType)0);
+
+        reset();
+    }
+
+    // Clears the rings; the next process() takes its delay without a fade
+    void reset() noexcept
+    {
+        for (auto& ring : rings)
+            std::fill(ring.begin(), ring.end(), (SampleType)0);
+
+        writeIndex = 0;
+        delay = -1;
+        fadeRemaining = 0;
+    }
+
+    int getMaxDelay() const noexcept { return maxDelay; }
+
+    // False if process() with this delay would leave the lanes as they are: no
+    // delay now, none requested and no fade running
+    bool isDelaying(int delaySamples) const noexcept
+    {
+        return delaySamples > 0 || delay > 0 || fadeRemaining > 0;
+    }
+
+    // Delays lanes[0..NumLanes-1] in place by delaySamples (at most getMaxDelay()),
+    // fading from the previous delay if it differs
+    void process(SampleType* const* lanes, int numSamples, int delaySamples) noexcept
+    {
+        jassert(delaySamples >= 0 && delaySamples <= maxDelay);
+        const int mask = ringSize - 1;
+
+        if (delay < 0)
+        {
+            delay = delaySamples;
+        }
+        else if (delaySamples != delay && fadeRemaining == 0)
+        {
+            previousDelay = delay;
+            delay = delaySamples;
+            fadeRemaining = fadeLength;
+        }
+
+        if (! isDelaying(delay))
+        {
+            record(lanes, numSamples);
+            return;
+        }
+
+        const int fadeSamples = juce::jmin(numSamples, fadeRemaining);
+        const SampleType fadeStep = (SampleType)1 / (SampleType)fadeLength;
+
+        for (int lane = 0; lane < NumLanes; ++lane)
+        {
+            SampleType* data = lanes[lane];
+            SampleType* ring = rings[lane].data();
+            int write = writeIndex;
+            int i = 0;
+
+            // Weight of the old read position, falling to 0 at the end of the fade
+            for (; i < fadeSamples; ++i)
+            {
+                ring[write] = data[i];
+                const SampleType weight = (SampleType)(fadeRemaining - i) * fadeStep;
+                const SampleType current = ring[(write - delay) & mask];
+                data[i] = current + (ring[(write - previousDelay) & mask] - current) * weight;
+                write = (write + 1) & mask;
+            }
+
+            for (; i < numSamples; ++i)
+            {
+                ring[write] = data[i];
+                data[i] = ring[(write - delay) & mask];
+                write = (write + 1) & mask;
+            }
+        }
+
+        fadeRemaining -= fadeSamples;
+        writeIndex = (writeIndex + numSamples) & mask;
+    }
+
+private:
+    std::vector<SampleType> rings[NumLanes];
+    int ringSize = 1, maxDelay = 0, writeIndex = 0;
+
+    // Read positions: delay, and while fadeRemaining > 0 the one it fades from.
+    // delay is -1 after reset().
+    int delay = -1, previousDelay = 0, fadeLength = 1, fadeRemaining = 0;
+
+    // Records the lanes without delaying them; at most two copies per lane
+    void record(const SampleType* const* lanes, int numSamples) noexcept
+    {
+        const int mask = ringSize - 1;
+
+        for (int done = 0; done < numSamples;)
+        {
+            const int start = (writeIndex + done) & mask;
+            const int count = juce::jmin(numSamples - done, ringSize - start);
+
+            for (int lane = 0; lane < NumLanes; ++lane)
+                std::copy(lanes[lane] + done, lanes[lane] + done + count, rings[lane].begin() + start);
+
+            done += count;
+        }
+
+        writeIndex = (writeIndex + numSamples) & mask;
+    }
+
+    JUCE_DECLARE_NON_COPYABLE(LookaheadDelay)
+};
+
+// Running maximum of |x| over the last window + 1 samples, for a fixed number of
+// lanes. Each lane keeps a monotonic deque: candidates in arrival order with
+// strictly decreasing values. A new sample drops every candidate it is at least
+// as loud as, and the oldest candidate leaves once it is outside the window, so
+// the front is always the maximum and each sample is pushed and popped once.
+// Candidates that left a shorter window are gone, so right after the window grows
+// the maximum only covers what the old window held.
+template <int NumLanes, typename SampleType = float>
+class SlidingMaximum
+{
+public:
+    SlidingMaximum() = default;
+
+    // Allocates the deques for windows up to maxWindow samples; call from prepare()
+    void prepare(int maxWindow)
+    {
+        capacity = juce::nextPowerOfTwo(juce::jmax(1, maxWindow) + 1);
+        this->maxWindow = maxWindow;
+
+        for (auto& deque : deques)
+        {
+            deque.values.assign((size_t)capacity, (SampleType)0);
+            deque.times.assign((size_t)capacity, 0u);
+        }
+
+        reset();
+    }
+
+    // Empties the deques. startTime only sets where the sample counter wraps;
+    // the lookahead check starts it just below the wrap.
+    void reset(juce::uint32 startTime = 0) noexcept
+    {
+        for (auto& deque : deques)
+            deque.front = deque.size = 0;
+
+        now = startTime;
+    }
+
+    // output[lane][i] = max |input[lane][j]| for j in [i - window, i], with the
+    // samples of earlier calls before i = 0. output may be input.
+    void process(const SampleType* const* input, SampleType* const* output, int numSamples, int window) noexcept
+    {
+        jassert(window >= 0 && window <= maxWindow);
+        const int mask = capacity - 1;
+
+        for (int lane = 0; lane < NumLanes; ++lane)
+        {
+            auto& deque = deques[lane];
+            SampleType* values = deque.values.data();
+            juce::uint32* times = deque.times.data();
+            const SampleType* in = input[lane];
+            SampleType* out = output[lane];
+            juce::uint32 time = now;
+
+            for (int i = 0; i < numSamples; ++i, ++time)
+            {
+                const SampleType level = std::abs(in[i]);
+
+                // Expire first, so the deque never holds more than window + 1
+                // candidates. Unsigned difference, so the counter may wrap.
+                while (deque.size > 0 && time - times[deque.front] > (juce::uint32)window)
+                {
+                    deque.front = (deque.front + 1) & mask;
+                    --deque.size;
+                }
+
+                while (deque.size > 0 && values[(deque.front + deque.size - 1) & mask] <= level)
+                    --deque.size;
+
+                const int back = (deque.front + deque.size) & mask;
+                values[back] = level;
+                times[back] = time;
+                ++deque.size;
+
+                out[i] = values[deque.front];
+            }
+        }
+
+        now += (juce::uint32)numSamples;
+    }
+
+private:
+    struct Deque
+    {
+        std::vector<SampleType> values;
+        std::vector<juce::uint32> times;
+        int front = 0, size = 0;
+    };
+
+    Deque deques[NumLanes];
+    int capacity = 1, maxWindow = 0;
+    juce::uint32 now = 0;
+
+    JUCE_DECLARE_NON_COPYABLE(SlidingMaximum)
+};
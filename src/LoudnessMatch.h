@@ -0,0 +1,259 @@
+#pragma once
+#include <juce_audio_basics/juce_audio_basics.h>
+#include <complex>
+#include <type_traits>
+
+// Gain match by loudness: compares the K-weighted loudness (ITU-R BS.1770) of the
+// processed signal with that of the dry signal over a sliding 400 ms window (the
+// momentary-loudness window) and scales the processed signal by the difference.
+//
+// Everything advances per sample, so the result does not depend on how the host
+// slices blocks:
+//   - each signal's channels go through the two K-weighting biquads, and their
+//     squares are summed into one energy value per sample
+//   - a running sum over a ring of those energies gives the window's mean in
+//     O(1) per sample; the sum is compensated (Neumaier), so the rounding of
+//     every add and remove is carried along instead of building up
+//   - every controlInterval samples the target gain becomes sqrt(dry / wet),
+//     limited to +-maxGainDb and held while either signal is below the BS.1770
+//     absolute gate (-70 LUFS), so silence is never boosted
+//   - the applied gain follows the target through a one-pole smoother
+class LoudnessMatch
+{
+public:
+    static constexpr double windowSeconds = 0.4;
+    static constexpr double smoothingSeconds = 0.1;
+    static constexpr int controlInterval = 32;
+    static constexpr float maxGainDb = 24.0f;
+    static constexpr int maxChannels = 16;
+
+    LoudnessMatch() = default;
+
+    // Allocates the window rings and scratch; call from prepareToPlay
+    void prepare(double sampleRate, int maxBlockSize, int numChannels)
+    {
+        preparedRate = sampleRate;
+        designKWeighting(sampleRate);
+
+        windowLength = juce::jmax(1, juce::roundToInt(windowSeconds * sampleRate));
+        dryWindow.assign((size_t)windowLength, 0.0f);
+        wetWindow.assign((size_t)windowLength, 0.0f);
+
+        dryEnergy.assign((size_t)juce::jmax(1, maxBlockSize), 0.0f);
+        wetEnergy.assign((size_t)juce::jmax(1, maxBlockSize), 0.0f);
+        gains.assign((size_t)juce::jmax(1, maxBlockSize), 1.0f);
+
+        numPreparedChannels = juce::jlimit(0, maxChannels, numChannels);
+        smoothing = (float)std::exp(-(double)controlInterval / (smoothingSeconds * sampleRate));
+        reset();
+    }
+
+    // Forgets both signals' history; the gain restarts at unity
+    void reset() noexcept
+    {
+        for (auto& channel : dryFilters) channel = {};
+        for (auto& channel : wetFilters) channel = {};
+
+        std::fill(dryWindow.begin(), dryWindow.end(), 0.0f);
+        std::fill(wetWindow.begin(), wetWindow.end(), 0.0f);
+        drySum = wetSum = {};
+        writeIndex = 0;
+        filled = 0;
+
+        samplesToUpdate = 0;
+        targetGain = gain = previousGain = 1.0f;
+    }
+
+    // Scales the first numChannels channels of wet (at most prepared) in place, by
+    // the loudness difference to the same channels of dry
+    template <typename SampleType>
+    void process(juce::AudioBuffer<SampleType>& wet, const juce::AudioBuffer<SampleType>& dry, int numChannels) noexcept
+    {
+        const int numSamples = wet.getNumSamples();
+        numChannels = juce::jmin(numChannels, numPreparedChannels, wet.getNumChannels(), dry.getNumChannels());
+        jassert(numSamples <= (int)gains.size());
+
+        measureEnergy(dry, numChannels, numSamples, dryFilters, dryEnergy.data());
+        measureEnergy(wet, numChannels, numSamples, wetFilters, wetEnergy.data());
+
+        for (int i = 0; i < numSamples; ++i)
+        {
+            // Slide both windows by one sample
+            const float dryIn = dryEnergy[(size_t)i], wetIn = wetEnergy[(size_t)i];
+            drySum.add(dryIn);
+            drySum.add(-dryWindow[(size_t)writeIndex]);
+            wetSum.add(wetIn);
+            wetSum.add(-wetWindow[(size_t)writeIndex]);
+            dryWindow[(size_t)writeIndex] = dryIn;
+            wetWindow[(size_t)writeIndex] = wetIn;
+            filled = juce::jmin(filled + 1, windowLength);
+
+            if (++writeIndex == windowLength)
+                writeIndex = 0;
+
+            if (--samplesToUpdate <= 0)
+            {
+                updateTarget();
+                samplesToUpdate = controlInterval;
+
+                previousGain = gain;
+                gain = targetGain + (gain - targetGain) * smoothing;
+            }
+
+            // Linear between control points: the smoothed gain is reached at the next one
+            const float position = (float)(controlInterval - samplesToUpdate + 1) / (float)controlInterval;
+            gains[(size_t)i] = previousGain + (gain - previousGain) * position;
+        }
+
+        for (int ch = 0; ch < numChannels; ++ch)
+        {
+            SampleType* data = wet.getWritePointer(ch);
+
+            if constexpr (std::is_same_v<SampleType, float>)
+                juce::FloatVectorOperations::multiply(data, gains.data(), numSamples);
+            else
+                for (int i = 0; i < numSamples; ++i)
+                    data[i] *= (SampleType)gains[(size_t)i];
+        }
+    }
+
+    // Magnitude response of the K-weighting at the prepared rate, in dB
+    double getKWeightingDb(double frequency) const noexcept
+    {
+        const double w = juce::MathConstants<double>::twoPi * frequency / preparedRate;
+        return 20.0 * std::log10(getMagnitude(shelf, w) * getMagnitude(highPass, w));
+    }
+
+    // Mean K-weighted energy over the current window, for the checks
+    double getDryMeanSquare() const noexcept { return drySum.get() / (double)juce::jmax(1, filled); }
+    double getWetMeanSquare() const noexcept { return wetSum.get() / (double)juce::jmax(1, filled); }
+
+private:
+    // Transposed direct form II; coefficients normalised by a0
+    struct Biquad
+    {
+        double b0 = 1.0, b1 = 0.0, b2 = 0.0, a1 = 0.0, a2 = 0.0;
+    };
+
+    struct FilterState
+    {
+        double shelf[2] = {};
+        double highPass[2] = {};
+    };
+
+    // Sum with Neumaier's compensation: each add's rounding error is kept in
+    // compensation, so a sum that has had every term it ever got removed again
+    // comes back to (almost exactly) zero
+    struct CompensatedSum
+    {
+        double sum = 0.0, compensation = 0.0;
+
+        void add(double x) noexcept
+        {
+            const double t = sum + x;
+            compensation += std::abs(sum) >= std::abs(x) ? (sum - t) + x : (x - t) + sum;
+            sum = t;
+        }
+
+        double get() const noexcept { return sum + compensation; }
+    };
+
+    Biquad shelf, highPass;
+    double preparedRate = 48000.0;
+    FilterState dryFilters[maxChannels], wetFilters[maxChannels];
+    int numPreparedChannels = 0;
+
+    std::vector<float> dryWindow, wetWindow;   // per-sample energy, windowLength long
+    CompensatedSum drySum, wetSum;
+    int windowLength = 1, writeIndex = 0, filled = 0;
+
+    std::vector<float> dryEnergy, wetEnergy, gains; // per-block scratch
+
+    float smoothing = 0.0f;
+    int samplesToUpdate = 0;
+    float targetGain = 1.0f, gain = 1.0f, previousGain = 1.0f;
+
+    static double processBiquad(const Biquad& f, double (&z)[2], double x) noexcept
+    {
+        const double y = f.b0 * x + z[0];
+        z[0] = f.b1 * x - f.a1 * y + z[1];
+        z[1] = f.b2 * x - f.a2 * y;
+        return y;
+    }
+
+    static double getMagnitude(const Biquad& f, double w) noexcept
+    {
+        const std::complex<double> z = std::polar(1.0, -w);
+        return std::abs((f.b0 + z * (f.b1 + z * f.b2)) / (1.0 + z * (f.a1 + z * f.a2)));
+    }
+
+    // Sum over channels of the squared K-weighted signal, per sample
+    template <typename SampleType>
+    void measureEnergy(const juce::AudioBuffer<SampleType>& buffer, int numChannels, int numSamples,
+                       FilterState* filters, float* energy) const noexcept
+    {
+        std::fill(energy, energy + numSamples, 0.0f);
+
+        for (int ch = 0; ch < numChannels; ++ch)
+        {
+            const SampleType* data = buffer.getReadPointer(ch);
+            auto state = filters[ch];
+
+            for (int i = 0; i < numSamples; ++i)
+            {
+                const double weighted = processBiquad(highPass, state.highPass, processBiquad(shelf, state.shelf, (double)data[i]));
+                energy[i] += (float)(weighted * weighted);
+            }
+
+            filters[ch] = state;
+        }
+    }
+
+    void updateTarget() noexcept
+    {
+        // -70 LUFS: -0.691 + 10 log10(mean square) = -70
+        constexpr double absoluteGate = 1.1724653045822963e-7;
+
+        const double dryMean = getDryMeanSquare();
+        const double wetMean = getWetMeanSquare();
+
+        if (dryMean < absoluteGate || wetMean < absoluteGate)
+            return;
+
+        const float limit = juce::Decibels::decibelsToGain(maxGainDb);
+        targetGain = juce::jlimit(1.0f / limit, limit, (float)std::sqrt(dryMean / wetMean));
+    }
+
+    // BS.1770 pre-filter (high shelf, +4 dB above ~1.7 kHz) and RLB high-pass
+    // (~38 Hz), redesigned for the sample rate from their analogue prototypes
+    void designKWeighting(double sampleRate) noexcept
+    {
+        {
+            constexpr double f0 = 1681.974450955533, gainDb = 3.999843853973347, q = 0.7071752369554196;
+            const double k = std::tan(juce::MathConstants<double>::pi * f0 / sampleRate);
+            const double vh = std::pow(10.0, gainDb / 20.0);
+            const double vb = std::pow(vh, 0.4996667741545416);
+            const double a0 = 1.0 + k / q + k * k;
+
+            shelf.b0 = (vh + vb * k / q + k * k) / a0;
+            shelf.b1 = 2.0 * (k * k - vh) / a0;
+            shelf.b2 = (vh - vb * k / q + k * k) / a0;
+            shelf.a1 = 2.0 * (k * k - 1.0) / a0;
+            shelf.a2 = (1.0 - k / q + k * k) / a0;
+        }
+
+        {
+            constexpr double f0 = 38.13547087602444, q = 0.5003270373238773;
+            const double k = std::tan(juce::MathConstants<double>::pi * f0 / sampleRate);
+            const double a0 = 1.0 + k / q + k * k;
+
+            highPass.b0 = 1.0;
+            highPass.b1 = -2.0;
+            highPass.b2 = 1.0;
+            highPass.a1 = 2.0 * (k * k - 1.0) / a0;
+            highPass.a2 = (1.0 - k / q + k * k) / a0;
+        }
+    }
+
+    JUCE_DECLARE_NON_COPYABLE(LoudnessMatch)
+};
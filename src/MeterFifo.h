@@ -0,0 +1,100 @@
+#pragma once
+#include <juce_core/juce_core.h>
+#include "ParameterSnapshot.h"
+
+// Metering for one processed block. Levels are linear, the loudest channel;
+// band values are indexed by parameter slot and are 0 for unused slots.
+struct MeterFrame
+{
+    juce::int64 sampleTime = 0; // first sample of the block, counted from prepareToPlay
+    int numSamples = 0;
+    double timeMs = 0.0;        // Time::getMillisecondCounterHiRes() when the block finished
+
+    float inputPeak = 0.0f, inputRms = 0.0f;
+    float outputPeak = 0.0f, outputRms = 0.0f;
+
+    float bandLevel[ParameterSnapshot::numBandSlots] = {};  // RMS after compression
+    float bandGainDb[ParameterSnapshot::numBandSlots] = {}; // static gain at block end: < 0 cut, > 0 boost
+
+    // Folds the following block into this one: peaks and band levels keep the
+    // maximum, RMS is combined by energy, gain keeps the larger excursion
+    void merge(const MeterFrame& next) noexcept
+    {
+        const int total = numSamples + next.numSamples;
+        auto combineRms = [&](float a, float b)
+        {
+            return total > 0 ? std::sqrt((a * a * (float)numSamples + b * b * (float)next.numSamples) / (float)total) : 0.0f;
+        };
+
+        inputPeak = juce::jmax(inputPeak, next.inputPeak);
+        outputPeak = juce::jmax(outputPeak, next.outputPeak);
+        inputRms = combineRms(inputRms, next.inputRms);
+        outputRms = combineRms(outputRms, next.outputRms);
+
+        for (int slot = 0; slot < ParameterSnapshot::numBandSlots; ++slot)
+        {
+            bandLevel[slot] = juce::jmax(bandLevel[slot], next.bandLevel[slot]);
+
+            if (std::abs(next.bandGainDb[slot]) > std::abs(bandGainDb[slot]))
+                bandGainDb[slot] = next.bandGainDb[slot];
+        }
+
+        numSamples = total;
+        timeMs = next.timeMs;
+    }
+};
+
+// Wait-free single-producer/single-consumer ring of MeterFrames: the audio thread
+// pushes one per block, the editor drains them on its timer, so no peak is lost
+// between repaints.
+//
+// push() never blocks or allocates. While the ring is full (e.g. no editor is
+// open) new frames are merged into one pending frame, which goes out as soon as
+// there is room again.
+class MeterFifo
+{
+public:
+    static constexpr int capacity = 1024;
+
+    // Audio thread only
+    void push(const MeterFrame& frame) noexcept
+    {
+        if (hasPending)
+            pending.merge(frame);
+        else
+            pending = frame;
+
+        hasPending = true;
+
+        const auto scope = fifo.write(1);
+
+        if (scope.blockSize1 > 0)
+            frames[(size_t)scope.startIndex1] = pending;
+        else if (scope.blockSize2 > 0)
+            frames[(size_t)scope.startIndex2] = pending;
+        else
+            return; // full: keep merging
+
+        hasPending = false;
+    }
+
+    // Audio thread only: forgets a frame still waiting for room
+    void clearPending() noexcept { hasPending = false; }
+
+    // Message thread only: calls callback(const MeterFrame&) for every queued
+    // frame, oldest first, and returns how many there were
+    template <typename Callback>
+    int drain(Callback&& callback)
+    {
+        const auto scope = fifo.read(fifo.getNumReady());
+        scope.forEach([&](int index) { callback(frames[(size_t)index]); });
+        return scope.blockSize1 + scope.blockSize2;
+    }
+
+private:
+    juce::AbstractFifo fifo { capacity };
+    std::array<MeterFrame, capacity> frames;
+
+    MeterFrame pending;
+    bool hasPending = false;
+};
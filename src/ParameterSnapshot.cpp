@@ -0,0 +1,367 @@
+#include "ParameterSnapshot.h"
+
+namespace
+{
+    // Parameter ID prefixes, in band order
+    const char* const bandPrefixes[ParameterSnapshot::numBandSlots] = { "low", "lowMid", "mid", "highMid", "high" };
+
+    // Stores fresh into cached and reports whether it differed
+    inline bool refresh(float& cached, float fresh) noexcept
+    {
+        if (cached == fresh)
+            return false;
+
+        cached = fresh;
+        return true;
+    }
+
+    inline bool refresh(int& cached, float fresh) noexcept
+    {
+        const int index = juce::roundToInt(fresh);
+
+        if (cached == index)
+            return false;
+
+        cached = index;
+        return true;
+    }
+
+    inline bool refresh(bool& cached, float fresh) noexcept
+    {
+        const bool on = fresh > 0.5f;
+
+        if (cached == on)
+            return false;
+
+        cached = on;
+        return true;
+    }
+}
+
+ParameterSnapshot::ParameterSnapshot(juce::AudioProcessorValueTreeState& apvts, const PresetBank& presetBank)
+    : presets(presetBank)
+{
+    globalSources.depth = bind(apvts, "depth");
+    globalSources.inputGain = bind(apvts, "inputGain");
+    globalSources.outputGain = bind(apvts, "outputGain");
+    globalSources.time = bind(apvts, "time");
+    globalSources.gainMatch = bind(apvts, "gainMatch");
+    globalSources.bandMode = bind(apvts, "bandMode");
+    globalSources.crossoverMode = bind(apvts, "crossoverMode", true);
+    globalSources.linkedDetection = bind(apvts, "linkedDetection");
+    globalSources.lookahead = bind(apvts, "lookahead", true);
+
+    for (int slot = 0; slot < numBandSlots; ++slot)
+    {
+        const juce::String prefix(bandPrefixes[slot]);
+        auto& p = bandSources[slot];
+
+        p.threshDown = bind(apvts, prefix + "ThreshDown");
+        p.ratioDown = bind(apvts, prefix + "RatioDown");
+        p.threshUp = bind(apvts, prefix + "ThreshUp");
+        p.ratioUp = bind(apvts, prefix + "RatioUp");
+        p.attack = bind(apvts, prefix + "Attack");
+        p.release = bind(apvts, prefix + "Release");
+        p.gain = bind(apvts, prefix + "Gain");
+        p.width = bind(apvts, prefix + "Width");
+        p.solo = bind(apvts, prefix + "Solo");
+    }
+
+    values.resize(sources.size());
+    morphStart.resize(sources.size());
+
+    morphTime = apvts.getRawParameterValue("morphTime");
+    abMorph = apvts.getRawParameterValue("abMorph");
+    abPosition = apvts.getRawParameterValue("abPosition");
+    abPresetA = apvts.getRawParameterValue("abPresetA");
+    abPresetB = apvts.getRawParameterValue("abPresetB");
+}
+
+int ParameterSnapshot::bind(juce::AudioProcessorValueTreeState& apvts, const juce::String& parameterID, bool setsLatency)
+{
+    // The latency the host is told comes from the parameters themselves, so
+    // what sets it never follows the A/B presets and never glides
+    Source source;
+    source.parameter = apvts.getRawParameterValue(parameterID);
+    source.presetColumn = setsLatency ? -1 : presets.getColumn(parameterID);
+    source.stepped = setsLatency || dynamic_cast<juce::AudioParameterFloat*>(apvts.getParameter(parameterID)) == nullptr;
+
+    sources.push_back(source);
+    return (int)sources.size() - 1;
+}
+
+void ParameterSnapshot::prepare(double sampleRate, int maxBlockSize)
+{
+    rampBuffer.setSize(numRamps, juce::jmax(1, maxBlockSize));
+
+    for (auto& smoother : smoothers)
+        smoother.reset(sampleRate, rampSeconds);
+
+    std::fill(std::begin(activeRamps), std::end(activeRamps), nullptr);
+    invalidate();
+}
+
+float ParameterSnapshot::timeToCoefficient(float milliseconds, double sampleRate) noexcept
+{
+    const float samples = milliseconds * 0.001f * (float)sampleRate;
+    return samples > 0.0f ? std::exp(-1.0f / samples) : 0.0f;
+}
+
+double ParameterSnapshot::preciseTimeToCoefficient(double milliseconds, double sampleRate) noexcept
+{
+    const double samples = milliseconds * 0.001 * sampleRate;
+    return samples > 0.0 ? std::exp(-1.0 / samples) : 0.0;
+}
+
+int ParameterSnapshot::lookaheadToSamples(float milliseconds, double sampleRate) noexcept
+{
+    return juce::jmax(0, juce::roundToInt(juce::jlimit(0.0f, maxLookaheadMs, milliseconds) * 0.001 * sampleRate));
+}
+
+double ParameterSnapshot::getReleaseTailSeconds(float decayDb) const noexcept
+{
+    const bool ab = abMorph->load() > 0.5f;
+    const int presetA = juce::jlimit(0, presets.getNumPresets() - 1, juce::roundToInt(abPresetA->load()));
+    const int presetB = juce::jlimit(0, presets.getNumPresets() - 1, juce::roundToInt(abPresetB->load()));
+    const int followed = followedPreset.load();
+
+    // The parameter, or the larger preset value while the A/B morph is on or a
+    // preset is followed
+    auto largest = [&](int index)
+    {
+        const auto& source = sources[(size_t)index];
+        float value = source.parameter->load();
+
+        if (ab && source.presetColumn >= 0)
+            value = juce::jmax(value, presets.getValue(presetA, source.presetColumn), presets.getValue(presetB, source.presetColumn));
+
+        if (followed >= 0 && source.presetColumn >= 0)
+            value = juce::jmax(value, presets.getValue(followed, source.presetColumn));
+
+        return value;
+    };
+
+    float longestMs = 0.0f;
+    for (const auto& p : bandSources)
+        longestMs = juce::jmax(longestMs, largest(p.release));
+
+    return releaseTailSeconds((double)longestMs * largest(globalSources.time) / 100.0, decayDb);
+}
+
+double ParameterSnapshot::releaseTailSeconds(double timeConstantMs, float decayDb) noexcept
+{
+    // A one-pole release falls by 20 log10(e) dB per time constant
+    return timeConstantMs * 0.001 * decayDb / 8.685889638065037;
+}
+
+void ParameterSnapshot::updateLongestRelease() noexcept
+{
+    float longestMs = 0.0f, timePercent = global.timePercent;
+
+    for (const auto& band : bands)
+        longestMs = juce::jmax(longestMs, band.releaseMs);
+
+    // The A/B position can move the settings anywhere between the two presets
+    // without this being called again
+    if (abActive)
+    {
+        for (const auto& p : bandSources)
+            if (const int column = sources[(size_t)p.release].presetColumn; column >= 0)
+                longestMs = juce::jmax(longestMs, presets.getValue(activePresetA, column), presets.getValue(activePresetB, column));
+
+        if (const int column = sources[(size_t)globalSources.time].presetColumn; column >= 0)
+            timePercent = juce::jmax(timePercent, presets.getValue(activePresetA, column), presets.getValue(activePresetB, column));
+    }
+
+    longestReleaseMs = (double)longestMs * timePercent / 100.0;
+}
+
+void ParameterSnapshot::readSources(double sampleRate, int numSamples) noexcept
+{
+    const bool ab = abMorph->load() > 0.5f;
+    const int presetA = juce::jlimit(0, presets.getNumPresets() - 1, juce::roundToInt(abPresetA->load()));
+    const int presetB = juce::jlimit(0, presets.getNumPresets() - 1, juce::roundToInt(abPresetB->load()));
+    const float position = juce::jlimit(0.0f, 1.0f, abPosition->load() / 100.0f);
+    const int followed = followedPreset.load();
+
+    // Anything that moves every setting at once glides, unless this block
+    // starts from scratch
+    const bool retarget = ab != abActive || (ab && (presetA != activePresetA || presetB != activePresetB));
+    abRetargeted = retarget;
+    if ((morphRequested.exchange(false) || retarget) && valid)
+    {
+        morphStart = values; // same size, so no allocation
+        morphElapsed = 0.0;
+        morphLength = juce::jlimit(0.0f, maxMorphMs, morphTime->load()) * 0.001 * sampleRate;
+    }
+
+    abActive = ab;
+    activePresetA = presetA;
+    activePresetB = presetB;
+
+    if (! valid)
+        morphElapsed = morphLength;
+
+    const bool morphing = morphElapsed < morphLength;
+    float progress = 1.0f;
+    if (morphing)
+    {
+        morphElapsed = juce::jmin(morphLength, morphElapsed + numSamples);
+        progress = (float)(morphElapsed / morphLength);
+    }
+
+    for (size_t i = 0; i < sources.size(); ++i)
+    {
+        const auto& source = sources[i];
+        float target;
+
+        if (ab && source.presetColumn >= 0)
+        {
+            const float a = presets.getValue(presetA, source.presetColumn);
+            const float b = presets.getValue(presetB, source.presetColumn);
+            target = source.stepped ? (position < 0.5f ? a : b) : a + (b - a) * position;
+        }
+        else if (followed >= 0 && source.presetColumn >= 0)
+        {
+            target = presets.getValue(followed, source.presetColumn);
+        }
+        else
+        {
+            target = source.parameter->load();
+        }
+
+        values[i] = morphing && ! source.stepped ? morphStart[i] + (target - morphStart[i]) * progress : target;
+    }
+}
+
+void ParameterSnapshot::update(double sampleRate, int numSamples) noexcept
+{
+    readSources(sampleRate, numSamples);
+
+    const bool force = ! valid;
+    const bool rateChanged = force || sampleRate != lastSampleRate;
+
+    // Global parameters
+    if (refresh(global.depthPercent, read(globalSources.depth)) || force)
+        global.depth = global.depthPercent / 100.0f;
+
+    if (refresh(global.inputGainDb, read(globalSources.inputGain)) || force)
+        global.inputGain = juce::Decibels::decibelsToGain(global.inputGainDb);
+
+    if (refresh(global.outputGainDb, read(globalSources.outputGain)) || force)
+        global.outputGain = juce::Decibels::decibelsToGain(global.outputGainDb);
+
+    // TIME scales every band's attack and release (100% = as set)
+    const bool timeChanged = refresh(global.timePercent, read(globalSources.time)) || force;
+    if (timeChanged)
+        global.timeScale = global.timePercent / 100.0f;
+
+    refresh(global.gainMatch, read(globalSources.gainMatch));
+    refresh(global.bandMode, read(globalSources.bandMode));
+    refresh(global.linearPhase, read(globalSources.crossoverMode));
+    refresh(global.linkedDetection, read(globalSources.linkedDetection));
+
+    if (refresh(global.lookaheadMs, read(globalSources.lookahead)) || rateChanged)
+        global.lookaheadSamples = lookaheadToSamples(global.lookaheadMs, sampleRate);
+
+    bool releaseChanged = timeChanged || abRetargeted;
+
+    // Band parameters
+    for (int slot = 0; slot < numBandSlots; ++slot)
+    {
+        const auto& p = bandSources[slot];
+        auto& band = bands[slot];
+
+        if (refresh(band.attackMs, read(p.attack)) || timeChanged || rateChanged)
+        {
+            band.attackCoeff = timeToCoefficient(band.attackMs * global.timeScale, sampleRate);
+            band.preciseAttackCoeff = preciseTimeToCoefficient((double)band.attackMs * global.timeScale, sampleRate);
+        }
+
+        const bool slotReleaseChanged = refresh(band.releaseMs, read(p.release));
+        releaseChanged = releaseChanged || slotReleaseChanged;
+
+        if (slotReleaseChanged || timeChanged || rateChanged)
+        {
+            band.releaseCoeff = timeToCoefficient(band.releaseMs * global.timeScale, sampleRate);
+            band.preciseReleaseCoeff = preciseTimeToCoefficient((double)band.releaseMs * global.timeScale, sampleRate);
+        }
+
+        if (refresh(band.ratioDown, read(p.ratioDown)) || force)
+            band.slopeDown = 1.0f - 1.0f / band.ratioDown;
+
+        if (refresh(band.ratioUp, read(p.ratioUp)) || force)
+            band.slopeUp = 1.0f - 1.0f / band.ratioUp;
+
+        if (refresh(band.gainDb, read(p.gain)) || force)
+            band.gain = juce::Decibels::decibelsToGain(band.gainDb);
+
+        if (refresh(band.widthPercent, read(p.width)) || force)
+            band.width = band.widthPercent / 100.0f;
+
+        refresh(band.threshDownDb, read(p.threshDown));
+        refresh(band.threshUpDb, read(p.threshUp));
+        refresh(band.solo, read(p.solo));
+    }
+
+    if (releaseChanged)
+        updateLongestRelease();
+
+    setRampTargets(force);
+
+    lastSampleRate = sampleRate;
+    valid = true;
+}
+
+void ParameterSnapshot::setRampTargets(bool jump) noexcept
+{
+    auto set = [jump](juce::SmoothedValue<float>& smoother, float value)
+    {
+        if (jump)
+            smoother.setCurrentAndTargetValue(value);
+        else
+            smoother.setTargetValue(value);
+    };
+
+    set(smoothers[depthRamp], global.depth);
+    set(smoothers[inputGainRamp], global.inputGain);
+    set(smoothers[outputGainRamp], global.outputGain);
+
+    for (int slot = 0; slot < numBandSlots; ++slot)
+    {
+        const auto& band = bands[slot];
+        auto* bandSmoothers = smoothers + numGlobalRamps + slot * numBandRamps;
+
+        set(bandSmoothers[threshDownRamp], band.threshDownDb);
+        set(bandSmoothers[slopeDownRamp], band.slopeDown);
+        set(bandSmoothers[threshUpRamp], band.threshUpDb);
+        set(bandSmoothers[slopeUpRamp], band.slopeUp);
+        set(bandSmoothers[gainRamp], band.gain);
+        set(bandSmoothers[widthRamp], band.width);
+    }
+}
+
+void ParameterSnapshot::advance(int numSamples) noexcept
+{
+    jassert(numSamples <= rampBuffer.getNumSamples());
+
+    for (int r = 0; r < numRamps; ++r)
+    {
+        auto& smoother = smoothers[r];
+
+        if (! smoother.isSmoothing())
+        {
+            activeRamps[r] = nullptr;
+            continue;
+        }
+
+        // Linear segments end exactly on the target, so once a ramp is done the
+        // plain setting takes over without a step
+        float* ramp = rampBuffer.getWritePointer(r);
+
+        for (int i = 0; i < numSamples; ++i)
+            ramp[i] = smoother.getNextValue();
+
+        activeRamps[r] = ramp;
+    }
+}
@@ -0,0 +1,256 @@
+#pragma once
+#include <juce_audio_processors/juce_audio_processors.h>
+#include "PresetBank.h"
+
+// Per-block snapshot of the plugin parameters.
+//
+// The raw parameter pointers are looked up by ID once, at construction. update()
+// reads them once per block and recomputes the derived values (envelope
+// coefficients, linear gains, ratio slopes, width factors) only where an input
+// parameter or the sample rate changed since the previous block.
+//
+// Values that would click when stepped (gains, depth, width, thresholds and
+// ratio slopes) move to a new setting along a linear ramp of rampSeconds.
+// advance() writes each ramping value's per-sample array for the next chunk;
+// a value that is not ramping has no array (getRamp() returns nullptr), so the
+// DSP uses the plain value and static parameters cost nothing extra. Attack and
+// release only change how fast the envelopes move and are stepped.
+//
+// Presets morph on top of that. With "abMorph" on, every setting comes from
+// the presets "abPresetA" and "abPresetB" of the bank, interpolated at
+// "abPosition", instead of from its parameter. A program change reads its
+// preset straight from the bank too (followPreset()) until the parameters have
+// been set to it on the message thread. A program change (startMorph()), and
+// turning the A/B morph on or off or changing its presets, moves every
+// continuous setting from where it was to where it now points over "morphTime",
+// a step per block that the ramps above smooth; choices and switches change at
+// once. The crossover and lookahead set the latency reported to the host, so
+// they always follow their parameters and step. Outside a morph this costs one
+// pass over the parameter values per block.
+class ParameterSnapshot
+{
+public:
+    // Every band parameter set, low to high. The 3-band mode uses low/mid/high,
+    // 4-band adds lowMid and 5-band adds highMid (see BandEngine.h).
+    enum BandSlot
+    {
+        lowSlot,
+        lowMidSlot,
+        midSlot,
+        highMidSlot,
+        highSlot,
+        numBandSlots
+    };
+
+    // Smoothed values of Global, and of each Band
+    enum GlobalRamp
+    {
+        depthRamp,
+        inputGainRamp,
+        outputGainRamp,
+        numGlobalRamps
+    };
+
+    enum BandRamp
+    {
+        threshDownRamp,  // dB
+        slopeDownRamp,
+        threshUpRamp,    // dB
+        slopeUpRamp,
+        gainRamp,        // linear
+        widthRamp,
+        numBandRamps
+    };
+
+    static constexpr double rampSeconds = 0.02;
+
+    // Range of the "lookahead" parameter. A new lookahead takes effect at once,
+    // but the engines' delay lines crossfade from the old length to the new one
+    // over rampSeconds (LookaheadDelay), also when it is switched on or off, so
+    // it doesn't click.
+    static constexpr float maxLookaheadMs = 10.0f;
+
+    // Range of the "morphTime" parameter
+    static constexpr float maxMorphMs = 5000.0f;
+
+    struct Global
+    {
+        float depthPercent = 50.0f;
+        float inputGainDb = 0.0f;
+        float outputGainDb = 0.0f;
+        float timePercent = 100.0f;
+        bool gainMatch = false;
+        int bandMode = 0;          // 0 = 3 bands, 1 = 4 bands, 2 = 5 bands
+        bool linearPhase = false;  // "crossoverMode": FIR crossover instead of IIR
+        bool linkedDetection = false; // one detector per band per channel group
+        float lookaheadMs = 0.0f;
+
+        // Derived
+        float depth = 0.5f;        // 0-1 wet amount
+        float inputGain = 1.0f;
+        float outputGain = 1.0f;
+        float timeScale = 1.0f;    // global attack/release multiplier
+        int lookaheadSamples = 0;  // detector lead over the audio
+    };
+
+    struct Band
+    {
+        float threshDownDb = -20.0f;
+        float ratioDown = 3.0f;
+        float threshUpDb = -40.0f;
+        float ratioUp = 2.0f;
+        float attackMs = 1.0f;
+        float releaseMs = 100.0f;
+        float gainDb = 0.0f;
+        float widthPercent = 100.0f;
+        bool solo = false;
+
+        // Derived
+        float attackCoeff = 0.0f;
+        float releaseCoeff = 0.0f;
+        float slopeDown = 0.0f;    // 1 - 1/ratioDown
+        float slopeUp = 0.0f;      // 1 - 1/ratioUp
+        float gain = 1.0f;         // linear band gain
+        float width = 1.0f;        // side gain, 0-2
+
+        // The coefficients in double, for the double-precision engine: at long
+        // time constants 1 - coefficient is only a few float steps
+        double preciseAttackCoeff = 0.0;
+        double preciseReleaseCoeff = 0.0;
+    };
+
+    ParameterSnapshot(juce::AudioProcessorValueTreeState& apvts, const PresetBank& presets);
+
+    // Allocates the ramp arrays and sets the ramp length; call from prepareToPlay
+    void prepare(double sampleRate, int maxBlockSize);
+
+    // Reads every parameter; call once per block of numSamples on the audio
+    // thread. Smoothed values start ramping towards the new settings, and a
+    // running morph advances by numSamples.
+    void update(double sampleRate, int numSamples) noexcept;
+
+    // Makes the next update() start a morph from the current settings; call
+    // from any thread just before changing the parameters, e.g. to a preset
+    void startMorph() noexcept { morphRequested = true; }
+
+    // Reads every preset setting from this preset of the bank instead of from
+    // its parameter, from the next update() on; -1 returns to the parameters.
+    // Any thread, so a program change needn't wait for the parameters.
+    void followPreset(int index) noexcept { followedPreset = index; }
+
+    // Returns to the parameters if index is still the followed preset; call once
+    // they have been set to it
+    void releasePreset(int index) noexcept { followedPreset.compare_exchange_strong(index, -1); }
+
+    // Writes the ramp arrays for the next numSamples (at most maxBlockSize)
+    // samples; call before processing each chunk of a block
+    void advance(int numSamples) noexcept;
+
+    // Forces every derived value to be recomputed on the next update, and the
+    // smoothed values (and a running morph) to jump to their settings
+    void invalidate() noexcept { valid = false; }
+
+    // Settings; while a value ramps, its ramp ends at this value
+    const Global& getGlobal() const noexcept { return global; }
+    const Band& getBand(int slot) const noexcept { return bands[slot]; }
+
+    // Per-sample values for the chunk passed to advance(), or nullptr if the
+    // value is constant (equal to its setting) over the whole chunk
+    const float* getRamp(GlobalRamp ramp) const noexcept { return activeRamps[ramp]; }
+    const float* getRamp(int slot, BandRamp ramp) const noexcept { return activeRamps[numGlobalRamps + slot * (int)numBandRamps + ramp]; }
+
+    // One-pole smoothing coefficient for a time constant in milliseconds
+    static float timeToCoefficient(float milliseconds, double sampleRate) noexcept;
+    static double preciseTimeToCoefficient(double milliseconds, double sampleRate) noexcept;
+
+    // Lookahead in whole samples; also the latency it adds
+    static int lookaheadToSamples(float milliseconds, double sampleRate) noexcept;
+
+    // Time the slowest band envelope (release x TIME, over every slot, both A/B
+    // presets and a followed preset) takes to fall by decayDb. Reads the parameters directly, so any
+    // thread may call it.
+    double getReleaseTailSeconds(float decayDb) const noexcept;
+
+    // The same slowest time constant in milliseconds, from the settings of the
+    // last update(). Only recomputed when a release, TIME or the A/B presets
+    // change, so the audio thread can poll it every block.
+    double getLongestReleaseMs() const noexcept { return longestReleaseMs; }
+
+    // Time a one-pole envelope of this time constant takes to fall by decayDb
+    static double releaseTailSeconds(double timeConstantMs, float decayDb) noexcept;
+
+private:
+    // Indices into sources, per parameter
+    struct GlobalSources
+    {
+        int depth = -1, inputGain = -1, outputGain = -1, time = -1, gainMatch = -1;
+        int bandMode = -1, crossoverMode = -1, linkedDetection = -1, lookahead = -1;
+    };
+
+    struct BandSources
+    {
+        int threshDown = -1, ratioDown = -1, threshUp = -1, ratioUp = -1;
+        int attack = -1, release = -1, gain = -1, width = -1, solo = -1;
+    };
+
+    // A parameter the settings are read from: its value, a followed preset's
+    // value for it, or with the A/B morph on, the morph of two presets' values
+    struct Source
+    {
+        std::atomic<float>* parameter = nullptr;
+        int presetColumn = -1;
+        bool stepped = false;  // choices and switches change at once, never glide
+    };
+
+    // Adds a source for parameterID and returns its index
+    int bind(juce::AudioProcessorValueTreeState& apvts, const juce::String& parameterID, bool setsLatency = false);
+
+    // Writes this block's value of every source into values, moving along the
+    // morph if one is running
+    void readSources(double sampleRate, int numSamples) noexcept;
+
+    float read(int source) const noexcept { return values[(size_t)source]; }
+
+    const PresetBank& presets;
+    std::vector<Source> sources;
+    std::vector<float> values, morphStart;
+
+    // Morph controls
+    std::atomic<float>* morphTime = nullptr;
+    std::atomic<float>* abMorph = nullptr;
+    std::atomic<float>* abPosition = nullptr;
+    std::atomic<float>* abPresetA = nullptr;
+    std::atomic<float>* abPresetB = nullptr;
+
+    std::atomic<bool> morphRequested { false };
+    std::atomic<int> followedPreset { -1 };
+    double morphElapsed = 0.0, morphLength = 0.0; // samples; not morphing once elapsed reaches length
+    bool abActive = false, abRetargeted = false;
+    int activePresetA = 0, activePresetB = 0;
+
+    double longestReleaseMs = 0.0;
+
+    // Recomputes longestReleaseMs from the settings and the A/B presets
+    void updateLongestRelease() noexcept;
+
+    GlobalSources globalSources;
+    BandSources bandSources[numBandSlots];
+
+    Global global;
+    Band bands[numBandSlots];
+
+    static constexpr int numRamps = numGlobalRamps + numBandSlots * (int)numBandRamps;
+
+    // Ramps in GlobalRamp order, then BandRamp order per slot
+    juce::SmoothedValue<float> smoothers[numRamps];
+    juce::AudioBuffer<float> rampBuffer;
+    const float* activeRamps[numRamps] = {};
+
+    // Sets the smoothers' targets from the current settings; jump skips the ramp
+    void setRampTargets(bool jump) noexcept;
+
+    double lastSampleRate = 0.0;
+    bool valid = false;
+
+    JUCE_DECLARE_NON_COPYABLE(ParameterSnapshot)
+};
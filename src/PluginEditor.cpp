@@ -2,10 +2,25 @@
 #include "PluginEditor.h"
 
 MakeItHappenOTTEditor::MakeItHappenOTTEditor(MakeItHappenOTTProcessor& p)
-    : AudioProcessorEditor(&p), audioProcessor(p)
+    : AudioProcessorEditor(&p), audioProcessor(p), artwork(p.getEditorArtwork())
 {
-    setSize(600, 560); // Wider for better spacing
+    setSize(EditorArtwork::editorWidth, EditorArtwork::editorHeight);
     setLookAndFeel(&ottLookAndFeel);
+    setOpaque(true);
+
+    // Dynamic layer: band displays first, so the solo buttons stay on top of them
+    for (auto* display : { &highBandDisplay, &highMidBandDisplay, &midBandDisplay, &lowMidBandDisplay, &lowBandDisplay })
+        addAndMakeVisible(display);
+
+    for (auto* readout : { &depthReadout, &timeReadout, &outputRmsReadout, &outputPeakReadout, &inputPeakReadout,
+                           &depthPercentReadout, &upwardReadout, &downwardReadout })
+        addAndMakeVisible(readout);
+
+    // Frames queued while no editor was open are stale
+    audioProcessor.meterFifo.drain([](const MeterFrame&) {});
+
+    // The analyser only runs (and costs the audio thread anything) while an editor is open
+    audioProcessor.analyser.start(30);
 
     // Start timer for UI updates (30 fps)
     startTimerHz(30);
@@ -44,6 +59,43 @@ MakeItHappenOTTEditor::MakeItHappenOTTEditor(MakeItHappenOTTProcessor& p)
     gainMatchAttachment = std::make_unique<juce::AudioProcessorValueTreeState::ButtonAttachment>(
         audioProcessor.apvts, "gainMatch", gainMatchButton);
 
+    // Linked detection toggle
+    linkedDetectionButton.setButtonText("LINK");
+    linkedDetectionButton.setColour(juce::ToggleButton::textColourId, juce::Colour(0xffaaaaaa));
+    linkedDetectionButton.setColour(juce::ToggleButton::tickColourId, juce::Colour(0xff00ff88));
+    linkedDetectionButton.setColour(juce::ToggleButton::tickDisabledColourId, juce::Colour(0xff444444));
+    addAndMakeVisible(linkedDetectionButton);
+    linkedDetectionAttachment = std::make_unique<juce::AudioProcessorValueTreeState::ButtonAttachment>(
+        audioProcessor.apvts, "linkedDetection", linkedDetectionButton);
+
+    // Setup band mode selector (items must exist before the attachment)
+    bandModeBox.addItemList({ "3 BANDS", "4 BANDS", "5 BANDS" }, 1);
+    bandModeBox.setJustificationType(juce::Justification::centred);
+    bandModeBox.setColour(juce::ComboBox::backgroundColourId, juce::Colour(0xff0f0f0f));
+    bandModeBox.setColour(juce::ComboBox::textColourId, juce::Colour(0xffaaaaaa));
+    bandModeBox.setColour(juce::ComboBox::outlineColourId, juce::Colour(0xff333333));
+    addAndMakeVisible(bandModeBox);
+    bandModeAttachment = std::make_unique<juce::AudioProcessorValueTreeState::ComboBoxAttachment>(
+        audioProcessor.apvts, "bandMode", bandModeBox);
+
+    // The band section shows one row per band of the selected mode, whether the
+    // mode comes from the box, automation or a preset
+    bandModeBox.onChange = [this]
+    {
+        resized();
+        repaint();
+    };
+
+    // Crossover selector
+    crossoverModeBox.addItemList({ "ZERO LATENCY", "LINEAR PHASE" }, 1);
+    crossoverModeBox.setJustificationType(juce::Justification::centred);
+    crossoverModeBox.setColour(juce::ComboBox::backgroundColourId, juce::Colour(0xff0f0f0f));
+    crossoverModeBox.setColour(juce::ComboBox::textColourId, juce::Colour(0xffaaaaaa));
+    crossoverModeBox.setColour(juce::ComboBox::outlineColourId, juce::Colour(0xff333333));
+    addAndMakeVisible(crossoverModeBox);
+    crossoverModeAttachment = std::make_unique<juce::AudioProcessorValueTreeState::ComboBoxAttachment>(
+        audioProcessor.apvts, "crossoverMode", crossoverModeBox);
+
     depthLabel.setText("DEPTH", juce::dontSendNotification);
     depthLabel.setJustificationType(juce::Justification::centred);
     depthLabel.setFont(juce::Font(14.0f, juce::Font::bold));
@@ -105,6 +157,34 @@ MakeItHappenOTTEditor::MakeItHappenOTTEditor(MakeItHappenOTTProcessor& p)
     lowSoloAttachment = std::make_unique<juce::AudioProcessorValueTreeState::ButtonAttachment>(
         audioProcessor.apvts, "lowSolo", lowSoloButton);
 
+    // LOW-MID BAND (Teal color); shown in the 4- and 5-band modes
+    setupSlider(lowMidThreshDownSlider, "");
+    lowMidThreshDownSlider.getProperties().set("bandColour", "lowMid");
+    setupSlider(lowMidRatioDownSlider, "");
+    lowMidRatioDownSlider.getProperties().set("bandColour", "lowMid");
+    setupSlider(lowMidThreshUpSlider, "");
+    lowMidThreshUpSlider.getProperties().set("bandColour", "lowMid");
+    setupSlider(lowMidWidthSlider, "");
+    lowMidWidthSlider.getProperties().set("bandColour", "lowMid");
+
+    addAndMakeVisible(lowMidThreshDownSlider);
+    addAndMakeVisible(lowMidRatioDownSlider);
+    addAndMakeVisible(lowMidThreshUpSlider);
+    addAndMakeVisible(lowMidWidthSlider);
+
+    lowMidThreshDownAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(
+        audioProcessor.apvts, "lowMidThreshDown", lowMidThreshDownSlider);
+    lowMidRatioDownAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(
+        audioProcessor.apvts, "lowMidRatioDown", lowMidRatioDownSlider);
+    lowMidThreshUpAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(
+        audioProcessor.apvts, "lowMidThreshUp", lowMidThreshUpSlider);
+    lowMidWidthAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(
+        audioProcessor.apvts, "lowMidWidth", lowMidWidthSlider);
+
+    addAndMakeVisible(lowMidSoloButton);
+    lowMidSoloAttachment = std::make_unique<juce::AudioProcessorValueTreeState::ButtonAttachment>(
+        audioProcessor.apvts, "lowMidSolo", lowMidSoloButton);
+
     // MID BAND (Green color)
     midBandLabel.setText("MID", juce::dontSendNotification);
     midBandLabel.setJustificationType(juce::Justification::centred);
@@ -160,6 +240,34 @@ MakeItHappenOTTEditor::MakeItHappenOTTEditor(MakeItHappenOTTProcessor& p)
     midSoloAttachment = std::make_unique<juce::AudioProcessorValueTreeState::ButtonAttachment>(
         audioProcessor.apvts, "midSolo", midSoloButton);
 
+    // HIGH-MID BAND (Amber color); shown in the 5-band mode
+    setupSlider(highMidThreshDownSlider, "");
+    highMidThreshDownSlider.getProperties().set("bandColour", "highMid");
+    setupSlider(highMidRatioDownSlider, "");
+    highMidRatioDownSlider.getProperties().set("bandColour", "highMid");
+    setupSlider(highMidThreshUpSlider, "");
+    highMidThreshUpSlider.getProperties().set("bandColour", "highMid");
+    setupSlider(highMidWidthSlider, "");
+    highMidWidthSlider.getProperties().set("bandColour", "highMid");
+
+    addAndMakeVisible(highMidThreshDownSlider);
+    addAndMakeVisible(highMidRatioDownSlider);
+    addAndMakeVisible(highMidThreshUpSlider);
+    addAndMakeVisible(highMidWidthSlider);
+
+    highMidThreshDownAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(
+        audioProcessor.apvts, "highMidThreshDown", highMidThreshDownSlider);
+    highMidRatioDownAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(
+        audioProcessor.apvts, "highMidRatioDown", highMidRatioDownSlider);
+    highMidThreshUpAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(
+        audioProcessor.apvts, "highMidThreshUp", highMidThreshUpSlider);
+    highMidWidthAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(
+        audioProcessor.apvts, "highMidWidth", highMidWidthSlider);
+
+    addAndMakeVisible(highMidSoloButton);
+    highMidSoloAttachment = std::make_unique<juce::AudioProcessorValueTreeState::ButtonAttachment>(
+        audioProcessor.apvts, "highMidSolo", highMidSoloButton);
+
     // HIGH BAND (Orange/Red color)
     highBandLabel.setText("HIGH", juce::dontSendNotification);
     highBandLabel.setJustificationType(juce::Justification::centred);
@@ -215,44 +323,195 @@ MakeItHappenOTTEditor::MakeItHappenOTTEditor(MakeItHappenOTTProcessor& p)
     highSoloAttachment = std::make_unique<juce::AudioProcessorValueTreeState::ButtonAttachment>(
         audioProcessor.apvts, "highSolo", highSoloButton);
 
-    // Try to load custom artwork if available
-    // To use custom artwork:
-    // 1. Create a folder called "assets" in the plugin directory
-    // 2. Add a "background.png" file (900x470 pixels recommended)
-    // 3. Add a "knob.png" filmstrip file (64x6400 pixels for 100 frames recommended)
-
-    juce::File assetsFolder = juce::File::getSpecialLocation(juce::File::currentExecutableFile)
-        .getParentDirectory().getChildFile("assets");
-
-    // Try to load background image
-    juce::File bgFile = assetsFolder.getChildFile("background.png");
-    if (bgFile.existsAsFile())
+    // PRESET STRIP (items must exist before the attachments)
+    for (auto* box : { &programBox, &abPresetABox, &abPresetBBox })
     {
-        backgroundImage = juce::ImageCache::getFromFile(bgFile);
+        for (int index = 0; index < audioProcessor.presets.getNumPresets(); ++index)
+            box->addItem(audioProcessor.presets.getName(index), index + 1);
+
+        box->setJustificationType(juce::Justification::centred);
+        box->setColour(juce::ComboBox::backgroundColourId, juce::Colour(0xff0f0f0f));
+        box->setColour(juce::ComboBox::textColourId, juce::Colour(0xffaaaaaa));
+        box->setColour(juce::ComboBox::outlineColourId, juce::Colour(0xff333333));
+        addAndMakeVisible(box);
     }
 
-    // Try to load knob filmstrip
-    juce::File knobFile = assetsFolder.getChildFile("knob.png");
-    if (knobFile.existsAsFile())
+    shownNamesVersion = audioProcessor.presets.getNamesVersion();
+    programBox.setSelectedItemIndex(audioProcessor.getCurrentProgram(), juce::dontSendNotification);
+    programBox.onChange = [this] { audioProcessor.setCurrentProgram(programBox.getSelectedItemIndex()); };
+
+    abPresetAAttachment = std::make_unique<juce::AudioProcessorValueTreeState::ComboBoxAttachment>(
+        audioProcessor.apvts, "abPresetA", abPresetABox);
+    abPresetBAttachment = std::make_unique<juce::AudioProcessorValueTreeState::ComboBoxAttachment>(
+        audioProcessor.apvts, "abPresetB", abPresetBBox);
+
+    storeButton.setButtonText("STORE");
+    storeButton.setColour(juce::TextButton::buttonColourId, juce::Colour(0xff0f0f0f));
+    storeButton.setColour(juce::TextButton::textColourOffId, juce::Colour(0xffaaaaaa));
+    storeButton.onClick = [this] { showStoreDialog(); };
+    addAndMakeVisible(storeButton);
+
+    abMorphButton.setButtonText("A/B");
+    abMorphButton.setColour(juce::ToggleButton::textColourId, juce::Colour(0xffaaaaaa));
+    abMorphButton.setColour(juce::ToggleButton::tickColourId, juce::Colour(0xff00ff88));
+    abMorphButton.setColour(juce::ToggleButton::tickDisabledColourId, juce::Colour(0xff444444));
+    addAndMakeVisible(abMorphButton);
+    abMorphAttachment = std::make_unique<juce::AudioProcessorValueTreeState::ButtonAttachment>(
+        audioProcessor.apvts, "abMorph", abMorphButton);
+
+    // Bars with the value written in them
+    for (auto* slider : { &morphTimeSlider, &abPositionSlider })
     {
-        juce::Image knobImage = juce::ImageCache::getFromFile(knobFile);
-        if (knobImage.isValid())
-        {
-            ottLookAndFeel.setKnobImage(knobImage, 100); // 100 frames
-        }
+        slider->setSliderStyle(juce::Slider::LinearBar);
+        slider->setColour(juce::Slider::backgroundColourId, juce::Colour(0xff0f0f0f));
+        slider->setColour(juce::Slider::trackColourId, juce::Colour(0xff1f4a3a));
+        slider->setColour(juce::Slider::textBoxTextColourId, juce::Colour(0xffcccccc));
+        slider->setColour(juce::Slider::textBoxOutlineColourId, juce::Colour(0xff333333));
+        addAndMakeVisible(slider);
     }
+
+    morphTimeAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(
+        audioProcessor.apvts, "morphTime", morphTimeSlider);
+    abPositionAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(
+        audioProcessor.apvts, "abPosition", abPositionSlider);
+
+    // Embedded artwork, decoded once on a background thread and shared by every
+    // instance; the vector look is drawn until it is ready
+    artwork.addChangeListener(this);
+
+    if (artwork.isReady())
+        applyArtwork();
 }
 
 MakeItHappenOTTEditor::~MakeItHappenOTTEditor()
 {
+    artwork.removeChangeListener(this);
     stopTimer();
+    audioProcessor.analyser.stop();
     setLookAndFeel(nullptr);
 }
 
 void MakeItHappenOTTEditor::timerCallback()
 {
-    // Trigger repaint for real-time meter and spectrum updates
-    repaint();
+    drainMeters();
+    audioProcessor.analyser.getLatestFrame(spectrumFrame);
+
+    // Each readout and band display repaints itself, and only if it changed
+    updateReadouts();
+    updatePresetControls();
+}
+
+void MakeItHappenOTTEditor::updatePresetControls()
+{
+    auto& bank = audioProcessor.presets;
+
+    // Setting the selection again redraws a renamed selected item
+    if (bank.getNamesVersion() != shownNamesVersion)
+    {
+        shownNamesVersion = bank.getNamesVersion();
+
+        for (auto* box : { &programBox, &abPresetABox, &abPresetBBox })
+        {
+            for (int index = 0; index < bank.getNumPresets(); ++index)
+                box->changeItemText(index + 1, bank.getName(index));
+
+            box->setSelectedId(box->getSelectedId(), juce::dontSendNotification);
+        }
+    }
+
+    // The host may change programs too
+    if (programBox.getSelectedItemIndex() != bank.getCurrent())
+        programBox.setSelectedItemIndex(bank.getCurrent(), juce::dontSendNotification);
+}
+
+void MakeItHappenOTTEditor::showStoreDialog()
+{
+    auto& bank = audioProcessor.presets;
+    const int firstUser = PresetBank::getNumFactoryPresets();
+    const int slot = bank.isUserPreset(bank.getCurrent()) ? bank.getCurrent() - firstUser : 0;
+
+    juce::StringArray slots;
+    for (int index = firstUser; index < bank.getNumPresets(); ++index)
+        slots.add(bank.getName(index));
+
+    storeDialog = std::make_unique<juce::AlertWindow>("Store Preset", "Store the current settings as a user preset.",
+                                                      juce::MessageBoxIconType::NoIcon, this);
+    storeDialog->addComboBox("slot", slots, "Slot");
+    storeDialog->addTextEditor("name", bank.getName(firstUser + slot), "Name");
+    storeDialog->addButton("Store", 1, juce::KeyPress(juce::KeyPress::returnKey));
+    storeDialog->addButton("Cancel", 0, juce::KeyPress(juce::KeyPress::escapeKey));
+
+    // Picking a slot offers its name to keep or replace
+    auto* slotBox = storeDialog->getComboBoxComponent("slot");
+    slotBox->setSelectedItemIndex(slot, juce::dontSendNotification);
+    slotBox->onChange = [this, slotBox]
+    {
+        storeDialog->getTextEditor("name")->setText(slotBox->getText());
+    };
+
+    // Closing the editor deletes the dialog, which cancels it
+    storeDialog->enterModalState(true, juce::ModalCallbackFunction::create([this, firstUser](int result)
+    {
+        if (result != 1)
+            return;
+
+        const int index = firstUser + storeDialog->getComboBoxComponent("slot")->getSelectedItemIndex();
+        const auto name = storeDialog->getTextEditorContents("name").trim();
+
+        audioProcessor.storeUserPreset(index, name.isNotEmpty() ? name : audioProcessor.presets.getName(index));
+        updatePresetControls();
+    }));
+}
+
+void MakeItHappenOTTEditor::updateReadouts()
+{
+    const juce::Colour labelColour(0xffaaaaaa), meterColour(0xff00ff88), peakColour(0xff888888), clipColour(0xffff4444);
+
+    depthReadout.setText("DEPTH " + juce::String((int)audioProcessor.depthPercent.load()) + "%", labelColour);
+    timeReadout.setText("TIME " + juce::String((int)audioProcessor.timePercent.load()) + "%", labelColour);
+
+    outputRmsReadout.setText(juce::String(outputRmsDb, 1), meterColour);
+    depthPercentReadout.setText(juce::String((int)audioProcessor.depthPercent.load()), meterColour);
+    outputPeakReadout.setText("PK " + juce::String(outputPeakHold.db, 1), outputPeakHold.db > -0.1f ? clipColour : peakColour);
+    inputPeakReadout.setText("IN " + juce::String(inputPeakHold.db, 1), inputPeakHold.db > -0.1f ? clipColour : peakColour);
+
+    upwardReadout.setText(juce::String((int)audioProcessor.upwardPercent.load()) + "%", juce::Colours::white);
+    downwardReadout.setText(juce::String((int)audioProcessor.downwardPercent.load()) + "%", juce::Colours::white);
+
+    for (const auto& row : getBandRows())
+        if (row.display->isVisible())
+            row.display->update(spectrumFrame.bars[row.slot], bandGainHistory[row.slot], gainHistoryPosition, latestBandGainDb[row.slot]);
+}
+
+void MakeItHappenOTTEditor::drainMeters()
+{
+    // Every block since the last tick, folded into one frame
+    MeterFrame tick;
+    const int numFrames = audioProcessor.meterFifo.drain([&tick](const MeterFrame& frame)
+    {
+        if (tick.numSamples == 0)
+            tick = frame;
+        else
+            tick.merge(frame);
+    });
+
+    const double nowMs = juce::Time::getMillisecondCounterHiRes();
+
+    if (numFrames > 0)
+    {
+        outputRmsDb = juce::Decibels::gainToDecibels(tick.outputRms, -100.0f);
+        std::copy(std::begin(tick.bandGainDb), std::end(tick.bandGainDb), latestBandGainDb);
+    }
+
+    // Without new blocks (transport stopped) the peaks still fall and the gain
+    // history repeats the last value
+    inputPeakHold.update(juce::Decibels::gainToDecibels(tick.inputPeak, -100.0f), nowMs);
+    outputPeakHold.update(juce::Decibels::gainToDecibels(tick.outputPeak, -100.0f), nowMs);
+
+    for (int slot = 0; slot < ParameterSnapshot::numBandSlots; ++slot)
+        bandGainHistory[slot][gainHistoryPosition] = latestBandGainDb[slot];
+
+    gainHistoryPosition = (gainHistoryPosition + 1) % gainHistorySize;
 }
 
 void MakeItHappenOTTEditor::setupSlider(juce::Slider& slider, const juce::String& suffix)
@@ -267,7 +526,29 @@ void MakeItHappenOTTEditor::setupSlider(juce::Slider& slider, const juce::String
 
 void MakeItHappenOTTEditor::paint(juce::Graphics& g)
 {
-    // Draw background image if available, otherwise use dark background
+    // The static layer is rendered at the display's pixel scale, so drawing it
+    // is a plain copy of the dirty region
+    const float scale = g.getInternalContext().getPhysicalPixelScaleFactor();
+
+    if (! staticLayer.isValid() || staticLayerScale != scale)
+    {
+        staticLayer = juce::Image(juce::Image::RGB, juce::jmax(1, juce::roundToInt((float)getWidth() * scale)),
+                                  juce::jmax(1, juce::roundToInt((float)getHeight() * scale)), false);
+
+        juce::Graphics layer(staticLayer);
+        layer.addTransform(juce::AffineTransform::scale(scale));
+        paintStaticLayer(layer, scale);
+        staticLayerScale = scale;
+    }
+
+    g.drawImage(staticLayer, getLocalBounds().toFloat());
+}
+
+void MakeItHappenOTTEditor::paintStaticLayer(juce::Graphics& g, float scale)
+{
+    // Draw background image if available, otherwise use dark background. At 1x
+    // and 2x the artwork is pre-scaled to this size, so this is a copy.
+    const auto backgroundImage = artwork.getBackground(scale);
     if (backgroundImage.isValid())
     {
         g.drawImage(backgroundImage, getLocalBounds().toFloat(),
@@ -278,21 +559,13 @@ void MakeItHappenOTTEditor::paint(juce::Graphics& g)
         g.fillAll(juce::Colour(0xff1a1a1a));
     }
 
-    // === TOP SECTION - Knob labels (under knobs) with values ===
+    // === TOP SECTION - Knob labels (under knobs); DEPTH and TIME are readouts ===
     g.setFont(juce::Font(10.0f, juce::Font::bold));
     g.setColour(juce::Colour(0xffaaaaaa));
 
     int knobLabelY = 85;
     int topSpacing = (getWidth() - (70 * 4)) / 5;
 
-    // DEPTH label with % value
-    float depthVal = audioProcessor.depthPercent.load();
-    g.drawText("DEPTH " + juce::String((int)depthVal) + "%", topSpacing, knobLabelY, 70, 12, juce::Justification::centred);
-
-    // TIME label with % value
-    float timeVal = audioProcessor.timePercent.load();
-    g.drawText("TIME " + juce::String((int)timeVal) + "%", topSpacing * 2 + 70, knobLabelY, 70, 12, juce::Justification::centred);
-
     g.drawText("IN GAIN", topSpacing * 3 + 140, knobLabelY, 70, 12, juce::Justification::centred);
     g.drawText("OUT GAIN", topSpacing * 4 + 210, knobLabelY, 70, 12, juce::Justification::centred);
 
@@ -312,61 +585,29 @@ void MakeItHappenOTTEditor::paint(juce::Graphics& g)
     g.drawText("dB", 20, meterY + 3, 30, 10, juce::Justification::left);
     g.drawText("%", getWidth() - 50, meterY + 3, 30, 10, juce::Justification::left);
 
-    g.setFont(juce::Font(16.0f, juce::Font::bold));
-    g.setColour(juce::Colour(0xff00ff88));
-
-    // Display actual meter values
-    float outputDb = audioProcessor.outputLevelDb.load();
-    float depthPct = audioProcessor.depthPercent.load();
-    g.drawText(juce::String(outputDb, 1), 20, meterY + 12, 80, 15, juce::Justification::left);
-    g.drawText(juce::String((int)depthPct), getWidth() - 50, meterY + 12, 40, 15, juce::Justification::left);
-
-    // === H/M/L BAND SECTION ===
+    // === BAND SECTION, one row per band of the mode, high to low ===
     int bandY = 185;
-    int bandHeight = 75;
+    int rowHeight = bandSectionHeight / numVisibleBands;
 
     // Background
     g.setColour(juce::Colour(0xff0f0f0f));
-    g.fillRect(10, bandY, getWidth() - 20, bandHeight * 3 + 10);
-
-    // Band labels and spectrum displays
-    const juce::Colour bandColors[] = {juce::Colour(0xffff6600), juce::Colour(0xff00ff88), juce::Colour(0xff00d4ff)};
-    const char* bandLabels[] = {"H", "M", "L"};
-    const float bandLevels[] = {audioProcessor.highBandLevel.load(), audioProcessor.midBandLevel.load(), audioProcessor.lowBandLevel.load()};
+    g.fillRect(10, bandY, getWidth() - 20, bandSectionHeight + 10);
 
-    for (int i = 0; i < 3; i++)
+    // Band letters; the spectrum displays are BandDisplay components
+    int row = 0;
+    for (const auto& band : getBandRows())
     {
-        int yPos = bandY + 5 + (i * bandHeight);
+        if (! isSlotVisible(band.slot, numVisibleBands))
+            continue;
 
-        // Band letter
-        g.setFont(juce::Font(14.0f, juce::Font::bold));
-        g.setColour(bandColors[i]);
-        g.drawText(bandLabels[i], 20, yPos + 25, 20, 20, juce::Justification::centred);
+        int rowTop = bandY + row++ * rowHeight;
 
-        // Spectrum display background
-        g.setColour(juce::Colour(0xff0a0a0a));
-        g.fillRect(50, yPos + 5, 180, 60);
-
-        // Spectrum bars - only show if there's actual audio level
-        float level = bandLevels[i];
-        if (level > 0.001f) // Only draw if there's meaningful audio
-        {
-            g.setColour(bandColors[i].withAlpha(0.4f));
-            // Scale level to bar heights (0-50 pixels)
-            int maxBarHeight = (int)(level * 500.0f); // Scale up the level
-            maxBarHeight = juce::jmin(maxBarHeight, 50); // Clamp to max 50px
-
-            for (int x = 0; x < 30; x++)
-            {
-                // Create a pseudo-spectrum effect by varying heights slightly
-                int variation = juce::Random::getSystemRandom().nextInt(10) - 5;
-                int barHeight = juce::jmax(5, juce::jmin(maxBarHeight + variation, 50));
-                g.fillRect(52 + x * 6, yPos + 65 - barHeight, 4, barHeight);
-            }
-        }
+        g.setFont(juce::Font(14.0f, juce::Font::bold));
+        g.setColour(band.colour);
+        g.drawText(band.letter, 16, rowTop + (rowHeight - 20) / 2 + 3, 28, 20, juce::Justification::centred);
     }
 
-    // Draw knob labels above H/M/L section
+    // Draw knob labels above the band section
     g.setFont(juce::Font(8.0f, juce::Font::bold));
     g.setColour(juce::Colour(0xff888888));
     int labelX = 245;
@@ -389,23 +630,44 @@ void MakeItHappenOTTEditor::paint(juce::Graphics& g)
     g.setColour(juce::Colour(0xffff6600));
     g.drawText("DOWNWARD", getWidth() - 150, bottomY + 85, 80, 12, juce::Justification::centred);
 
-    // Value boxes
+    // Value boxes (the values are readouts)
     g.setColour(juce::Colour(0xff0a0a0a));
     g.fillRect(80, bottomY + 100, 60, 22);
     g.fillRect(getWidth() - 140, bottomY + 100, 60, 22);
 
-    g.setFont(juce::Font(13.0f, juce::Font::bold));
-    g.setColour(juce::Colours::white);
+    // === PRESET STRIP ===
+    int presetY = 555;
+
+    g.setColour(juce::Colour(0xff2a2a2a));
+    g.drawLine(10.0f, (float)presetY, (float)(getWidth() - 10), (float)presetY, 1.5f);
+
+    g.setFont(juce::Font(10.0f, juce::Font::bold));
+    g.setColour(juce::Colour(0xffaaaaaa));
+    g.drawText("PRESET", 15, presetY + 10, 55, 20, juce::Justification::centredLeft);
+    g.drawText("MORPH", 315, presetY + 10, 50, 20, juce::Justification::centredLeft);
+}
+
+void MakeItHappenOTTEditor::changeListenerCallback(juce::ChangeBroadcaster*)
+{
+    applyArtwork();
+}
+
+void MakeItHappenOTTEditor::applyArtwork()
+{
+    const auto knobImage = artwork.getKnob();
+    if (knobImage.isValid())
+        ottLookAndFeel.setKnobImage(knobImage, EditorArtwork::knobFrames);
 
-    // Display actual upward/downward percentages
-    float upwardPct = audioProcessor.upwardPercent.load();
-    float downwardPct = audioProcessor.downwardPercent.load();
-    g.drawText(juce::String((int)upwardPct) + "%", 80, bottomY + 100, 60, 22, juce::Justification::centred);
-    g.drawText(juce::String((int)downwardPct) + "%", getWidth() - 140, bottomY + 100, 60, 22, juce::Justification::centred);
+    // The static layer picks the background up when it is rendered again
+    staticLayer = {};
+    repaint();
 }
 
 void MakeItHappenOTTEditor::resized()
 {
+    // Rendered again at the new size on the next paint
+    staticLayer = {};
+
     int knobSize = 55;
     int topKnobSize = 70;
 
@@ -424,45 +686,47 @@ void MakeItHappenOTTEditor::resized()
     inputGainSlider.setTextBoxStyle(juce::Slider::NoTextBox, false, 0, 0);
     outputGainSlider.setTextBoxStyle(juce::Slider::NoTextBox, false, 0, 0);
 
-    // === H/M/L BAND SECTION - 3 knobs per band on right side ===
+    // === BAND SECTION - one row per band of the selected mode, high to low ===
+    // The rows share the section's height; at 3 bands they are 75 px with
+    // full-size knobs, at 4 and 5 the knobs and displays shrink to fit
+    numVisibleBands = MakeItHappenOTTProcessor::bandModeToNumBands(juce::jmax(0, bandModeBox.getSelectedItemIndex()));
+
     int bandY = 185;
-    int bandHeight = 75;
+    int rowHeight = bandSectionHeight / numVisibleBands;
     int bandKnobsX = 245; // Start position for knobs
+    int bandKnobSize = juce::jmin(knobSize, rowHeight - 10);
+    int soloSize = juce::jmin(30, rowHeight - 15);
+    int row = 0;
+
+    for (const auto& band : getBandRows())
+    {
+        juce::Slider* knobs[] = { band.threshDown, band.ratioDown, band.threshUp, band.width };
+        const bool visible = isSlotVisible(band.slot, numVisibleBands);
+
+        for (auto* knob : knobs)
+            knob->setVisible(visible);
+
+        band.solo->setVisible(visible);
+        band.display->setVisible(visible);
+
+        if (! visible)
+            continue;
+
+        int rowTop = bandY + row++ * rowHeight;
+
+        // Knobs centred in the columns the labels above name
+        for (int column = 0; column < 4; ++column)
+        {
+            knobs[column]->setBounds(bandKnobsX + (knobSize + 5) * column + (knobSize - bandKnobSize) / 2,
+                                     rowTop + (rowHeight - bandKnobSize) / 2, bandKnobSize, bandKnobSize);
+            knobs[column]->setTextBoxStyle(juce::Slider::NoTextBox, false, 0, 0);
+        }
 
-    // HIGH BAND (top row)
-    highThreshDownSlider.setBounds(bandKnobsX, bandY + 10, knobSize, knobSize);
-    highRatioDownSlider.setBounds(bandKnobsX + knobSize + 5, bandY + 10, knobSize, knobSize);
-    highThreshUpSlider.setBounds(bandKnobsX + (knobSize + 5) * 2, bandY + 10, knobSize, knobSize);
-    highWidthSlider.setBounds(bandKnobsX + (knobSize + 5) * 3, bandY + 10, knobSize, knobSize);
-    highSoloButton.setBounds(45, bandY + 25, 30, 30);  // More space from left, larger button
-
-    // MID BAND (middle row)
-    midThreshDownSlider.setBounds(bandKnobsX, bandY + bandHeight + 10, knobSize, knobSize);
-    midRatioDownSlider.setBounds(bandKnobsX + knobSize + 5, bandY + bandHeight + 10, knobSize, knobSize);
-    midThreshUpSlider.setBounds(bandKnobsX + (knobSize + 5) * 2, bandY + bandHeight + 10, knobSize, knobSize);
-    midWidthSlider.setBounds(bandKnobsX + (knobSize + 5) * 3, bandY + bandHeight + 10, knobSize, knobSize);
-    midSoloButton.setBounds(45, bandY + bandHeight + 25, 30, 30);
-
-    // LOW BAND (bottom row)
-    lowThreshDownSlider.setBounds(bandKnobsX, bandY + bandHeight * 2 + 10, knobSize, knobSize);
-    lowRatioDownSlider.setBounds(bandKnobsX + knobSize + 5, bandY + bandHeight * 2 + 10, knobSize, knobSize);
-    lowThreshUpSlider.setBounds(bandKnobsX + (knobSize + 5) * 2, bandY + bandHeight * 2 + 10, knobSize, knobSize);
-    lowWidthSlider.setBounds(bandKnobsX + (knobSize + 5) * 3, bandY + bandHeight * 2 + 10, knobSize, knobSize);
-    lowSoloButton.setBounds(45, bandY + bandHeight * 2 + 25, 30, 30);
-
-    // Hide text boxes for band knobs
-    highThreshDownSlider.setTextBoxStyle(juce::Slider::NoTextBox, false, 0, 0);
-    highRatioDownSlider.setTextBoxStyle(juce::Slider::NoTextBox, false, 0, 0);
-    highThreshUpSlider.setTextBoxStyle(juce::Slider::NoTextBox, false, 0, 0);
-    highWidthSlider.setTextBoxStyle(juce::Slider::NoTextBox, false, 0, 0);
-    midThreshDownSlider.setTextBoxStyle(juce::Slider::NoTextBox, false, 0, 0);
-    midRatioDownSlider.setTextBoxStyle(juce::Slider::NoTextBox, false, 0, 0);
-    midThreshUpSlider.setTextBoxStyle(juce::Slider::NoTextBox, false, 0, 0);
-    midWidthSlider.setTextBoxStyle(juce::Slider::NoTextBox, false, 0, 0);
-    lowThreshDownSlider.setTextBoxStyle(juce::Slider::NoTextBox, false, 0, 0);
-    lowRatioDownSlider.setTextBoxStyle(juce::Slider::NoTextBox, false, 0, 0);
-    lowThreshUpSlider.setTextBoxStyle(juce::Slider::NoTextBox, false, 0, 0);
-    lowWidthSlider.setTextBoxStyle(juce::Slider::NoTextBox, false, 0, 0);
+        band.solo->setBounds(45, rowTop + (rowHeight - soloSize) / 2 + 3, soloSize, soloSize);
+
+        // Spectrum/gain display
+        band.display->setBounds(50, rowTop + 10, 180, rowHeight - 15);
+    }
 
     // === BOTTOM SECTION - UPWARD and DOWNWARD knobs ===
     int bottomY = 430;
@@ -491,4 +755,60 @@ void MakeItHappenOTTEditor::resized()
     int buttonHeight = 24;
     int buttonX = (getWidth() - buttonWidth) / 2;
     gainMatchButton.setBounds(buttonX, bottomY + 45, buttonWidth, buttonHeight);
+    linkedDetectionButton.setBounds(buttonX + 20, bottomY + 45 + buttonHeight, 60, buttonHeight);
+
+    // Band mode and crossover selectors in the middle of the meter strip
+    bandModeBox.setBounds(getWidth() / 2 - 115, 145, 100, 20);
+    crossoverModeBox.setBounds(getWidth() / 2 + 5, 145, 110, 20);
+
+    // Readouts over the static layer
+    int meterY = 140;
+    depthReadout.setBounds(topSpacing, 85, topKnobSize, 12);
+    timeReadout.setBounds(topSpacing * 2 + topKnobSize, 85, topKnobSize, 12);
+    outputRmsReadout.setBounds(20, meterY + 12, 70, 15);
+    outputPeakReadout.setBounds(90, meterY + 14, 70, 12);
+    inputPeakReadout.setBounds(getWidth() - 140, meterY + 14, 70, 12);
+    depthPercentReadout.setBounds(getWidth() - 50, meterY + 12, 40, 15);
+    int valueBoxY = 520; // the static layer's value boxes
+    upwardReadout.setBounds(80, valueBoxY, 60, 22);
+    downwardReadout.setBounds(getWidth() - 140, valueBoxY, 60, 22);
+
+    // === PRESET STRIP - program and glide, then the A/B morph ===
+    int presetY = 565;
+    int abY = presetY + 27;
+
+    programBox.setBounds(70, presetY, 170, 20);
+    storeButton.setBounds(245, presetY, 60, 20);
+    morphTimeSlider.setBounds(370, presetY, 210, 20);
+
+    abMorphButton.setBounds(12, abY, 58, 20);
+    abPresetABox.setBounds(70, abY, 170, 20);
+    abPositionSlider.setBounds(245, abY, 160, 20);
+    abPresetBBox.setBounds(410, abY, 170, 20);
+}
+
+std::array<MakeItHappenOTTEditor::BandRow, ParameterSnapshot::numBandSlots> MakeItHappenOTTEditor::getBandRows()
+{
+    return { { { ParameterSnapshot::highSlot, "H", juce::Colour(0xffff6600), &highThreshDownSlider, &highRatioDownSlider,
+                 &highThreshUpSlider, &highWidthSlider, &highSoloButton, &highBandDisplay },
+               { ParameterSnapshot::highMidSlot, "HM", juce::Colour(0xffffc400), &highMidThreshDownSlider, &highMidRatioDownSlider,
+                 &highMidThreshUpSlider, &highMidWidthSlider, &highMidSoloButton, &highMidBandDisplay },
+               { ParameterSnapshot::midSlot, "M", juce::Colour(0xff00ff88), &midThreshDownSlider, &midRatioDownSlider,
+                 &midThreshUpSlider, &midWidthSlider, &midSoloButton, &midBandDisplay },
+               { ParameterSnapshot::lowMidSlot, "LM", juce::Colour(0xff00e8c0), &lowMidThreshDownSlider, &lowMidRatioDownSlider,
+                 &lowMidThreshUpSlider, &lowMidWidthSlider, &lowMidSoloButton, &lowMidBandDisplay },
+               { ParameterSnapshot::lowSlot, "L", juce::Colour(0xff00d4ff), &lowThreshDownSlider, &lowRatioDownSlider,
+                 &lowThreshUpSlider, &lowWidthSlider, &lowSoloButton, &lowBandDisplay } } };
+}
+
+bool MakeItHappenOTTEditor::isSlotVisible(int slot, int numBands) noexcept
+{
+    // 4 bands add lowMid to low/mid/high, 5 add highMid too (BandLayout in BandEngine.h)
+    if (slot == ParameterSnapshot::lowMidSlot)
+        return numBands >= 4;
+
+    if (slot == ParameterSnapshot::highMidSlot)
+        return numBands >= 5;
+
+    return true;
 }
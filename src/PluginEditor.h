@@ -1,5 +1,9 @@
 #pragma once
 #include "PluginProcessor.h"
+#include "EditorArtwork.h"
+#include <array>
+#include <map>
+#include <tuple>
 
 // Custom Solo Button Component with vector "S"
 class SoloButton : public juce::ToggleButton
@@ -47,9 +51,17 @@ private:
 };
 
 // Custom LookAndFeel for OTT-style interface
+//
+// Knobs are drawn from a cache of frames pre-rendered at the knob's size and the
+// display's pixel scale, so a knob repaint is a plain image copy. Filmstrip
+// frames are resampled once; the vector knob is rendered once per position step
+// (vectorKnobFrames of them over the rotary range). Frames are made on first use.
 class OTTLookAndFeel : public juce::LookAndFeel_V4
 {
 public:
+    // Position steps of the vector knob; its value arc moves by under a pixel per step
+    static constexpr int vectorKnobFrames = 128;
+
     OTTLookAndFeel()
     {
         setColour(juce::Slider::thumbColourId, juce::Colour(0xffcccccc));
@@ -66,76 +78,289 @@ public:
     {
         knobFilmStrip = image;
         filmStripFrames = numFrames;
+        knobCache.clear();
     }
 
     void drawRotarySlider(juce::Graphics& g, int x, int y, int width, int height,
                          float sliderPosProportional, float rotaryStartAngle,
                          float rotaryEndAngle, juce::Slider& slider) override
     {
-        // If we have a filmstrip image, use it
-        if (knobFilmStrip.isValid() && filmStripFrames > 0)
+        if (width <= 0 || height <= 0)
+            return;
+
+        const bool useFilmStrip = knobFilmStrip.isValid() && filmStripFrames > 0;
+        const float scale = g.getInternalContext().getPhysicalPixelScaleFactor();
+
+        // The filmstrip ignores the band colour
+        const auto arcColour = useFilmStrip ? juce::Colour() : getArcColour(slider);
+
+        const KnobKey key { width, height, juce::roundToInt(scale * 100.0f), arcColour.getARGB(),
+                            rotaryStartAngle, rotaryEndAngle };
+        auto& knob = getKnobFrames(key, useFilmStrip ? filmStripFrames : vectorKnobFrames);
+
+        const int numFrames = (int)knob.frames.size();
+        const int frameIndex = useFilmStrip ? (int)(sliderPosProportional * (numFrames - 1))
+                                            : juce::roundToInt(sliderPosProportional * (numFrames - 1));
+        auto& frame = knob.frames[(size_t)juce::jlimit(0, numFrames - 1, frameIndex)];
+
+        if (! frame.isValid())
+            frame = useFilmStrip ? renderFilmStripFrame(key, frameIndex, scale)
+                                 : renderVectorFrame(key, knob, frameIndex, scale);
+
+        // The frame has the destination's physical size, so this is a copy
+        g.drawImage(frame, juce::Rectangle<int>(x, y, width, height).toFloat());
+    }
+
+private:
+    juce::Image knobFilmStrip;
+    int filmStripFrames = 0;
+
+    // Knob look for one size and scale: pixel size, scale in hundredths, arc colour, range
+    struct KnobKey
+    {
+        int width, height, scaleHundredths;
+        juce::uint32 colour;
+        float startAngle, endAngle;
+
+        bool operator<(const KnobKey& other) const
         {
-            const int frameIndex = (int)(sliderPosProportional * (filmStripFrames - 1));
-            const int frameHeight = knobFilmStrip.getHeight() / filmStripFrames;
-            const int frameWidth = knobFilmStrip.getWidth();
-
-            g.drawImage(knobFilmStrip,
-                       x, y, width, height,
-                       0, frameIndex * frameHeight,
-                       frameWidth, frameHeight);
+            return std::tie(width, height, scaleHundredths, colour, startAngle, endAngle)
+                 < std::tie(other.width, other.height, other.scaleHundredths, other.colour, other.startAngle, other.endAngle);
         }
-        else
+    };
+
+    struct KnobFrames
+    {
+        std::vector<juce::Image> frames; // invalid until first drawn
+        juce::Path pointer;              // vector knob: pointer at angle 0, around the centre
+    };
+
+    // A resizable editor would add a size per drag step; a few dozen looks is
+    // more than one editor uses, so the cache simply starts over past that
+    static constexpr size_t maxCachedLooks = 32;
+    std::map<KnobKey, KnobFrames> knobCache;
+
+    static juce::Colour getArcColour(juce::Slider& slider)
+    {
+        auto bandColour = slider.getProperties()["bandColour"].toString();
+        if (bandColour == "low") return juce::Colour(0xff00d4ff);
+        if (bandColour == "lowMid") return juce::Colour(0xff00e8c0);
+        if (bandColour == "mid") return juce::Colour(0xff00ff88);
+        if (bandColour == "highMid") return juce::Colour(0xffffc400);
+        if (bandColour == "high") return juce::Colour(0xffff6600);
+        return juce::Colour(0xff4a9eff); // Default blue
+    }
+
+    static float getRadius(int width, int height) { return (float)juce::jmin(width / 2, height / 2) - 8.0f; }
+
+    KnobFrames& getKnobFrames(const KnobKey& key, int numFrames)
+    {
+        auto found = knobCache.find(key);
+        if (found != knobCache.end())
+            return found->second;
+
+        if (knobCache.size() >= maxCachedLooks)
+            knobCache.clear();
+
+        auto& knob = knobCache[key];
+        knob.frames.resize((size_t)numFrames);
+
+        // Pointer geometry depends only on the size; frames rotate it into place
+        const auto radius = getRadius(key.width, key.height);
+        const auto pointerThickness = 3.0f;
+        knob.pointer.addRectangle(-pointerThickness * 0.5f, -radius * 0.65f, pointerThickness, radius * 0.5f);
+        return knob;
+    }
+
+    juce::Image renderFilmStripFrame(const KnobKey& key, int frameIndex, float scale) const
+    {
+        const int frameHeight = knobFilmStrip.getHeight() / filmStripFrames;
+        const auto source = knobFilmStrip.getClippedImage({ 0, frameIndex * frameHeight, knobFilmStrip.getWidth(), frameHeight });
+
+        return source.rescaled(juce::jmax(1, juce::roundToInt((float)key.width * scale)),
+                               juce::jmax(1, juce::roundToInt((float)key.height * scale)),
+                               juce::Graphics::highResamplingQuality);
+    }
+
+    juce::Image renderVectorFrame(const KnobKey& key, const KnobFrames& knob, int frameIndex, float scale) const
+    {
+        juce::Image image(juce::Image::ARGB, juce::jmax(1, juce::roundToInt((float)key.width * scale)),
+                          juce::jmax(1, juce::roundToInt((float)key.height * scale)), true);
+        juce::Graphics g(image);
+        g.addTransform(juce::AffineTransform::scale(scale));
+
+        const float position = (float)frameIndex / (float)(knob.frames.size() - 1);
+
+        auto radius = getRadius(key.width, key.height);
+        auto centreX = (float)key.width * 0.5f;
+        auto centreY = (float)key.height * 0.5f;
+        auto rx = centreX - radius;
+        auto ry = centreY - radius;
+        auto rw = radius * 2.0f;
+        auto angle = key.startAngle + position * (key.endAngle - key.startAngle);
+
+        // Draw outer ring
+        g.setColour(juce::Colour(0xff2a2a2a));
+        g.fillEllipse(rx, ry, rw, rw);
+
+        // Draw inner circle
+        auto innerRadius = radius * 0.75f;
+        g.setColour(juce::Colour(0xff1a1a1a));
+        g.fillEllipse(centreX - innerRadius, centreY - innerRadius, innerRadius * 2.0f, innerRadius * 2.0f);
+
+        // Draw arc for value
+        juce::Path valueArc;
+        valueArc.addCentredArc(centreX, centreY, radius * 0.85f, radius * 0.85f,
+                              0.0f, key.startAngle, angle, true);
+
+        g.setColour(juce::Colour(key.colour));
+        g.strokePath(valueArc, juce::PathStrokeType(3.5f));
+
+        // Draw pointer
+        g.setColour(juce::Colours::white);
+        g.fillPath(knob.pointer, juce::AffineTransform::rotation(angle).translated(centreX, centreY));
+
+        return image;
+    }
+};
+
+// Peak meter value that holds its maximum for a while, then falls at a fixed rate
+struct PeakHold
+{
+    static constexpr double holdMs = 1500.0;
+    static constexpr float fallDbPerSecond = 20.0f;
+
+    float db = -100.0f;
+    double heldSinceMs = 0.0;
+    double lastUpdateMs = 0.0;
+
+    void update(float newDb, double nowMs)
+    {
+        if (newDb >= db)
+        {
+            db = newDb;
+            heldSinceMs = nowMs;
+        }
+        else if (nowMs - heldSinceMs > holdMs)
+        {
+            db = juce::jmax(newDb, db - fallDbPerSecond * (float)((nowMs - lastUpdateMs) * 0.001));
+        }
+
+        lastUpdateMs = nowMs;
+    }
+};
+
+// Text readout that repaints only its own bounds, and only when its text or
+// colour actually changes. Drawn over the editor's cached static layer.
+class ReadoutLabel : public juce::Component
+{
+public:
+    ReadoutLabel(juce::Font font, juce::Justification justification)
+        : font(font), justification(justification)
+    {
+        setInterceptsMouseClicks(false, false);
+    }
+
+    void setText(const juce::String& newText, juce::Colour newColour)
+    {
+        if (newText == text && newColour == colour)
+            return;
+
+        text = newText;
+        colour = newColour;
+        repaint();
+    }
+
+    void paint(juce::Graphics& g) override
+    {
+        g.setFont(font);
+        g.setColour(colour);
+        g.drawText(text, getLocalBounds(), justification);
+    }
+
+private:
+    juce::Font font;
+    juce::Justification justification;
+    juce::String text;
+    juce::Colour colour;
+};
+
+// One band's spectrum bars and gain trace (0 dB in the middle, +-24 dB at the
+// edges). update() quantises everything to what would be drawn and repaints
+// only if that changed, so a silent or steady band costs nothing.
+class BandDisplay : public juce::Component
+{
+public:
+    static constexpr int historySize = 90; // 3 s of timer ticks at 30 Hz
+
+    explicit BandDisplay(juce::Colour colour) : colour(colour)
+    {
+        setOpaque(true);
+        setInterceptsMouseClicks(false, false);
+    }
+
+    // bars: SpectrumAnalyser::numBars values 0-1. history: a ring of historySize
+    // gains in dB whose oldest entry is at historyPosition.
+    void update(const float* bars, const float* history, int historyPosition, float gainDb)
+    {
+        bool changed = false;
+        const float height = (float)getHeight();
+
+        for (int x = 0; x < SpectrumAnalyser::numBars; ++x)
+        {
+            const int barHeight = juce::roundToInt(bars[x] * (height - 10.0f));
+            changed = changed || barHeight != barHeights[x];
+            barHeights[x] = barHeight;
+        }
+
+        for (int x = 0; x < historySize; ++x)
         {
-            // Otherwise draw the custom knob
-            auto radius = (float)juce::jmin(width / 2, height / 2) - 8.0f;
-            auto centreX = (float)x + (float)width * 0.5f;
-            auto centreY = (float)y + (float)height * 0.5f;
-            auto rx = centreX - radius;
-            auto ry = centreY - radius;
-            auto rw = radius * 2.0f;
-            auto angle = rotaryStartAngle + sliderPosProportional * (rotaryEndAngle - rotaryStartAngle);
-
-            // Draw outer ring
-            g.setColour(juce::Colour(0xff2a2a2a));
-            g.fillEllipse(rx, ry, rw, rw);
-
-            // Draw inner circle
-            auto innerRadius = radius * 0.75f;
-            g.setColour(juce::Colour(0xff1a1a1a));
-            g.fillEllipse(centreX - innerRadius, centreY - innerRadius, innerRadius * 2.0f, innerRadius * 2.0f);
-
-            // Draw arc for value
-            juce::Path valueArc;
-            valueArc.addCentredArc(centreX, centreY, radius * 0.85f, radius * 0.85f,
-                                  0.0f, rotaryStartAngle, angle, true);
-
-            auto bandColour = slider.getProperties()["bandColour"].toString();
-            juce::Colour arcColour = juce::Colour(0xff4a9eff); // Default blue
-            if (bandColour == "low") arcColour = juce::Colour(0xff00d4ff);
-            else if (bandColour == "mid") arcColour = juce::Colour(0xff00ff88);
-            else if (bandColour == "high") arcColour = juce::Colour(0xffff6600);
-
-            g.setColour(arcColour);
-            g.strokePath(valueArc, juce::PathStrokeType(3.5f));
-
-            // Draw pointer
-            juce::Path pointer;
-            auto pointerLength = radius * 0.5f;
-            auto pointerThickness = 3.0f;
-            pointer.addRectangle(-pointerThickness * 0.5f, -radius * 0.65f, pointerThickness, pointerLength);
-            pointer.applyTransform(juce::AffineTransform::rotation(angle).translated(centreX, centreY));
-            g.setColour(juce::Colours::white);
-            g.fillPath(pointer);
+            const float db = juce::jlimit(-24.0f, 24.0f, history[(historyPosition + x) % historySize]);
+            const float y = std::round((height * 0.5f - db * (height * 0.5f / 24.0f)) * 2.0f) * 0.5f; // half pixels
+            changed = changed || y != traceY[x];
+            traceY[x] = y;
         }
+
+        const auto text = juce::String(gainDb, 1) + " dB";
+        changed = changed || text != gainText;
+        gainText = text;
+
+        if (changed)
+            repaint();
+    }
+
+    void paint(juce::Graphics& g) override
+    {
+        g.fillAll(juce::Colour(0xff0a0a0a));
+
+        g.setColour(colour.withAlpha(0.4f));
+        for (int x = 0; x < SpectrumAnalyser::numBars; ++x)
+            if (barHeights[x] > 0)
+                g.fillRect(2 + x * 6, getHeight() - barHeights[x], 4, barHeights[x]);
+
+        juce::Path trace;
+        const float step = (float)getWidth() / (float)(historySize - 1);
+        trace.startNewSubPath(0.0f, traceY[0]);
+        for (int x = 1; x < historySize; ++x)
+            trace.lineTo(step * (float)x, traceY[x]);
+
+        g.setColour(colour);
+        g.strokePath(trace, juce::PathStrokeType(1.5f));
+
+        g.setFont(juce::Font(9.0f, juce::Font::bold));
+        g.drawText(gainText, getWidth() - 50, 1, 48, 10, juce::Justification::right);
     }
 
 private:
-    juce::Image knobFilmStrip;
-    int filmStripFrames = 0;
+    juce::Colour colour;
+    int barHeights[SpectrumAnalyser::numBars] = {};
+    float traceY[historySize] = {};
+    juce::String gainText;
 };
 
 class MakeItHappenOTTEditor : public juce::AudioProcessorEditor,
-                               private juce::Timer
+                               private juce::Timer,
+                               private juce::ChangeListener
 {
 public:
     MakeItHappenOTTEditor(MakeItHappenOTTProcessor&);
@@ -149,8 +374,56 @@ private:
     MakeItHappenOTTProcessor& audioProcessor;
     OTTLookAndFeel ottLookAndFeel;
 
-    // Optional background image (can be loaded from resources or file)
-    juce::Image backgroundImage;
+    // Embedded background and knob filmstrip, if the build has them; owned
+    // through the processor
+    EditorArtwork& artwork;
+
+    // Takes the artwork once it is decoded: sets the knob filmstrip and renders
+    // the static layer again
+    void applyArtwork();
+    void changeListenerCallback(juce::ChangeBroadcaster*) override;
+
+    // Background, labels, dividers and boxes: everything paint() draws, rendered
+    // once per size and display scale. Values that change are child components.
+    juce::Image staticLayer;
+    float staticLayerScale = 0.0f;
+
+    void paintStaticLayer(juce::Graphics& g, float scale);
+
+    // Dynamic readouts and band displays, updated from timerCallback
+    ReadoutLabel depthReadout { juce::Font(10.0f, juce::Font::bold), juce::Justification::centred };
+    ReadoutLabel timeReadout { juce::Font(10.0f, juce::Font::bold), juce::Justification::centred };
+    ReadoutLabel outputRmsReadout { juce::Font(16.0f, juce::Font::bold), juce::Justification::left };
+    ReadoutLabel outputPeakReadout { juce::Font(9.0f, juce::Font::bold), juce::Justification::left };
+    ReadoutLabel inputPeakReadout { juce::Font(9.0f, juce::Font::bold), juce::Justification::left };
+    ReadoutLabel depthPercentReadout { juce::Font(16.0f, juce::Font::bold), juce::Justification::left };
+    ReadoutLabel upwardReadout { juce::Font(13.0f, juce::Font::bold), juce::Justification::centred };
+    ReadoutLabel downwardReadout { juce::Font(13.0f, juce::Font::bold), juce::Justification::centred };
+
+    // High to low, top to bottom; highMid and lowMid only in the modes that use them
+    BandDisplay highBandDisplay { juce::Colour(0xffff6600) };
+    BandDisplay highMidBandDisplay { juce::Colour(0xffffc400) };
+    BandDisplay midBandDisplay { juce::Colour(0xff00ff88) };
+    BandDisplay lowMidBandDisplay { juce::Colour(0xff00e8c0) };
+    BandDisplay lowBandDisplay { juce::Colour(0xff00d4ff) };
+
+    void updateReadouts();
+
+    // Meter state, fed from the processor's MeterFifo on every timer tick
+    PeakHold inputPeakHold, outputPeakHold;
+    float outputRmsDb = -100.0f;
+
+    // Latest spectrum bars from the processor's analyser
+    SpectrumAnalyser::Frame spectrumFrame;
+
+    // Band gain per timer tick (the largest excursion of the tick's blocks), as a ring
+    static constexpr int gainHistorySize = BandDisplay::historySize;
+    float bandGainHistory[ParameterSnapshot::numBandSlots][gainHistorySize] = {};
+    float latestBandGainDb[ParameterSnapshot::numBandSlots] = {};
+    int gainHistoryPosition = 0;
+
+    // Reads every queued meter frame into the state above
+    void drainMeters();
 
     // Global controls (top 4 knobs)
     juce::Slider depthSlider;
@@ -163,18 +436,61 @@ private:
     juce::ToggleButton gainMatchButton;
     std::unique_ptr<juce::AudioProcessorValueTreeState::ButtonAttachment> gainMatchAttachment;
 
+    // Linked detection toggle (one detector per stereo pair)
+    juce::ToggleButton linkedDetectionButton;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::ButtonAttachment> linkedDetectionAttachment;
+
+    // Band mode selector (3/4/5 bands)
+    juce::ComboBox bandModeBox;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::ComboBoxAttachment> bandModeAttachment;
+
+    // Crossover selector (zero latency IIR / linear phase)
+    juce::ComboBox crossoverModeBox;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::ComboBoxAttachment> crossoverModeAttachment;
+
+    // Preset strip: the host's programs, storing into a user preset, the
+    // program change glide and the A/B morph
+    juce::ComboBox programBox;
+    juce::TextButton storeButton;
+    juce::Slider morphTimeSlider;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> morphTimeAttachment;
+
+    juce::ToggleButton abMorphButton;
+    juce::ComboBox abPresetABox, abPresetBBox;
+    juce::Slider abPositionSlider;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::ButtonAttachment> abMorphAttachment;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::ComboBoxAttachment> abPresetAAttachment, abPresetBAttachment;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> abPositionAttachment;
+
+    // Asks for a user preset slot and name, then stores the current settings
+    std::unique_ptr<juce::AlertWindow> storeDialog;
+    void showStoreDialog();
+
+    // Follows renamed presets and program changes from the host; the bank's
+    // names version the boxes were last filled from
+    int shownNamesVersion = -1;
+    void updatePresetControls();
+
     // Low band controls
     juce::Slider lowThreshDownSlider, lowRatioDownSlider, lowThreshUpSlider, lowRatioUpSlider;
     juce::Slider lowAttackSlider, lowReleaseSlider, lowGainSlider, lowWidthSlider;
     SoloButton lowSoloButton{juce::Colour(0xff00d4ff)};  // Cyan
     juce::Label lowBandLabel;
 
+    // Low-mid band controls (4 and 5 bands)
+    juce::Slider lowMidThreshDownSlider, lowMidRatioDownSlider, lowMidThreshUpSlider, lowMidWidthSlider;
+    SoloButton lowMidSoloButton{juce::Colour(0xff00e8c0)};  // Teal
+
     // Mid band controls
     juce::Slider midThreshDownSlider, midRatioDownSlider, midThreshUpSlider, midRatioUpSlider;
     juce::Slider midAttackSlider, midReleaseSlider, midGainSlider, midWidthSlider;
     SoloButton midSoloButton{juce::Colour(0xff00ff88)};  // Green
     juce::Label midBandLabel;
 
+    // High-mid band controls (5 bands)
+    juce::Slider highMidThreshDownSlider, highMidRatioDownSlider, highMidThreshUpSlider, highMidWidthSlider;
+    SoloButton highMidSoloButton{juce::Colour(0xffffc400)};  // Amber
+
     // High band controls
     juce::Slider highThreshDownSlider, highRatioDownSlider, highThreshUpSlider, highRatioUpSlider;
     juce::Slider highAttackSlider, highReleaseSlider, highGainSlider, highWidthSlider;
@@ -197,6 +513,12 @@ private:
     std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> lowWidthAttachment;
     std::unique_ptr<juce::AudioProcessorValueTreeState::ButtonAttachment> lowSoloAttachment;
 
+    std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> lowMidThreshDownAttachment;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> lowMidRatioDownAttachment;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> lowMidThreshUpAttachment;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> lowMidWidthAttachment;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::ButtonAttachment> lowMidSoloAttachment;
+
     std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> midThreshDownAttachment;
     std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> midRatioDownAttachment;
     std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> midThreshUpAttachment;
@@ -207,6 +529,12 @@ private:
     std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> midWidthAttachment;
     std::unique_ptr<juce::AudioProcessorValueTreeState::ButtonAttachment> midSoloAttachment;
 
+    std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> highMidThreshDownAttachment;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> highMidRatioDownAttachment;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> highMidThreshUpAttachment;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> highMidWidthAttachment;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::ButtonAttachment> highMidSoloAttachment;
+
     std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> highThreshDownAttachment;
     std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> highRatioDownAttachment;
     std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> highThreshUpAttachment;
@@ -220,5 +548,30 @@ private:
     // Helper function to setup sliders
     void setupSlider(juce::Slider& slider, const juce::String& suffix);
 
+    // One row of the band section: what resized() places for a band
+    struct BandRow
+    {
+        int slot;
+        const char* letter;
+        juce::Colour colour;
+        juce::Slider* threshDown;
+        juce::Slider* ratioDown;
+        juce::Slider* threshUp;
+        juce::Slider* width;
+        SoloButton* solo;
+        BandDisplay* display;
+    };
+
+    // Every row, high to low
+    std::array<BandRow, ParameterSnapshot::numBandSlots> getBandRows();
+
+    // Bands of the selected "bandMode", as last laid out; the rows share the
+    // band section's height (three 75 px rows)
+    int numVisibleBands = 3;
+    static constexpr int bandSectionHeight = 225;
+
+    // Whether the row for slot is shown with numBands bands
+    static bool isSlotVisible(int slot, int numBands) noexcept;
+
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(MakeItHappenOTTEditor)
 };
@@ -1,5 +1,83 @@
 #include "PluginProcessor.h"
 #include "PluginEditor.h"
+#include "AudioThreadGuard.h"
+
+namespace
+{
+    // Peak and RMS of the loudest channels, in one pass per channel
+    template <typename SampleType>
+    void measureLevels(const juce::AudioBuffer<SampleType>& buffer, int numChannels, float& peak, float& rms) noexcept
+    {
+        const int numSamples = buffer.getNumSamples();
+        SampleType maxSumOfSquares = 0, maxPeak = 0;
+
+        for (int ch = 0; ch < numChannels; ++ch)
+        {
+            const SampleType* data = buffer.getReadPointer(ch);
+            SampleType channelPeak = 0, sumOfSquares = 0;
+
+            for (int i = 0; i < numSamples; ++i)
+            {
+                channelPeak = juce::jmax(channelPeak, std::abs(data[i]));
+                sumOfSquares += data[i] * data[i];
+            }
+
+            maxPeak = juce::jmax(maxPeak, channelPeak);
+            maxSumOfSquares = juce::jmax(maxSumOfSquares, sumOfSquares);
+        }
+
+        peak = (float)maxPeak;
+        rms = numSamples > 0 ? (float)std::sqrt(maxSumOfSquares / (SampleType)numSamples) : 0.0f;
+    }
+
+    // Index of the first sample above threshold in any of the first numChannels
+    // channels, or the buffer's length if there is none
+    template <typename SampleType>
+    int findFirstAbove(const juce::AudioBuffer<SampleType>& buffer, int numChannels, SampleType threshold) noexcept
+    {
+        int first = buffer.getNumSamples();
+
+        for (int ch = 0; ch < numChannels; ++ch)
+        {
+            const SampleType* data = buffer.getReadPointer(ch);
+
+            for (int i = 0; i < first; ++i)
+            {
+                if (std::abs(data[i]) > threshold)
+                {
+                    first = i;
+                    break;
+                }
+            }
+        }
+
+        return first;
+    }
+
+    // Multiplies the first numChannels channels by ramp[i], or by gain if there is no ramp
+    template <typename SampleType>
+    void applyGain(juce::AudioBuffer<SampleType>& buffer, int numChannels, const float* ramp, float gain) noexcept
+    {
+        if (ramp == nullptr)
+        {
+            for (int ch = 0; ch < numChannels; ++ch)
+                buffer.applyGain(ch, 0, buffer.getNumSamples(), (SampleType)gain);
+
+            return;
+        }
+
+        for (int ch = 0; ch < numChannels; ++ch)
+        {
+            SampleType* data = buffer.getWritePointer(ch);
+
+            if constexpr (std::is_same_v<SampleType, float>)
+                juce::FloatVectorOperations::multiply(data, ramp, buffer.getNumSamples());
+            else
+                for (int i = 0; i < buffer.getNumSamples(); ++i)
+                    data[i] *= (SampleType)ramp[i];
+        }
+    }
+}
 
 MakeItHappenOTTProcessor::MakeItHappenOTTProcessor()
     : AudioProcessor(BusesProperties()
@@ -10,12 +88,23 @@ MakeItHappenOTTProcessor::MakeItHappenOTTProcessor()
           .withOutput("Output", juce::AudioChannelSet::stereo(), true)
 #endif
       ),
-      apvts(*this, nullptr, "Parameters", createParameterLayout())
+      apvts(*this, nullptr, "Parameters", createParameterLayout()),
+      parameters(apvts, presets)
 {
+    apvts.addParameterListener("crossoverMode", this);
+    apvts.addParameterListener("lookahead", this);
+
+    startTimer(pollIntervalMs);
 }
 
 MakeItHappenOTTProcessor::~MakeItHappenOTTProcessor()
 {
+    apvts.removeParameterListener("crossoverMode", this);
+    apvts.removeParameterListener("lookahead", this);
+    kernelBuilder.removeAllJobs(true, -1);
+
+    // Offline tools destroy instances on worker threads, with no message loop
+    stopTimer();
 }
 
 const juce::String MakeItHappenOTTProcessor::getName() const
@@ -52,74 +141,290 @@ bool MakeItHappenOTTProcessor::isMidiEffect() const
 
 double MakeItHappenOTTProcessor::getTailLengthSeconds() const
 {
-    return 0.0;
+    // The envelopes releasing from full scale to the silence threshold, after the
+    // crossover and lookahead delay
+    const double sampleRate = getSampleRate();
+    const double latencySeconds = sampleRate > 0.0 ? getLatencySamples() / sampleRate : 0.0;
+
+    return parameters.getReleaseTailSeconds(-silenceThresholdDb) + latencySeconds;
 }
 
 int MakeItHappenOTTProcessor::getNumPrograms()
 {
-    return 1;
+    return presets.getNumPresets();
 }
 
 int MakeItHappenOTTProcessor::getCurrentProgram()
 {
-    return 0;
+    return presets.getCurrent();
 }
 
 void MakeItHappenOTTProcessor::setCurrentProgram(int index)
 {
-    juce::ignoreUnused(index);
+    // Hosts may call this from the audio thread. The snapshot glides to the
+    // preset's row over "morphTime" from the next block; the parameters are set
+    // to it on the message thread, now if this is it, else at the next poll.
+    // Nothing here locks, allocates or posts a message.
+    if (! juce::isPositiveAndBelow(index, presets.getNumPresets()))
+        return;
+
+    presets.setCurrent(index);
+    parameters.startMorph();
+    parameters.followPreset(index);
+    pendingProgram = index;
+
+    if (juce::MessageManager::existsAndIsCurrentThread())
+        applyPendingProgram();
+}
+
+void MakeItHappenOTTProcessor::applyPendingProgram()
+{
+    const int index = pendingProgram.exchange(-1);
+    if (index < 0)
+        return;
+
+    presets.apply(index);
+    parameters.releasePreset(index);
 }
 
 const juce::String MakeItHappenOTTProcessor::getProgramName(int index)
 {
-    juce::ignoreUnused(index);
-    return {};
+    return presets.getName(index);
 }
 
 void MakeItHappenOTTProcessor::changeProgramName(int index, const juce::String& newName)
 {
-    juce::ignoreUnused(index, newName);
+    presets.setName(index, newName);
+}
+
+void MakeItHappenOTTProcessor::storeUserPreset(int index, const juce::String& name)
+{
+    JUCE_ASSERT_MESSAGE_THREAD
+
+    if (! presets.isUserPreset(index))
+        return;
+
+    presets.store(index, name);
+    presets.setCurrent(index);
+    updateHostDisplay(ChangeDetails().withProgramChanged(true));
+}
+
+void MakeItHappenOTTProcessor::setCompressorMode(CompressorKernelBase::Mode mode)
+{
+    compressorMode = mode;
+
+    for (auto& group : channelGroups)
+        for (auto& engine : group.engines)
+            engine->setCompressorMode(mode);
+}
+
+void MakeItHappenOTTProcessor::setGainPrecision(GainMath::Precision precision)
+{
+    gainPrecision = precision;
+
+    for (auto& group : channelGroups)
+        for (auto& engine : group.engines)
+            engine->setGainPrecision(precision);
+}
+
+void MakeItHappenOTTProcessor::setGainControlInterval(int samples)
+{
+    gainControlInterval = samples;
+
+    for (auto& group : channelGroups)
+        for (auto& engine : group.engines)
+            engine->setControlInterval(samples);
+}
+
+void MakeItHappenOTTProcessor::setSleepEnabled(bool shouldSleep)
+{
+    sleepEnabled = shouldSleep;
+
+    if (! sleepEnabled && asleep)
+        wakeUp();
 }
 
 void MakeItHappenOTTProcessor::prepareToPlay(double sampleRate, int samplesPerBlock)
 {
-    // Initialize multiband crossover filters
-    juce::dsp::ProcessSpec spec;
-    spec.sampleRate = sampleRate;
-    spec.maximumBlockSize = samplesPerBlock;
-    spec.numChannels = 2;
-
-    // Low band: everything below 250Hz
-    lowPassLow.setType(juce::dsp::LinkwitzRileyFilterType::lowpass);
-    lowPassLow.setCutoffFrequency(250.0f);
-    lowPassLow.prepare(spec);
-
-    // Mid band: 250Hz to 2000Hz
-    highPassMid.setType(juce::dsp::LinkwitzRileyFilterType::highpass);
-    highPassMid.setCutoffFrequency(250.0f);
-    highPassMid.prepare(spec);
-
-    lowPassMid.setType(juce::dsp::LinkwitzRileyFilterType::lowpass);
-    lowPassMid.setCutoffFrequency(2000.0f);
-    lowPassMid.prepare(spec);
-
-    // High band: everything above 2000Hz
-    highPassHigh.setType(juce::dsp::LinkwitzRileyFilterType::highpass);
-    highPassHigh.setCutoffFrequency(2000.0f);
-    highPassHigh.prepare(spec);
-
-    // Allocate band buffers
-    lowBandBuffer.setSize(2, samplesPerBlock);
-    midBandBuffer.setSize(2, samplesPerBlock);
-    highBandBuffer.setSize(2, samplesPerBlock);
-
-    // Reset envelope followers
-    for (int i = 0; i < 2; ++i)
+    // A build still running for the previous configuration must finish before
+    // its engines and kernels are replaced
+    kernelBuilder.removeAllJobs(true, -1);
+
+    maxBlockSize = juce::jmax(1, samplesPerBlock);
+    preparedForDouble = isUsingDoublePrecision();
+
+    // Engines are only recreated when the grouping of the channels or the
+    // processing precision changes
+    auto groups = makeChannelGroups(getBusCount(true) > 0 ? getChannelLayoutOfBus(true, 0) : juce::AudioChannelSet());
+    auto sameChannels = [](const ChannelGroup& a, const ChannelGroup& b)
+    {
+        return a.numChannels == b.numChannels && a.channels[0] == b.channels[0] && a.channels[1] == b.channels[1];
+    };
+
+    if (! std::equal(groups.begin(), groups.end(), channelGroups.begin(), channelGroups.end(), sameChannels))
+        channelGroups = std::move(groups);
+
+    // Build every band mode up front, so switching modes never allocates
+    for (auto& group : channelGroups)
+    {
+        for (int mode = 0; mode < numBandModes; ++mode)
+        {
+            auto& engine = group.engines[mode];
+
+            if (engine == nullptr || engine->isDoublePrecision() != preparedForDouble)
+                engine = createBandEngine(bandModeToNumBands(mode), group.numChannels, preparedForDouble);
+
+            engine->setCompressorMode(compressorMode);
+            engine->setGainPrecision(gainPrecision);
+            engine->setControlInterval(gainControlInterval);
+            engine->prepare(sampleRate, maxBlockSize);
+        }
+    }
+
+    activeBandMode = -1;
+
+    analyser.setSampleRate(sampleRate);
+
+    // Meter timestamps restart; a frame still waiting for the editor is stale
+    meterSampleTime = 0;
+    meterFifo.clearPending();
+
+    // Allocate all scratch buffers up front so processBlock never allocates
+    const int numDryChannels = juce::jmax(1, getTotalNumInputChannels());
+    dryBuffer.setSize(preparedForDouble ? 0 : numDryChannels, preparedForDouble ? 0 : maxBlockSize);
+    doubleDryBuffer.setSize(preparedForDouble ? numDryChannels : 0, preparedForDouble ? maxBlockSize : 0);
+    loudnessMatch.prepare(sampleRate, maxBlockSize, numDryChannels);
+    gainMatchActive = false;
+
+    asleep = false;
+    silentSamples = 0;
+    tailReleaseMs = -1.0; // the sample rate may have changed
+
+    // Recompute every cached coefficient; ramps restart at the current settings
+    parameters.prepare(sampleRate, maxBlockSize);
+
+    // prepare() dropped the engines' kernels, so the old ones can go. The new set
+    // takes a few milliseconds to design; offline renders wait for it here.
+    for (auto& kernels : linearPhaseKernels)
+        kernels.reset();
+
+    linearPhaseKernelsReady.reset();
+    kernelBuilder.addJob([this, sampleRate] { buildLinearPhaseKernels(sampleRate); });
+
+    if (isNonRealtime())
+        linearPhaseKernelsReady.wait(-1);
+
+    // Offline renders spread each block's channel groups and band lanes over a
+    // pool; realtime processing stays on the host's thread
+    if (isNonRealtime() && offlineThreads > 1)
     {
-        lowEnvelope[i] = 0.0f;
-        midEnvelope[i] = 0.0f;
-        highEnvelope[i] = 0.0f;
+        if (offlineWorkers == nullptr || offlineWorkers->getNumThreads() != offlineThreads)
+            offlineWorkers = std::make_unique<WorkStealingPool>(offlineThreads);
     }
+    else
+    {
+        offlineWorkers.reset();
+    }
+
+    updateLatency();
+}
+
+void MakeItHappenOTTProcessor::setOfflineThreads(int numThreads)
+{
+    offlineThreads = juce::jmax(1, numThreads);
+}
+
+void MakeItHappenOTTProcessor::buildLinearPhaseKernels(double sampleRate)
+{
+    // Every group's engine for a band mode has the same layout and shares one set
+    if (! channelGroups.empty())
+    {
+        for (int mode = 0; mode < numBandModes; ++mode)
+        {
+            linearPhaseKernels[mode] = channelGroups.front().engines[mode]->buildLinearPhaseKernels(sampleRate);
+
+            for (auto& group : channelGroups)
+                group.engines[mode]->setLinearPhaseKernels(linearPhaseKernels[mode].get());
+        }
+    }
+
+    linearPhaseKernelsReady.signal();
+}
+
+std::vector<MakeItHappenOTTProcessor::ChannelGroup> MakeItHappenOTTProcessor::makeChannelGroups(const juce::AudioChannelSet& layout)
+{
+    using Type = juce::AudioChannelSet::ChannelType;
+
+    static constexpr std::pair<Type, Type> pairs[] = {
+        { juce::AudioChannelSet::left, juce::AudioChannelSet::right },
+        { juce::AudioChannelSet::leftSurround, juce::AudioChannelSet::rightSurround },
+        { juce::AudioChannelSet::leftSurroundSide, juce::AudioChannelSet::rightSurroundSide },
+        { juce::AudioChannelSet::leftSurroundRear, juce::AudioChannelSet::rightSurroundRear },
+        { juce::AudioChannelSet::leftCentre, juce::AudioChannelSet::rightCentre },
+        { juce::AudioChannelSet::wideLeft, juce::AudioChannelSet::wideRight },
+        { juce::AudioChannelSet::topFrontLeft, juce::AudioChannelSet::topFrontRight },
+        { juce::AudioChannelSet::topSideLeft, juce::AudioChannelSet::topSideRight },
+        { juce::AudioChannelSet::topRearLeft, juce::AudioChannelSet::topRearRight },
+    };
+
+    const int numChannels = juce::jmin(layout.size(), maxNumChannels);
+    std::vector<ChannelGroup> groups;
+    std::vector<bool> grouped((size_t)numChannels, false);
+
+    for (int ch = 0; ch < numChannels; ++ch)
+    {
+        if (grouped[(size_t)ch])
+            continue;
+
+        ChannelGroup group;
+        group.channels[0] = ch;
+
+        for (const auto& [leftType, rightType] : pairs)
+        {
+            const int partner = layout.getChannelIndexForType(rightType);
+
+            if (layout.getTypeOfChannel(ch) == leftType && partner > ch && partner < numChannels)
+            {
+                group.channels[1] = partner;
+                group.numChannels = 2;
+                grouped[(size_t)partner] = true;
+                break;
+            }
+        }
+
+        groups.push_back(std::move(group));
+    }
+
+    return groups;
+}
+
+void MakeItHappenOTTProcessor::updateLatency()
+{
+    const bool linearPhase = apvts.getRawParameterValue("crossoverMode")->load() > 0.5f;
+    const float lookaheadMs = apvts.getRawParameterValue("lookahead")->load();
+
+    // The engines delay wet and dry alike by the lookahead, after the crossover
+    setLatencySamples((linearPhase ? LinearPhaseKernels::getLatencySamples(getSampleRate()) : 0)
+                      + ParameterSnapshot::lookaheadToSamples(lookaheadMs, getSampleRate()));
+}
+
+void MakeItHappenOTTProcessor::parameterChanged(const juce::String& parameterID, float newValue)
+{
+    juce::ignoreUnused(parameterID, newValue);
+
+    // May be called on the audio thread; the latency is reported from the message thread
+    if (juce::MessageManager::existsAndIsCurrentThread())
+        updateLatency();
+    else
+        latencyChanged = true;
+}
+
+void MakeItHappenOTTProcessor::timerCallback()
+{
+    applyPendingProgram();
+
+    if (latencyChanged.exchange(false))
+        updateLatency();
 }
 
 void MakeItHappenOTTProcessor::releaseResources()
@@ -133,8 +438,10 @@ bool MakeItHappenOTTProcessor::isBusesLayoutSupported(const BusesLayout& layouts
     juce::ignoreUnused(layouts);
     return true;
 #else
-    if (layouts.getMainOutputChannelSet() != juce::AudioChannelSet::mono()
-        && layouts.getMainOutputChannelSet() != juce::AudioChannelSet::stereo())
+    // Any layout up to maxNumChannels: stereo pairs and single channels are
+    // processed as separate groups
+    const auto& output = layouts.getMainOutputChannelSet();
+    if (output.isDisabled() || output.size() > maxNumChannels)
         return false;
 
 #if !JucePlugin_IsSynth
@@ -149,302 +456,256 @@ bool MakeItHappenOTTProcessor::isBusesLayoutSupported(const BusesLayout& layouts
 void MakeItHappenOTTProcessor::processBlock(juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages)
 {
     juce::ignoreUnused(midiMessages);
+    processSamples(buffer);
+}
+
+void MakeItHappenOTTProcessor::processBlock(juce::AudioBuffer<double>& buffer, juce::MidiBuffer& midiMessages)
+{
+    juce::ignoreUnused(midiMessages);
+    processSamples(buffer);
+}
+
+template <typename SampleType>
+void MakeItHappenOTTProcessor::processSamples(juce::AudioBuffer<SampleType>& buffer)
+{
     juce::ScopedNoDenormals noDenormals;
+    AudioThreadGuard::Scope audioThreadGuard;
     auto totalNumInputChannels = getTotalNumInputChannels();
     auto totalNumOutputChannels = getTotalNumOutputChannels();
 
     for (auto i = totalNumInputChannels; i < totalNumOutputChannels; ++i)
         buffer.clear(i, 0, buffer.getNumSamples());
 
-    const int numSamples = buffer.getNumSamples();
-    const float sampleRate = static_cast<float>(getSampleRate());
+    if (maxBlockSize <= 0)
+        return; // Not prepared yet
+
+    // The host must set the precision before prepareToPlay
+    if (preparedForDouble != std::is_same_v<SampleType, double>)
+    {
+        jassertfalse;
+        return;
+    }
+
+    // Read all parameters once; derived coefficients are only recomputed on change
+    parameters.update(getSampleRate(), buffer.getNumSamples());
+    const auto& global = parameters.getGlobal();
+
+    // A newly selected band mode starts from cleared filter and envelope state
+    const int bandMode = juce::jlimit(0, numBandModes - 1, global.bandMode);
+    if (bandMode != activeBandMode)
+    {
+        for (auto& group : channelGroups)
+            group.engines[bandMode]->reset();
 
-    // Get parameters
-    float depthPercent = apvts.getRawParameterValue("depth")->load(); // Now 0-100
-    float depth = depthPercent / 100.0f; // Convert to 0-1 for mixing
-    float inputGainDb = apvts.getRawParameterValue("inputGain")->load();
-    float outputGainDb = apvts.getRawParameterValue("outputGain")->load();
-    float time = apvts.getRawParameterValue("time")->load();
+        activeBandMode = bandMode;
+        analyser.setNumBands(bandModeToNumBands(bandMode));
+    }
 
-    float inputGain = juce::Decibels::decibelsToGain(inputGainDb);
-    float outputGain = juce::Decibels::decibelsToGain(outputGainDb);
+    // An offline render never runs without kernels, e.g. if setNonRealtime() came
+    // after prepareToPlay()
+    if (global.linearPhase && isNonRealtime() && ! channelGroups.empty()
+        && ! channelGroups.front().engines[bandMode]->hasLinearPhaseKernels())
+    {
+        AudioThreadGuard::Suspend allowWaiting;
+        linearPhaseKernelsReady.wait(-1);
+    }
 
     // Update metering
-    this->depthPercent.store(depthPercent);
-    this->timePercent.store(time);
-    this->gainMatchEnabled.store(apvts.getRawParameterValue("gainMatch")->load() > 0.5f);
+    this->depthPercent.store(global.depthPercent);
+    this->timePercent.store(global.timePercent);
+    this->gainMatchEnabled.store(global.gainMatch);
 
-    // Calculate input level (before processing)
-    float inputLevel = 0.0f;
-    for (int ch = 0; ch < totalNumInputChannels; ++ch)
+    // UPWARD knob controls lowRatioUp, DOWNWARD knob controls highRatioUp
+    // Ratio goes from 1-20, map to 0-100%
+    upwardPercent.store(((parameters.getBand(ParameterSnapshot::lowSlot).ratioUp - 1.0f) / 19.0f) * 100.0f);
+    downwardPercent.store(((parameters.getBand(ParameterSnapshot::highSlot).ratioUp - 1.0f) / 19.0f) * 100.0f);
+
+    // The tail only moves with the releases, TIME and the latency
+    const double longestReleaseMs = parameters.getLongestReleaseMs();
+    if (longestReleaseMs != tailReleaseMs || getLatencySamples() != tailLatencySamples)
     {
-        float channelLevel = buffer.getRMSLevel(ch, 0, numSamples);
-        inputLevel = juce::jmax(inputLevel, channelLevel);
+        tailReleaseMs = longestReleaseMs;
+        tailLatencySamples = getLatencySamples();
+        tailSamples = (juce::int64)std::ceil(ParameterSnapshot::releaseTailSeconds(tailReleaseMs, -silenceThresholdDb) * getSampleRate())
+                    + tailLatencySamples;
     }
-    inputLevelDb.store(juce::Decibels::gainToDecibels(inputLevel + 0.00001f));
 
-    // Apply input gain
-    buffer.applyGain(inputGain);
-
-    // Low band parameters
-    float lowThresholdDown = apvts.getRawParameterValue("lowThreshDown")->load();
-    float lowRatioDown = apvts.getRawParameterValue("lowRatioDown")->load();
-    float lowThresholdUp = apvts.getRawParameterValue("lowThreshUp")->load();
-    float lowRatioUp = apvts.getRawParameterValue("lowRatioUp")->load();
-    float lowAttack = apvts.getRawParameterValue("lowAttack")->load();
-    float lowRelease = apvts.getRawParameterValue("lowRelease")->load();
-    float lowGain = juce::Decibels::decibelsToGain(apvts.getRawParameterValue("lowGain")->load());
-
-    // Mid band parameters
-    float midThresholdDown = apvts.getRawParameterValue("midThreshDown")->load();
-    float midRatioDown = apvts.getRawParameterValue("midRatioDown")->load();
-    float midThresholdUp = apvts.getRawParameterValue("midThreshUp")->load();
-    float midRatioUp = apvts.getRawParameterValue("midRatioUp")->load();
-    float midAttack = apvts.getRawParameterValue("midAttack")->load();
-    float midRelease = apvts.getRawParameterValue("midRelease")->load();
-    float midGain = juce::Decibels::decibelsToGain(apvts.getRawParameterValue("midGain")->load());
-
-    // High band parameters
-    float highThresholdDown = apvts.getRawParameterValue("highThreshDown")->load();
-    float highRatioDown = apvts.getRawParameterValue("highRatioDown")->load();
-    float highThresholdUp = apvts.getRawParameterValue("highThreshUp")->load();
-    float highRatioUp = apvts.getRawParameterValue("highRatioUp")->load();
-    float highAttack = apvts.getRawParameterValue("highAttack")->load();
-    float highRelease = apvts.getRawParameterValue("highRelease")->load();
-    float highGain = juce::Decibels::decibelsToGain(apvts.getRawParameterValue("highGain")->load());
-
-    // Store dry signal for mixing
-    juce::AudioBuffer<float> dryBuffer(buffer.getNumChannels(), numSamples);
-    for (int ch = 0; ch < buffer.getNumChannels(); ++ch)
-        dryBuffer.copyFrom(ch, 0, buffer, ch, 0, numSamples);
-
-    // Split into bands using Linkwitz-Riley crossover
-    lowBandBuffer.makeCopyOf(buffer);
-    midBandBuffer.makeCopyOf(buffer);
-    highBandBuffer.makeCopyOf(buffer);
-
-    // Apply crossover filters
-    juce::dsp::AudioBlock<float> lowBlock(lowBandBuffer);
-    juce::dsp::AudioBlock<float> midBlock(midBandBuffer);
-    juce::dsp::AudioBlock<float> highBlock(highBandBuffer);
-
-    juce::dsp::ProcessContextReplacing<float> lowContext(lowBlock);
-    juce::dsp::ProcessContextReplacing<float> midContext(midBlock);
-    juce::dsp::ProcessContextReplacing<float> highContext(highBlock);
-
-    // Low band: just low-pass
-    lowPassLow.process(lowContext);
-
-    // Mid band: band-pass (high-pass then low-pass)
-    highPassMid.process(midContext);
-    lowPassMid.process(midContext);
-
-    // High band: just high-pass
-    highPassHigh.process(highContext);
-
-    // Process each band with OTT compression using envelope followers
-    for (int channel = 0; channel < totalNumInputChannels; ++channel)
+    // Some hosts exceed the block size announced in prepareToPlay. Rather than
+    // resizing the scratch buffers here, process such blocks in slices.
+    const int numSamples = buffer.getNumSamples();
+    for (int start = 0; start < numSamples; start += maxBlockSize)
     {
-        // LOW BAND
-        auto* lowData = lowBandBuffer.getWritePointer(channel);
-        for (int sample = 0; sample < numSamples; ++sample)
-        {
-            float input = lowData[sample];
+        const int chunkSize = juce::jmin(maxBlockSize, numSamples - start);
 
-            // Update envelope follower
-            processEnvelope(lowEnvelope[channel], input, lowAttack, lowRelease, sampleRate);
+        // Asleep: zeros up to the first non-zero input sample, which wakes the
+        // processor and starts the chunk it processes. Upward compression can
+        // lift a signal far below silenceThresholdDb above it, so any input wakes.
+        int skipped = 0;
+        if (asleep)
+        {
+            juce::AudioBuffer<SampleType> input(buffer.getArrayOfWritePointers(), buffer.getNumChannels(), start, chunkSize);
+            skipped = findFirstAbove(input, juce::jmin(totalNumInputChannels, buffer.getNumChannels()), (SampleType)0);
 
-            // Calculate gain reduction based on envelope
-            float envelopeDb = juce::Decibels::gainToDecibels(lowEnvelope[channel] + 0.00001f);
-            float gainReduction = 1.0f;
+            for (int ch = 0; ch < buffer.getNumChannels(); ++ch)
+                buffer.clear(ch, start, skipped);
 
-            // Downward compression
-            if (envelopeDb > lowThresholdDown)
-            {
-                float diff = envelopeDb - lowThresholdDown;
-                float reducedDb = lowThresholdDown + (diff / lowRatioDown);
-                gainReduction *= juce::Decibels::decibelsToGain(reducedDb - envelopeDb);
-            }
+            meterSampleTime += skipped;
 
-            // Upward compression (expansion)
-            if (envelopeDb < lowThresholdUp)
-            {
-                float diff = lowThresholdUp - envelopeDb;
-                float boostedDb = envelopeDb + (diff * (1.0f - 1.0f / lowRatioUp));
-                gainReduction *= juce::Decibels::decibelsToGain(boostedDb - envelopeDb);
-            }
+            if (skipped == chunkSize)
+                continue;
 
-            lowData[sample] = input * gainReduction * lowGain;
+            wakeUp();
         }
 
-        // MID BAND
-        auto* midData = midBandBuffer.getWritePointer(channel);
-        for (int sample = 0; sample < numSamples; ++sample)
-        {
-            float input = midData[sample];
+        // Referencing constructor: no allocation for fewer than 32 channels
+        juce::AudioBuffer<SampleType> chunk(buffer.getArrayOfWritePointers(), buffer.getNumChannels(),
+                                            start + skipped, chunkSize - skipped);
+        processChunk(chunk);
+    }
+}
 
-            processEnvelope(midEnvelope[channel], input, midAttack, midRelease, sampleRate);
+void MakeItHappenOTTProcessor::wakeUp() noexcept
+{
+    if (activeBandMode >= 0)
+        for (auto& group : channelGroups)
+            group.engines[activeBandMode]->reset();
 
-            float envelopeDb = juce::Decibels::gainToDecibels(midEnvelope[channel] + 0.00001f);
-            float gainReduction = 1.0f;
+    loudnessMatch.reset();
 
-            if (envelopeDb > midThresholdDown)
-            {
-                float diff = envelopeDb - midThresholdDown;
-                float reducedDb = midThresholdDown + (diff / midRatioDown);
-                gainReduction *= juce::Decibels::decibelsToGain(reducedDb - envelopeDb);
-            }
+    parameters.invalidate();
+    parameters.update(getSampleRate(), 0);
 
-            if (envelopeDb < midThresholdUp)
-            {
-                float diff = midThresholdUp - envelopeDb;
-                float boostedDb = envelopeDb + (diff * (1.0f - 1.0f / midRatioUp));
-                gainReduction *= juce::Decibels::decibelsToGain(boostedDb - envelopeDb);
-            }
+    asleep = false;
+    silentSamples = 0;
+}
 
-            midData[sample] = input * gainReduction * midGain;
-        }
+template <typename SampleType>
+void MakeItHappenOTTProcessor::processChunk(juce::AudioBuffer<SampleType>& buffer)
+{
+    auto& dry = getDryBuffer<SampleType>();
+    auto totalNumInputChannels = juce::jmin(getTotalNumInputChannels(), dry.getNumChannels());
 
-        // HIGH BAND
-        auto* highData = highBandBuffer.getWritePointer(channel);
-        for (int sample = 0; sample < numSamples; ++sample)
-        {
-            float input = highData[sample];
+    const int numSamples = buffer.getNumSamples();
+    const auto& global = parameters.getGlobal();
 
-            processEnvelope(highEnvelope[channel], input, highAttack, highRelease, sampleRate);
+    // Ramp arrays for the smoothed parameters over this chunk (nullptr = steady)
+    parameters.advance(numSamples);
+    const float* inputGainRamp = parameters.getRamp(ParameterSnapshot::inputGainRamp);
+    const float* depthRamp = parameters.getRamp(ParameterSnapshot::depthRamp);
+    const float* outputGainRamp = parameters.getRamp(ParameterSnapshot::outputGainRamp);
 
-            float envelopeDb = juce::Decibels::gainToDecibels(highEnvelope[channel] + 0.00001f);
-            float gainReduction = 1.0f;
+    MeterFrame meters;
+    meters.sampleTime = meterSampleTime;
+    meters.numSamples = numSamples;
+    meterSampleTime += numSamples;
 
-            if (envelopeDb > highThresholdDown)
-            {
-                float diff = envelopeDb - highThresholdDown;
-                float reducedDb = highThresholdDown + (diff / highRatioDown);
-                gainReduction *= juce::Decibels::decibelsToGain(reducedDb - envelopeDb);
-            }
+    // Input level (before processing)
+    measureLevels(buffer, totalNumInputChannels, meters.inputPeak, meters.inputRms);
 
-            if (envelopeDb < highThresholdUp)
-            {
-                float diff = highThresholdUp - envelopeDb;
-                float boostedDb = envelopeDb + (diff * (1.0f - 1.0f / highRatioUp));
-                gainReduction *= juce::Decibels::decibelsToGain(boostedDb - envelopeDb);
-            }
+    // Apply input gain
+    applyGain(buffer, totalNumInputChannels, inputGainRamp, global.inputGain);
 
-            highData[sample] = input * gainReduction * highGain;
+    // Split into bands, compress, apply width and sum back into buffer. The dry
+    // signal for mixing comes out of the crossover with matching phase.
+    auto processGroup = [this, &buffer, &dry, numSamples](ChannelGroup& group, WorkStealingPool* workers)
+    {
+        SampleType* groupChannels[2] {};
+        SampleType* groupDryChannels[2] {};
+
+        for (int i = 0; i < group.numChannels; ++i)
+        {
+            groupChannels[i] = buffer.getWritePointer(group.channels[i]);
+            groupDryChannels[i] = dry.getWritePointer(group.channels[i]);
         }
-    }
 
-    // Apply stereo width to each band
-    float lowWidth = apvts.getRawParameterValue("lowWidth")->load();
-    float midWidth = apvts.getRawParameterValue("midWidth")->load();
-    float highWidth = apvts.getRawParameterValue("highWidth")->load();
+        // Referencing constructors: no allocation
+        juce::AudioBuffer<SampleType> groupBuffer(groupChannels, group.numChannels, numSamples);
+        juce::AudioBuffer<SampleType> groupDry(groupDryChannels, group.numChannels, numSamples);
 
-    applyStereoWidth(lowBandBuffer, lowWidth);
-    applyStereoWidth(midBandBuffer, midWidth);
-    applyStereoWidth(highBandBuffer, highWidth);
+        group.getEngine<SampleType>(activeBandMode).process(groupBuffer, groupDry, parameters, workers);
+    };
 
-    // Calculate band levels for spectrum display
-    float lowLevel = 0.0f;
-    float midLevel = 0.0f;
-    float highLevel = 0.0f;
-    for (int ch = 0; ch < totalNumInputChannels; ++ch)
+    // Groups touch disjoint channels and engines, so offline they run in
+    // parallel; the pool blocks, which only the non-realtime path may do
+    auto* workers = isNonRealtime() ? offlineWorkers.get() : nullptr;
+
+    if (workers != nullptr)
     {
-        lowLevel = juce::jmax(lowLevel, lowBandBuffer.getRMSLevel(ch, 0, numSamples));
-        midLevel = juce::jmax(midLevel, midBandBuffer.getRMSLevel(ch, 0, numSamples));
-        highLevel = juce::jmax(highLevel, highBandBuffer.getRMSLevel(ch, 0, numSamples));
+        AudioThreadGuard::Suspend allowWaiting;
+        workers->parallelFor((int)channelGroups.size(), [&](int index) { processGroup(channelGroups[(size_t)index], workers); });
     }
-    lowBandLevel.store(lowLevel);
-    midBandLevel.store(midLevel);
-    highBandLevel.store(highLevel);
-
-    // Check solo states
-    bool lowSolo = apvts.getRawParameterValue("lowSolo")->load() > 0.5f;
-    bool midSolo = apvts.getRawParameterValue("midSolo")->load() > 0.5f;
-    bool highSolo = apvts.getRawParameterValue("highSolo")->load() > 0.5f;
-    bool anySolo = lowSolo || midSolo || highSolo;
-
-    // Sum the bands back together (respecting solo)
-    buffer.clear();
-    for (int channel = 0; channel < totalNumInputChannels; ++channel)
+    else
     {
-        // If any solo is active, only add soloed bands
-        if (anySolo)
-        {
-            if (lowSolo)
-                buffer.addFrom(channel, 0, lowBandBuffer, channel, 0, numSamples);
-            if (midSolo)
-                buffer.addFrom(channel, 0, midBandBuffer, channel, 0, numSamples);
-            if (highSolo)
-                buffer.addFrom(channel, 0, highBandBuffer, channel, 0, numSamples);
-        }
-        else
-        {
-            // No solo active, add all bands
-            buffer.addFrom(channel, 0, lowBandBuffer, channel, 0, numSamples);
-            buffer.addFrom(channel, 0, midBandBuffer, channel, 0, numSamples);
-            buffer.addFrom(channel, 0, highBandBuffer, channel, 0, numSamples);
-        }
+        for (auto& group : channelGroups)
+            processGroup(group, nullptr);
     }
 
-    // Calculate RMS of wet signal before mixing (for gain match)
-    float wetRMS = 0.0f;
-    if (apvts.getRawParameterValue("gainMatch")->load() > 0.5f)
+    // Band meters: the loudest group and the group compressing hardest. Reduced
+    // after the join, in group order, so both paths meter identically.
+    for (auto& group : channelGroups)
     {
-        for (int ch = 0; ch < totalNumInputChannels; ++ch)
+        const auto& engine = *group.engines[activeBandMode];
+
+        for (int slot = 0; slot < ParameterSnapshot::numBandSlots; ++slot)
         {
-            float channelRMS = buffer.getRMSLevel(ch, 0, numSamples);
-            wetRMS = juce::jmax(wetRMS, channelRMS);
+            meters.bandLevel[slot] = juce::jmax(meters.bandLevel[slot], engine.getBandLevel(slot));
+
+            if (std::abs(engine.getBandGainDb(slot)) > std::abs(meters.bandGainDb[slot]))
+                meters.bandGainDb[slot] = engine.getBandGainDb(slot);
         }
     }
 
     // Apply depth (wet/dry mix)
+    const float depth = global.depth;
     for (int channel = 0; channel < totalNumInputChannels; ++channel)
     {
         auto* wetData = buffer.getWritePointer(channel);
-        auto* dryData = dryBuffer.getReadPointer(channel);
+        auto* dryData = dry.getReadPointer(channel);
 
-        for (int sample = 0; sample < numSamples; ++sample)
+        if (depthRamp != nullptr)
         {
-            wetData[sample] = dryData[sample] * (1.0f - depth) + wetData[sample] * depth;
+            for (int sample = 0; sample < numSamples; ++sample)
+                wetData[sample] = dryData[sample] * (1.0f - depthRamp[sample]) + wetData[sample] * depthRamp[sample];
+        }
+        else
+        {
+            for (int sample = 0; sample < numSamples; ++sample)
+                wetData[sample] = dryData[sample] * (1.0f - depth) + wetData[sample] * depth;
         }
     }
 
-    // Apply gain match compensation if enabled
-    if (apvts.getRawParameterValue("gainMatch")->load() > 0.5f)
+    // Gain match: bring the mix to the dry signal's loudness. A newly enabled
+    // match starts from unity gain and empty loudness windows.
+    if (global.gainMatch != gainMatchActive)
     {
-        // Calculate RMS of dry signal
-        float dryRMS = 0.0f;
-        for (int ch = 0; ch < totalNumInputChannels; ++ch)
-        {
-            float channelRMS = dryBuffer.getRMSLevel(ch, 0, numSamples);
-            dryRMS = juce::jmax(dryRMS, channelRMS);
-        }
+        if (global.gainMatch)
+            loudnessMatch.reset();
 
-        // Apply compensation to match dry signal level
-        if (wetRMS > 0.00001f && dryRMS > 0.00001f)
-        {
-            float compensationGain = dryRMS / wetRMS;
-            buffer.applyGain(compensationGain);
-        }
+        gainMatchActive = global.gainMatch;
     }
 
+    if (gainMatchActive)
+        loudnessMatch.process(buffer, dry, totalNumInputChannels);
+
     // Apply output gain
-    buffer.applyGain(outputGain);
+    applyGain(buffer, totalNumInputChannels, outputGainRamp, global.outputGain);
 
-    // Calculate output level (after processing)
-    float outputLevel = 0.0f;
-    for (int ch = 0; ch < totalNumInputChannels; ++ch)
+    // Output level (after processing)
+    measureLevels(buffer, totalNumInputChannels, meters.outputPeak, meters.outputRms);
+
+    analyser.pushSamples(buffer, totalNumInputChannels);
+
+    meters.timeMs = juce::Time::getMillisecondCounterHiRes();
+    meterFifo.push(meters);
+
+    // Sleep once the input has been digital silence for the whole tail and the
+    // output has followed it below the threshold
+    if (sleepEnabled)
     {
-        float channelLevel = buffer.getRMSLevel(ch, 0, numSamples);
-        outputLevel = juce::jmax(outputLevel, channelLevel);
+        const float threshold = juce::Decibels::decibelsToGain(silenceThresholdDb);
+        silentSamples = meters.inputPeak == 0.0f ? silentSamples + numSamples : 0;
+        asleep = silentSamples >= tailSamples && meters.outputPeak <= threshold;
     }
-    outputLevelDb.store(juce::Decibels::gainToDecibels(outputLevel + 0.00001f));
-
-    // Update upward/downward percentages
-    // UPWARD knob controls lowRatioUp, DOWNWARD knob controls highRatioUp
-    // Ratio goes from 1-20, map to 0-100%
-    upwardPercent.store(((lowRatioUp - 1.0f) / 19.0f) * 100.0f);  // Map 1-20 to 0-100%
-    downwardPercent.store(((highRatioUp - 1.0f) / 19.0f) * 100.0f);
 }
 
 bool MakeItHappenOTTProcessor::hasEditor() const
@@ -452,6 +713,16 @@ bool MakeItHappenOTTProcessor::hasEditor() const
     return true;
 }
 
+EditorArtwork& MakeItHappenOTTProcessor::getEditorArtwork()
+{
+    JUCE_ASSERT_MESSAGE_THREAD
+
+    if (editorArtwork == nullptr)
+        editorArtwork = std::make_unique<juce::SharedResourcePointer<EditorArtwork>>();
+
+    return editorArtwork->get();
+}
+
 juce::AudioProcessorEditor* MakeItHappenOTTProcessor::createEditor()
 {
     return new MakeItHappenOTTEditor(*this);
@@ -459,17 +730,60 @@ juce::AudioProcessorEditor* MakeItHappenOTTProcessor::createEditor()
 
 void MakeItHappenOTTProcessor::getStateInformation(juce::MemoryBlock& destData)
 {
-    auto state = apvts.copyState();
-    std::unique_ptr<juce::XmlElement> xml(state.createXml());
-    copyXmlToBinary(*xml, destData);
+    // The parameters, then the preset bank when it holds anything of the session's
+    binaryState.write(destData);
+    presets.writeState(destData);
 }
 
 void MakeItHappenOTTProcessor::setStateInformation(const void* data, int sizeInBytes)
 {
+    // A program change still on its way to the parameters would overwrite them
+    pendingProgram = -1;
+    parameters.followPreset(-1);
+
+    if (BinaryState::isBinaryState(data, sizeInBytes))
+    {
+        const auto stateSize = BinaryState::getSize(data, sizeInBytes);
+        if (binaryState.read(data, sizeInBytes))
+            presets.readState(static_cast<const char*>(data) + stateSize, (size_t)sizeInBytes - stateSize);
+
+        return;
+    }
+
+    // States saved before the binary format
     std::unique_ptr<juce::XmlElement> xmlState(getXmlFromBinary(data, sizeInBytes));
     if (xmlState.get() != nullptr)
         if (xmlState->hasTagName(apvts.state.getType()))
+        {
             apvts.replaceState(juce::ValueTree::fromXml(*xmlState));
+            presets.readState(nullptr, 0);
+        }
+}
+
+namespace
+{
+    // Adds one band's parameter set; IDs are prefix + "ThreshDown" etc.
+    void addBandParameters(juce::AudioProcessorValueTreeState::ParameterLayout& layout,
+                           const juce::String& prefix, const juce::String& name)
+    {
+        layout.add(std::make_unique<juce::AudioParameterFloat>(prefix + "ThreshDown", name + " Thresh Down (dB)",
+            juce::NormalisableRange<float>(-60.0f, 0.0f, 0.1f), -20.0f));
+        layout.add(std::make_unique<juce::AudioParameterFloat>(prefix + "RatioDown", name + " Ratio Down",
+            juce::NormalisableRange<float>(1.0f, 20.0f, 0.1f), 3.0f));
+        layout.add(std::make_unique<juce::AudioParameterFloat>(prefix + "ThreshUp", name + " Thresh Up (dB)",
+            juce::NormalisableRange<float>(-60.0f, 0.0f, 0.1f), -40.0f));
+        layout.add(std::make_unique<juce::AudioParameterFloat>(prefix + "RatioUp", name + " Ratio Up",
+            juce::NormalisableRange<float>(1.0f, 20.0f, 0.1f), 2.0f));
+        layout.add(std::make_unique<juce::AudioParameterFloat>(prefix + "Attack", name + " Attack (ms)",
+            juce::NormalisableRange<float>(0.1f, 100.0f, 0.1f), 1.0f));
+        layout.add(std::make_unique<juce::AudioParameterFloat>(prefix + "Release", name + " Release (ms)",
+            juce::NormalisableRange<float>(10.0f, 1000.0f, 1.0f), 100.0f));
+        layout.add(std::make_unique<juce::AudioParameterFloat>(prefix + "Gain", name + " Gain (dB)",
+            juce::NormalisableRange<float>(-12.0f, 12.0f, 0.1f), 0.0f));
+        layout.add(std::make_unique<juce::AudioParameterFloat>(prefix + "Width", name + " Width (%)",
+            juce::NormalisableRange<float>(0.0f, 200.0f, 1.0f), 100.0f));
+        layout.add(std::make_unique<juce::AudioParameterBool>(prefix + "Solo", name + " Solo", false));
+    }
 }
 
 juce::AudioProcessorValueTreeState::ParameterLayout MakeItHappenOTTProcessor::createParameterLayout()
@@ -487,106 +801,53 @@ juce::AudioProcessorValueTreeState::ParameterLayout MakeItHappenOTTProcessor::cr
         juce::NormalisableRange<float>(0.0f, 1000.0f, 1.0f), 100.0f));
     layout.add(std::make_unique<juce::AudioParameterBool>("gainMatch", "Gain Match", false));
 
-    // LOW BAND PARAMETERS
-    layout.add(std::make_unique<juce::AudioParameterFloat>("lowThreshDown", "Low Thresh Down (dB)",
-        juce::NormalisableRange<float>(-60.0f, 0.0f, 0.1f), -20.0f));
-    layout.add(std::make_unique<juce::AudioParameterFloat>("lowRatioDown", "Low Ratio Down",
-        juce::NormalisableRange<float>(1.0f, 20.0f, 0.1f), 3.0f));
-    layout.add(std::make_unique<juce::AudioParameterFloat>("lowThreshUp", "Low Thresh Up (dB)",
-        juce::NormalisableRange<float>(-60.0f, 0.0f, 0.1f), -40.0f));
-    layout.add(std::make_unique<juce::AudioParameterFloat>("lowRatioUp", "Low Ratio Up",
-        juce::NormalisableRange<float>(1.0f, 20.0f, 0.1f), 2.0f));
-    layout.add(std::make_unique<juce::AudioParameterFloat>("lowAttack", "Low Attack (ms)",
-        juce::NormalisableRange<float>(0.1f, 100.0f, 0.1f), 1.0f));
-    layout.add(std::make_unique<juce::AudioParameterFloat>("lowRelease", "Low Release (ms)",
-        juce::NormalisableRange<float>(10.0f, 1000.0f, 1.0f), 100.0f));
-    layout.add(std::make_unique<juce::AudioParameterFloat>("lowGain", "Low Gain (dB)",
-        juce::NormalisableRange<float>(-12.0f, 12.0f, 0.1f), 0.0f));
-    layout.add(std::make_unique<juce::AudioParameterFloat>("lowWidth", "Low Width (%)",
-        juce::NormalisableRange<float>(0.0f, 200.0f, 1.0f), 100.0f));
-    layout.add(std::make_unique<juce::AudioParameterBool>("lowSolo", "Low Solo", false));
-
-    // MID BAND PARAMETERS
-    layout.add(std::make_unique<juce::AudioParameterFloat>("midThreshDown", "Mid Thresh Down (dB)",
-        juce::NormalisableRange<float>(-60.0f, 0.0f, 0.1f), -20.0f));
-    layout.add(std::make_unique<juce::AudioParameterFloat>("midRatioDown", "Mid Ratio Down",
-        juce::NormalisableRange<float>(1.0f, 20.0f, 0.1f), 3.0f));
-    layout.add(std::make_unique<juce::AudioParameterFloat>("midThreshUp", "Mid Thresh Up (dB)",
-        juce::NormalisableRange<float>(-60.0f, 0.0f, 0.1f), -40.0f));
-    layout.add(std::make_unique<juce::AudioParameterFloat>("midRatioUp", "Mid Ratio Up",
-        juce::NormalisableRange<float>(1.0f, 20.0f, 0.1f), 2.0f));
-    layout.add(std::make_unique<juce::AudioParameterFloat>("midAttack", "Mid Attack (ms)",
-        juce::NormalisableRange<float>(0.1f, 100.0f, 0.1f), 1.0f));
-    layout.add(std::make_unique<juce::AudioParameterFloat>("midRelease", "Mid Release (ms)",
-        juce::NormalisableRange<float>(10.0f, 1000.0f, 1.0f), 100.0f));
-    layout.add(std::make_unique<juce::AudioParameterFloat>("midGain", "Mid Gain (dB)",
-        juce::NormalisableRange<float>(-12.0f, 12.0f, 0.1f), 0.0f));
-    layout.add(std::make_unique<juce::AudioParameterFloat>("midWidth", "Mid Width (%)",
-        juce::NormalisableRange<float>(0.0f, 200.0f, 1.0f), 100.0f));
-    layout.add(std::make_unique<juce::AudioParameterBool>("midSolo", "Mid Solo", false));
-
-    // HIGH BAND PARAMETERS
-    layout.add(std::make_unique<juce::AudioParameterFloat>("highThreshDown", "High Thresh Down (dB)",
-        juce::NormalisableRange<float>(-60.0f, 0.0f, 0.1f), -20.0f));
-    layout.add(std::make_unique<juce::AudioParameterFloat>("highRatioDown", "High Ratio Down",
-        juce::NormalisableRange<float>(1.0f, 20.0f, 0.1f), 3.0f));
-    layout.add(std::make_unique<juce::AudioParameterFloat>("highThreshUp", "High Thresh Up (dB)",
-        juce::NormalisableRange<float>(-60.0f, 0.0f, 0.1f), -40.0f));
-    layout.add(std::make_unique<juce::AudioParameterFloat>("highRatioUp", "High Ratio Up",
-        juce::NormalisableRange<float>(1.0f, 20.0f, 0.1f), 2.0f));
-    layout.add(std::make_unique<juce::AudioParameterFloat>("highAttack", "High Attack (ms)",
-        juce::NormalisableRange<float>(0.1f, 100.0f, 0.1f), 1.0f));
-    layout.add(std::make_unique<juce::AudioParameterFloat>("highRelease", "High Release (ms)",
-        juce::NormalisableRange<float>(10.0f, 1000.0f, 1.0f), 100.0f));
-    layout.add(std::make_unique<juce::AudioParameterFloat>("highGain", "High Gain (dB)",
-        juce::NormalisableRange<float>(-12.0f, 12.0f, 0.1f), 0.0f));
-    layout.add(std::make_unique<juce::AudioParameterFloat>("highWidth", "High Width (%)",
-        juce::NormalisableRange<float>(0.0f, 200.0f, 1.0f), 100.0f));
-    layout.add(std::make_unique<juce::AudioParameterBool>("highSolo", "High Solo", false));
-
-    return layout;
-}
-
-// Envelope follower function
-void MakeItHappenOTTProcessor::processEnvelope(float& envelope, float input, float attack, float release, float sampleRate)
-{
-    float inputLevel = std::abs(input);
-
-    // Convert attack/release from milliseconds to coefficient
-    float attackCoeff = std::exp(-1.0f / (attack * 0.001f * sampleRate));
-    float releaseCoeff = std::exp(-1.0f / (release * 0.001f * sampleRate));
-
-    if (inputLevel > envelope)
-        envelope = attackCoeff * envelope + (1.0f - attackCoeff) * inputLevel;
-    else
-        envelope = releaseCoeff * envelope + (1.0f - releaseCoeff) * inputLevel;
-}
-
-// Stereo width processing using Mid-Side technique
-void MakeItHappenOTTProcessor::applyStereoWidth(juce::AudioBuffer<float>& buffer, float widthPercent)
-{
-    if (buffer.getNumChannels() < 2)
-        return; // Only works with stereo
-
-    const int numSamples = buffer.getNumSamples();
-    float width = widthPercent / 100.0f; // Convert 0-200% to 0-2.0
+    // Band parameters: low, mid and high are used by every band mode
+    addBandParameters(layout, "low", "Low");
+    addBandParameters(layout, "mid", "Mid");
+    addBandParameters(layout, "high", "High");
+
+    // Band count, plus the extra bands of the 4- and 5-band modes
+    layout.add(std::make_unique<juce::AudioParameterChoice>("bandMode", "Band Mode",
+        juce::StringArray { "3 Bands", "4 Bands", "5 Bands" }, 0));
+    addBandParameters(layout, "lowMid", "Low-Mid");
+    addBandParameters(layout, "highMid", "High-Mid");
+
+    // One detector per band for each stereo pair instead of one per channel
+    layout.add(std::make_unique<juce::AudioParameterBool>("linkedDetection", "Linked Detection", false));
+
+    // IIR Linkwitz-Riley (no latency) or linear-phase FIR crossover
+    layout.add(std::make_unique<juce::AudioParameterChoice>("crossoverMode", "Crossover",
+        juce::StringArray { "Zero Latency", "Linear Phase" }, 0));
+
+    // Detector lead over the audio; adds the same latency
+    layout.add(std::make_unique<juce::AudioParameterFloat>("lookahead", "Lookahead (ms)",
+        juce::NormalisableRange<float>(0.0f, ParameterSnapshot::maxLookaheadMs, 0.1f), 0.0f));
+
+    // Preset morphing (see ParameterSnapshot): the glide time of program changes,
+    // and a morph between two presets of the bank
+    layout.add(std::make_unique<juce::AudioParameterFloat>("morphTime", "Preset Morph Time (ms)",
+        juce::NormalisableRange<float>(0.0f, ParameterSnapshot::maxMorphMs, 1.0f), 100.0f));
+    layout.add(std::make_unique<juce::AudioParameterBool>("abMorph", "A/B Morph", false));
+    layout.add(std::make_unique<juce::AudioParameterFloat>("abPosition", "A/B Position (%)",
+        juce::NormalisableRange<float>(0.0f, 100.0f, 0.1f), 0.0f));
+
+    // The A/B choices show the bank's names as they are now, so stored and
+    // renamed user presets read right in the host
+    const auto presetChoice = juce::AudioParameterChoiceAttributes()
+        .withStringFromValueFunction([this](int index, int) { return presets.getName(index); })
+        .withValueFromStringFunction([this](const juce::String& text)
+        {
+            for (int index = 0; index < presets.getNumPresets(); ++index)
+                if (presets.getName(index) == text)
+                    return index;
 
-    auto* leftData = buffer.getWritePointer(0);
-    auto* rightData = buffer.getWritePointer(1);
+            return juce::jmax(0, PresetBank::getDefaultNames().indexOf(text));
+        });
 
-    for (int sample = 0; sample < numSamples; ++sample)
-    {
-        // Convert to Mid-Side
-        float mid = (leftData[sample] + rightData[sample]) * 0.5f;
-        float side = (leftData[sample] - rightData[sample]) * 0.5f;
+    layout.add(std::make_unique<juce::AudioParameterChoice>("abPresetA", "A/B Preset A", PresetBank::getDefaultNames(), 0, presetChoice));
+    layout.add(std::make_unique<juce::AudioParameterChoice>("abPresetB", "A/B Preset B", PresetBank::getDefaultNames(), 1, presetChoice));
 
-        // Apply width to side signal
-        side *= width;
-
-        // Convert back to Left-Right
-        leftData[sample] = mid + side;
-        rightData[sample] = mid - side;
-    }
+    return layout;
 }
 
 juce::AudioProcessor* JUCE_CALLTYPE createPluginFilter()
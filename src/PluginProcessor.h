@@ -1,8 +1,19 @@
 #pragma once
 #include <juce_audio_processors/juce_audio_processors.h>
 #include <juce_dsp/juce_dsp.h>
-
-class MakeItHappenOTTProcessor : public juce::AudioProcessor
+#include "BandEngine.h"
+#include "BinaryState.h"
+#include "LoudnessMatch.h"
+#include "MeterFifo.h"
+#include "SpectrumAnalyser.h"
+#include "ParameterSnapshot.h"
+#include "PresetBank.h"
+
+class EditorArtwork;
+
+class MakeItHappenOTTProcessor : public juce::AudioProcessor,
+                                 private juce::AudioProcessorValueTreeState::Listener,
+                                 private juce::Timer
 {
 public:
     MakeItHappenOTTProcessor();
@@ -12,10 +23,19 @@ public:
     void releaseResources() override;
     bool isBusesLayoutSupported(const BusesLayout& layouts) const override;
     void processBlock(juce::AudioBuffer<float>&, juce::MidiBuffer&) override;
+    void processBlock(juce::AudioBuffer<double>&, juce::MidiBuffer&) override;
+
+    // Double-precision hosts get their own engines, so no conversion pass runs
+    bool supportsDoublePrecisionProcessing() const override { return true; }
 
     juce::AudioProcessorEditor* createEditor() override;
     bool hasEditor() const override;
 
+    // The editor artwork, shared with every other instance. Taken when the first
+    // editor opens and kept until the processor goes, so reopening the editor
+    // doesn't decode it again; message thread.
+    EditorArtwork& getEditorArtwork();
+
     const juce::String getName() const override;
     bool acceptsMidi() const override;
     bool producesMidi() const override;
@@ -34,41 +54,188 @@ public:
     // Audio Parameters Tree
     juce::AudioProcessorValueTreeState apvts;
 
-    // Metering values (atomic for thread safety) - public for UI access
-    std::atomic<float> inputLevelDb{0.0f};
-    std::atomic<float> outputLevelDb{0.0f};
+    // Per-block meter frames (levels, band gain), drained by the editor
+    MeterFifo meterFifo;
+
+    // Output spectrum per band; the editor starts and stops it
+    SpectrumAnalyser analyser;
+
+    // Factory and user presets, the host's programs. setCurrentProgram() morphs
+    // to any of them, from any thread.
+    PresetBank presets { *this };
+
+    // Stores the current settings into a user preset, makes it the current
+    // program and tells the host its name may have changed; message thread
+    void storeUserPreset(int index, const juce::String& name);
+
+    // Parameter readouts (atomic for thread safety) - public for UI access
     std::atomic<float> depthPercent{50.0f};
     std::atomic<float> timePercent{100.0f};
     std::atomic<float> upwardPercent{50.0f};
     std::atomic<float> downwardPercent{50.0f};
     std::atomic<bool> gainMatchEnabled{false};
 
-    // Band levels for spectrum display (RMS per band)
-    std::atomic<float> lowBandLevel{0.0f};
-    std::atomic<float> midBandLevel{0.0f};
-    std::atomic<float> highBandLevel{0.0f};
+    // Selects the SIMD or scalar compressor kernel (bit-identical output).
+    // Call before prepareToPlay or from the audio thread.
+    void setCompressorMode(CompressorKernelBase::Mode mode);
 
-private:
-    juce::AudioProcessorValueTreeState::ParameterLayout createParameterLayout();
+    // Selects libm or the fast polynomial log2/exp2 for the gain computer.
+    // The build default comes from MIH_FAST_GAIN_MATH.
+    void setGainPrecision(GainMath::Precision precision);
+
+    // Runs the compressors' gain computer once every samples (1, 4, 8, 16 or 32)
+    // and interpolates in between; 1 is the per-sample reference. Larger
+    // intervals trade a small gain error for CPU, e.g. for bulk offline renders.
+    // Call before prepareToPlay or from the audio thread.
+    void setGainControlInterval(int samples);
 
-    // Multiband crossover filters (Linkwitz-Riley 4th order)
-    juce::dsp::LinkwitzRileyFilter<float> lowPassLow, highPassLow;   // Low band
-    juce::dsp::LinkwitzRileyFilter<float> lowPassMid, highPassMid;   // Mid band
-    juce::dsp::LinkwitzRileyFilter<float> lowPassHigh, highPassHigh; // High band
+    // Threads (including the caller) used for offline rendering, when
+    // isNonRealtime() at prepareToPlay; 1 processes serially. Output is the
+    // same either way. Takes effect at the next prepareToPlay.
+    void setOfflineThreads(int numThreads);
 
-    // Audio buffers for each band
-    juce::AudioBuffer<float> lowBandBuffer, midBandBuffer, highBandBuffer;
+    // Sleep mode: once the input has been digital silence for the whole tail
+    // (getTailLengthSeconds()) and the output has decayed below silenceThresholdDb,
+    // the processor outputs zeros and skips all DSP and metering. It wakes on the
+    // first non-zero input sample, from cleared filter and envelope state: the
+    // upward compressors can lift even a very quiet input above the threshold.
+    // On by default; call before prepareToPlay or from the audio thread.
+    void setSleepEnabled(bool shouldSleep);
+    bool isAsleep() const noexcept { return asleep; }
 
-    // Compressor helper function
-    void processEnvelope(float& envelope, float input, float attack, float release, float sampleRate);
+    static constexpr float silenceThresholdDb = -120.0f;
 
-    // Stereo width processing (Mid-Side)
-    void applyStereoWidth(juce::AudioBuffer<float>& buffer, float widthPercent);
+    // "bandMode" choice index -> band count
+    static constexpr int numBandModes = 3;
+    static constexpr int bandModeToNumBands(int mode) { return 3 + mode; }
+
+private:
+    juce::AudioProcessorValueTreeState::ParameterLayout createParameterLayout();
 
-    // Envelope followers for each band
-    float lowEnvelope[2] = {0.0f, 0.0f};  // L/R
-    float midEnvelope[2] = {0.0f, 0.0f};
-    float highEnvelope[2] = {0.0f, 0.0f};
+    // Cached parameter pointers and derived coefficients, refreshed once per block
+    ParameterSnapshot parameters;
+
+    // Session state codec; setStateInformation still reads the older XML states
+    BinaryState binaryState { *this };
+
+    // Up to this many main bus channels (9.1.6); chunk and group buffers reference
+    // the host's channels without allocating
+    static constexpr int maxNumChannels = 16;
+
+    // A stereo pair or a single channel of the main bus. Each group has its own
+    // crossover + compressor engine per band mode, created and prepared in
+    // prepareToPlay; the engines selected by "bandMode" run each block. Width
+    // and linked detection act within a group.
+    struct ChannelGroup
+    {
+        int channels[2] = {};
+        int numChannels = 1;
+        std::unique_ptr<BandEngineBase> engines[numBandModes];
+
+        // The engine for a band mode, at the precision the engines were created for
+        template <typename SampleType>
+        TypedBandEngine<SampleType>& getEngine(int mode) const noexcept
+        {
+            jassert(engines[mode]->isDoublePrecision() == std::is_same_v<SampleType, double>);
+            return static_cast<TypedBandEngine<SampleType>&>(*engines[mode]);
+        }
+    };
+
+    std::vector<ChannelGroup> channelGroups;
+    int activeBandMode = -1;
+
+    // Pairs up the left/right channels of a layout; everything else is single
+    static std::vector<ChannelGroup> makeChannelGroups(const juce::AudioChannelSet& layout);
+
+    CompressorKernelBase::Mode compressorMode = CompressorKernelBase::Mode::vector;
+    GainMath::Precision gainPrecision = GainMath::defaultPrecision;
+    int gainControlInterval = 1;
+
+    // Linear-phase kernels per band mode, built on kernelBuilder for the current
+    // sample rate and lent to the matching engine
+    std::unique_ptr<LinearPhaseKernels> linearPhaseKernels[numBandModes];
+    juce::WaitableEvent linearPhaseKernelsReady { true };
+
+    // Worker pool for offline rendering; created in prepareToPlay when non-realtime
+    std::unique_ptr<WorkStealingPool> offlineWorkers;
+    int offlineThreads = juce::SystemStats::getNumCpus();
+
+    // Samples processed since prepareToPlay, for meter frame timestamps
+    juce::int64 meterSampleTime = 0;
+
+    // Dry copy used for the depth mix, at the processing precision; only the one
+    // in use is sized in prepareToPlay
+    juce::AudioBuffer<float> dryBuffer;
+    juce::AudioBuffer<double> doubleDryBuffer;
+    bool preparedForDouble = false;
+
+    template <typename SampleType>
+    juce::AudioBuffer<SampleType>& getDryBuffer() noexcept
+    {
+        if constexpr (std::is_same_v<SampleType, double>)
+            return doubleDryBuffer;
+        else
+            return dryBuffer;
+    }
+
+    // Sleep mode: consecutive all-zero input samples, and the tail
+    // they must cover, refreshed when its inputs change
+    bool sleepEnabled = true;
+    bool asleep = false;
+    juce::int64 silentSamples = 0;
+    juce::int64 tailSamples = 0;
+    double tailReleaseMs = -1.0;
+    int tailLatencySamples = 0;
+
+    // Clears the active engines and gain match and jumps the parameter ramps to
+    // their settings, so processing restarts from silence
+    void wakeUp() noexcept;
+
+    // "gainMatch": loudness of the mix against the dry signal
+    LoudnessMatch loudnessMatch;
+    bool gainMatchActive = false;
+    int maxBlockSize = 0;
+
+    // Held from the first createEditor() on (see getEditorArtwork())
+    std::unique_ptr<juce::SharedResourcePointer<EditorArtwork>> editorArtwork;
+
+    // Background thread for kernel design. Declared last so it is stopped before
+    // the engines and kernels its job touches are destroyed.
+    juce::ThreadPool kernelBuilder { 1 };
+
+    // Both processBlock overloads; processChunk takes at most maxBlockSize samples,
+    // and processSamples splits larger host blocks
+    template <typename SampleType>
+    void processSamples(juce::AudioBuffer<SampleType>& buffer);
+
+    template <typename SampleType>
+    void processChunk(juce::AudioBuffer<SampleType>& buffer);
+
+    // Runs on kernelBuilder: designs every band mode's kernels and publishes them
+    void buildLinearPhaseKernels(double sampleRate);
+
+    // Reports the linear-phase crossover's delay (0 for the IIR one) plus the
+    // lookahead to the host
+    void updateLatency();
+
+    // A program set from the audio thread, waiting to be copied into the
+    // parameters on the message thread; -1 if none
+    std::atomic<int> pendingProgram { -1 };
+
+    // Set when a latency parameter changed off the message thread
+    std::atomic<bool> latencyChanged { false };
+
+    // Sets the parameters to the pending program and hands the snapshot back to
+    // them; message thread
+    void applyPendingProgram();
+
+    void parameterChanged(const juce::String& parameterID, float newValue) override;
+
+    // Picks up what the audio thread left for the message thread. Polled rather
+    // than posted: triggerAsyncUpdate() goes through the OS message queue, which
+    // may block, so the audio thread only ever sets the atomics above.
+    static constexpr int pollIntervalMs = 20;
+    void timerCallback() override;
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(MakeItHappenOTTProcessor)
 };
@@ -0,0 +1,273 @@
+#include "PresetBank.h"
+
+namespace
+{
+    struct Setting
+    {
+        const char* parameterID;
+        float value;
+    };
+
+    struct FactoryPreset
+    {
+        const char* name;
+        std::initializer_list<Setting> settings; // everything else keeps its default
+    };
+
+    const FactoryPreset factoryPresets[] = {
+        { "Init", {} },
+        { "Classic OTT", { { "depth", 100.0f },
+                           { "lowThreshDown", -30.0f }, { "midThreshDown", -30.0f }, { "highThreshDown", -30.0f },
+                           { "lowRatioDown", 20.0f }, { "midRatioDown", 20.0f }, { "highRatioDown", 20.0f },
+                           { "lowThreshUp", -45.0f }, { "midThreshUp", -45.0f }, { "highThreshUp", -45.0f },
+                           { "lowRatioUp", 4.0f }, { "midRatioUp", 4.0f }, { "highRatioUp", 4.0f } } },
+        { "Gentle Glue", { { "depth", 30.0f },
+                           { "lowRatioDown", 2.0f }, { "midRatioDown", 2.0f }, { "highRatioDown", 2.0f },
+                           { "lowRatioUp", 1.5f }, { "midRatioUp", 1.5f }, { "highRatioUp", 1.5f },
+                           { "lowRelease", 200.0f }, { "midRelease", 200.0f }, { "highRelease", 200.0f } } },
+        { "Drum Smash", { { "depth", 80.0f }, { "time", 50.0f },
+                          { "lowThreshDown", -35.0f }, { "midThreshDown", -35.0f }, { "highThreshDown", -35.0f },
+                          { "lowRatioDown", 8.0f }, { "midRatioDown", 8.0f }, { "highRatioDown", 8.0f },
+                          { "lowRatioUp", 4.0f }, { "midRatioUp", 4.0f }, { "highRatioUp", 4.0f },
+                          { "lowAttack", 5.0f }, { "midAttack", 5.0f }, { "highAttack", 2.0f },
+                          { "lowRelease", 60.0f }, { "midRelease", 60.0f }, { "highRelease", 60.0f } } },
+        { "Vocal Air", { { "depth", 50.0f },
+                         { "midRatioDown", 3.0f }, { "midThreshDown", -24.0f },
+                         { "highThreshUp", -45.0f }, { "highRatioUp", 4.0f },
+                         { "highGain", 2.0f }, { "highWidth", 120.0f } } },
+        { "Bass Control", { { "depth", 60.0f },
+                            { "lowThreshDown", -25.0f }, { "lowRatioDown", 6.0f },
+                            { "lowAttack", 10.0f }, { "lowRelease", 150.0f }, { "lowWidth", 0.0f } } },
+        { "Upward Only", { { "depth", 70.0f },
+                           { "lowRatioDown", 1.0f }, { "midRatioDown", 1.0f }, { "highRatioDown", 1.0f },
+                           { "lowRatioUp", 6.0f }, { "midRatioUp", 6.0f }, { "highRatioUp", 6.0f } } },
+        { "Transient Safe", { { "depth", 60.0f }, { "lookahead", 5.0f }, { "linkedDetection", 1.0f },
+                              { "lowRatioDown", 6.0f }, { "midRatioDown", 6.0f }, { "highRatioDown", 6.0f } } },
+        { "Wide Master", { { "depth", 35.0f }, { "gainMatch", 1.0f }, { "bandMode", 2.0f },
+                           { "crossoverMode", 1.0f }, { "lookahead", 2.0f },
+                           { "lowRatioDown", 2.0f }, { "lowMidRatioDown", 2.0f }, { "midRatioDown", 2.0f },
+                           { "highMidRatioDown", 2.0f }, { "highRatioDown", 2.0f },
+                           { "lowWidth", 80.0f }, { "highMidWidth", 130.0f }, { "highWidth", 150.0f } } },
+    };
+
+    constexpr int numFactory = (int)std::size(factoryPresets);
+
+    // Parameters that drive the morph rather than the sound
+    const char* const morphControls[] = { "morphTime", "abMorph", "abPosition", "abPresetA", "abPresetB" };
+
+    const juce::Identifier bankType("PresetBank");
+    const juce::Identifier presetType("Preset");
+    const juce::Identifier currentProperty("current");
+    const juce::Identifier indexProperty("index");
+    const juce::Identifier nameProperty("name");
+}
+
+PresetBank::PresetBank(juce::AudioProcessor& processor)
+{
+    for (auto* parameter : processor.getParameters())
+        if (auto* ranged = dynamic_cast<juce::RangedAudioParameter*>(parameter))
+            if (isPresetParameter(ranged->paramID))
+                parameters.add(ranged);
+
+    numColumns = parameters.size();
+    numPresets = numFactory + numUserPresets;
+    table = std::make_unique<std::atomic<float>[]>((size_t)(numPresets * numColumns));
+
+    for (int index = 0; index < numFactory; ++index)
+    {
+        for (int column = 0; column < numColumns; ++column)
+        {
+            const auto* parameter = parameters[column];
+            table[(size_t)(index * numColumns + column)] = parameter->convertFrom0to1(parameter->getDefaultValue());
+        }
+
+        for (const auto& setting : factoryPresets[index].settings)
+        {
+            const int column = getColumn(setting.parameterID);
+            jassert(column >= 0); // a factory preset names a parameter that doesn't exist
+
+            if (column >= 0)
+                table[(size_t)(index * numColumns + column)] = setting.value;
+        }
+    }
+
+    for (int index = numFactory; index < numPresets; ++index)
+        clearUserPreset(index);
+}
+
+int PresetBank::getNumFactoryPresets() noexcept
+{
+    return numFactory;
+}
+
+juce::StringArray PresetBank::getDefaultNames()
+{
+    juce::StringArray names;
+
+    for (const auto& preset : factoryPresets)
+        names.add(preset.name);
+
+    for (int i = 1; i <= numUserPresets; ++i)
+        names.add("User " + juce::String(i));
+
+    return names;
+}
+
+juce::String PresetBank::getName(int index) const
+{
+    if (juce::isPositiveAndBelow(index, numFactory))
+        return factoryPresets[index].name;
+
+    if (! isUserPreset(index))
+        return {};
+
+    const juce::SpinLock::ScopedLockType lock(namesLock);
+    return userNames[index - numFactory];
+}
+
+void PresetBank::setName(int index, const juce::String& name)
+{
+    if (isUserPreset(index))
+        setUserName(index - numFactory, name);
+}
+
+void PresetBank::setUserName(int userIndex, const juce::String& name)
+{
+    {
+        const juce::SpinLock::ScopedLockType lock(namesLock);
+        userNames.set(userIndex, name);
+    }
+
+    ++namesVersion;
+}
+
+bool PresetBank::isPresetParameter(const juce::String& parameterID) noexcept
+{
+    for (const char* control : morphControls)
+        if (parameterID == control)
+            return false;
+
+    return true;
+}
+
+int PresetBank::getColumn(const juce::String& parameterID) const noexcept
+{
+    for (int column = 0; column < numColumns; ++column)
+        if (parameters[column]->paramID == parameterID)
+            return column;
+
+    return -1;
+}
+
+void PresetBank::setCurrent(int index) noexcept
+{
+    if (juce::isPositiveAndBelow(index, numPresets))
+        current = index;
+}
+
+void PresetBank::apply(int index)
+{
+    JUCE_ASSERT_MESSAGE_THREAD
+
+    if (! juce::isPositiveAndBelow(index, numPresets))
+        return;
+
+    for (int column = 0; column < numColumns; ++column)
+    {
+        auto* parameter = parameters[column];
+        const float normalised = parameter->convertTo0to1(getValue(index, column));
+
+        if (parameter->getValue() != normalised)
+        {
+            parameter->beginChangeGesture();
+            parameter->setValueNotifyingHost(normalised);
+            parameter->endChangeGesture();
+        }
+    }
+}
+
+void PresetBank::store(int index, const juce::String& name)
+{
+    if (! isUserPreset(index))
+        return;
+
+    for (int column = 0; column < numColumns; ++column)
+    {
+        const auto* parameter = parameters[column];
+        table[(size_t)(index * numColumns + column)] = parameter->convertFrom0to1(parameter->getValue());
+    }
+
+    setUserName(index - numFactory, name);
+    userStored[index - numFactory] = true;
+}
+
+void PresetBank::clearUserPreset(int index)
+{
+    for (int column = 0; column < numColumns; ++column)
+    {
+        const auto* parameter = parameters[column];
+        table[(size_t)(index * numColumns + column)] = parameter->convertFrom0to1(parameter->getDefaultValue());
+    }
+
+    setUserName(index - numFactory, "User " + juce::String(index - numFactory + 1));
+    userStored[index - numFactory] = false;
+}
+
+void PresetBank::writeState(juce::MemoryBlock& destination) const
+{
+    const bool anyStored = std::any_of(std::begin(userStored), std::end(userStored), [](bool stored) { return stored; });
+    if (getCurrent() == 0 && ! anyStored)
+        return;
+
+    // Values by parameter ID, so a later parameter layout can still read them
+    juce::ValueTree bank(bankType);
+    bank.setProperty(currentProperty, getCurrent(), nullptr);
+
+    for (int i = 0; i < numUserPresets; ++i)
+    {
+        if (! userStored[i])
+            continue;
+
+        juce::ValueTree preset(presetType);
+        preset.setProperty(indexProperty, i, nullptr);
+        preset.setProperty(nameProperty, getName(numFactory + i), nullptr);
+
+        for (int column = 0; column < numColumns; ++column)
+            preset.setProperty(parameters[column]->paramID, getValue(numFactory + i, column), nullptr);
+
+        bank.appendChild(preset, nullptr);
+    }
+
+    juce::MemoryOutputStream stream(destination, true);
+    bank.writeToStream(stream);
+}
+
+void PresetBank::readState(const void* data, size_t sizeInBytes)
+{
+    for (int index = numFactory; index < numPresets; ++index)
+        clearUserPreset(index);
+
+    current = 0;
+
+    const auto bank = data != nullptr && sizeInBytes > 0 ? juce::ValueTree::readFromData(data, sizeInBytes) : juce::ValueTree();
+    if (! bank.hasType(bankType))
+        return;
+
+    for (const auto& preset : bank)
+    {
+        const int i = preset.getProperty(indexProperty, -1);
+        if (! preset.hasType(presetType) || ! juce::isPositiveAndBelow(i, numUserPresets))
+            continue;
+
+        // Parameters the preset doesn't mention keep their defaults
+        for (int column = 0; column < numColumns; ++column)
+            if (const auto* value = preset.getPropertyPointer(parameters[column]->paramID))
+                if (std::isfinite((float)*value))
+                    table[(size_t)((numFactory + i) * numColumns + column)] = (float)*value;
+
+        setUserName(i, preset.getProperty(nameProperty).toString());
+        userStored[i] = true;
+    }
+
+    current = juce::jlimit(0, numPresets - 1, (int)bank.getProperty(currentProperty, 0));
+}
@@ -0,0 +1,102 @@
+#pragma once
+#include <juce_audio_processors/juce_audio_processors.h>
+
+// Factory and user presets, exposed to the host as programs.
+//
+// Every preset is a row of a table built once at construction: one value per
+// preset parameter, in the parameters' own units. Factory rows are compiled from
+// the defaults plus each preset's settings; user rows start as the defaults and
+// are overwritten by store(). The cells are atomic, so the audio thread can read
+// any preset (the A/B morph does, see ParameterSnapshot) while the message
+// thread stores another.
+//
+// A program change has two halves. setCurrent() only stores the index, so
+// any thread may call it, and ParameterSnapshot::followPreset() makes the audio
+// read the row straight from the table from the next block on. apply() then
+// copies the row into the parameters so the host and editor see it; that
+// notifies the host and the parameter listeners, so it belongs on the message
+// thread (the processor defers it there, see setCurrentProgram()).
+//
+// The morph controls themselves ("morphTime" and the A/B parameters) are not
+// part of any preset.
+//
+// Names may be read from any thread (hosts ask for program names and parameter
+// text from their own threads); getNamesVersion() changes whenever one does, so
+// the editor and the A/B choices can follow renamed and stored presets.
+class PresetBank
+{
+public:
+    static constexpr int numUserPresets = 8;
+
+    // Collects the processor's parameters in getParameters() order and compiles
+    // the table; call once every parameter has been added
+    explicit PresetBank(juce::AudioProcessor& processor);
+
+    // Factory presets, then user presets
+    static int getNumFactoryPresets() noexcept;
+    int getNumPresets() const noexcept { return numPresets; }
+    bool isUserPreset(int index) const noexcept { return index >= getNumFactoryPresets() && index < numPresets; }
+
+    // The default names, for the A/B preset choices built before any bank exists
+    static juce::StringArray getDefaultNames();
+
+    juce::String getName(int index) const;
+
+    // Renames a user preset; factory names stay
+    void setName(int index, const juce::String& name);
+
+    // Goes up by one whenever a name changes
+    int getNamesVersion() const noexcept { return namesVersion.load(); }
+
+    // False for the morph controls, which no preset sets
+    static bool isPresetParameter(const juce::String& parameterID) noexcept;
+
+    // Column of a preset parameter in the table; -1 if it isn't one
+    int getColumn(const juce::String& parameterID) const noexcept;
+
+    // A preset's value for a column, in the parameter's own units; any thread
+    float getValue(int index, int column) const noexcept
+    {
+        return table[(size_t)(index * numColumns + column)].load(std::memory_order_relaxed);
+    }
+
+    // Makes a preset current without touching the parameters; any thread
+    void setCurrent(int index) noexcept;
+    int getCurrent() const noexcept { return current.load(); }
+
+    // Sets every preset parameter that differs to the preset's value, each as a
+    // one-step change gesture; message thread
+    void apply(int index);
+
+    // Copies the current parameter values into a user preset; message thread
+    void store(int index, const juce::String& name);
+
+    // Appends the current preset and the stored user presets to destination;
+    // nothing when both are as constructed
+    void writeState(juce::MemoryBlock& destination) const;
+
+    // Restores what writeState() appended; anything else (including nothing)
+    // returns the user presets to their defaults and selects the first preset
+    // without touching the parameters
+    void readState(const void* data, size_t sizeInBytes);
+
+private:
+    juce::Array<juce::RangedAudioParameter*> parameters; // one per column
+    int numColumns = 0, numPresets = 0;
+
+    std::unique_ptr<std::atomic<float>[]> table;
+
+    // Held only to copy a name in or out, which doesn't allocate
+    juce::SpinLock namesLock;
+    juce::StringArray userNames;
+    std::atomic<int> namesVersion { 0 };
+    bool userStored[numUserPresets] = {};
+    std::atomic<int> current { 0 };
+
+    // Fills a user row with the defaults
+    void clearUserPreset(int index);
+
+    void setUserName(int userIndex, const juce::String& name);
+
+    JUCE_DECLARE_NON_COPYABLE(PresetBank)
+};
@@ -0,0 +1,214 @@
+#include "SpectrumAnalyser.h"
+#include "BandEngine.h"
+
+namespace
+{
+    // Band edges and slots of a layout, low to high; edges has numBands + 1 entries
+    template <int NumBands>
+    void getBandRanges(double nyquist, float* edges, int* slots)
+    {
+        using Layout = BandLayout<NumBands>;
+
+        edges[0] = 20.0f;
+        for (int b = 0; b < NumBands - 1; ++b)
+            edges[b + 1] = Layout::crossovers[b];
+        edges[NumBands] = (float)juce::jmin(20000.0, nyquist);
+
+        for (int b = 0; b < NumBands; ++b)
+            slots[b] = Layout::slots[b];
+    }
+}
+
+SpectrumAnalyser::SpectrumAnalyser()
+    : juce::Thread("Spectrum analyser"),
+      fifoBuffer((size_t)fifoSize, 0.0f),
+      history((size_t)fftSize, 0.0f),
+      fftData((size_t)(2 * fftSize), 0.0f),
+      smoothedDb((size_t)(fftSize / 2 + 1), floorDb)
+{
+}
+
+SpectrumAnalyser::~SpectrumAnalyser()
+{
+    stop();
+}
+
+void SpectrumAnalyser::start(int framesPerSecond)
+{
+    stop();
+
+    frameIntervalMs = juce::jmax(1, 1000 / juce::jmax(1, framesPerSecond));
+
+    // Anything still queued is from before the last stop()
+    fifo.finishedRead(fifo.getNumReady());
+    std::fill(history.begin(), history.end(), 0.0f);
+    std::fill(smoothedDb.begin(), smoothedDb.end(), floorDb);
+
+    {
+        const juce::SpinLock::ScopedLockType lock(frameLock);
+        latestFrame = {};
+        hasNewFrame = false;
+    }
+
+    active.store(true, std::memory_order_release);
+    startThread();
+}
+
+void SpectrumAnalyser::stop()
+{
+    active.store(false, std::memory_order_release);
+    stopThread(1000);
+}
+
+template <typename SampleType>
+void SpectrumAnalyser::pushSamples(const juce::AudioBuffer<SampleType>& buffer, int numChannels) noexcept
+{
+    if (! active.load(std::memory_order_acquire) || numChannels <= 0)
+        return;
+
+    const int numSamples = juce::jmin(buffer.getNumSamples(), fifo.getFreeSpace());
+    const float scale = 1.0f / (float)numChannels;
+    const auto scope = fifo.write(numSamples);
+
+    // Mono mix straight into the ring, in its (up to) two runs
+    auto mix = [&](int start, int size, int sourceOffset)
+    {
+        if (size <= 0)
+            return;
+
+        float* destination = fifoBuffer.data() + start;
+        const SampleType* first = buffer.getReadPointer(0, sourceOffset);
+
+        for (int i = 0; i < size; ++i)
+            destination[i] = (float)first[i];
+
+        for (int ch = 1; ch < numChannels; ++ch)
+        {
+            const SampleType* source = buffer.getReadPointer(ch, sourceOffset);
+
+            for (int i = 0; i < size; ++i)
+                destination[i] += (float)source[i];
+        }
+
+        for (int i = 0; i < size; ++i)
+            destination[i] *= scale;
+    };
+
+    mix(scope.startIndex1, scope.blockSize1, 0);
+    mix(scope.startIndex2, scope.blockSize2, scope.blockSize1);
+}
+
+template void SpectrumAnalyser::pushSamples<float>(const juce::AudioBuffer<float>&, int) noexcept;
+template void SpectrumAnalyser::pushSamples<double>(const juce::AudioBuffer<double>&, int) noexcept;
+
+bool SpectrumAnalyser::getLatestFrame(Frame& destination)
+{
+    const juce::SpinLock::ScopedLockType lock(frameLock);
+
+    if (! hasNewFrame)
+        return false;
+
+    destination = latestFrame;
+    hasNewFrame = false;
+    return true;
+}
+
+void SpectrumAnalyser::run()
+{
+    while (! threadShouldExit())
+    {
+        if (readFifo())
+            analyse();
+
+        wait(frameIntervalMs);
+    }
+}
+
+bool SpectrumAnalyser::readFifo()
+{
+    const int numReady = fifo.getNumReady();
+    if (numReady == 0)
+        return false;
+
+    // Only the newest fftSize samples matter; older ones are skipped
+    const int numToKeep = juce::jmin(numReady, fftSize);
+    fifo.finishedRead(numReady - numToKeep);
+
+    std::copy(history.begin() + numToKeep, history.end(), history.begin());
+
+    const auto scope = fifo.read(numToKeep);
+    auto destination = history.end() - numToKeep;
+    destination = std::copy(fifoBuffer.data() + scope.startIndex1, fifoBuffer.data() + scope.startIndex1 + scope.blockSize1, destination);
+    std::copy(fifoBuffer.data() + scope.startIndex2, fifoBuffer.data() + scope.startIndex2 + scope.blockSize2, destination);
+    return true;
+}
+
+void SpectrumAnalyser::analyse()
+{
+    std::copy(history.begin(), history.end(), fftData.begin());
+    std::fill(fftData.begin() + fftSize, fftData.end(), 0.0f);
+
+    window.multiplyWithWindowingTable(fftData.data(), (size_t)fftSize);
+    fft.performFrequencyOnlyForwardTransform(fftData.data(), true);
+
+    // A full-scale sine peaks at fftSize / 4 through the Hann window. Bins rise
+    // at once and fall with a time constant of releaseSeconds.
+    const float framesPerSecond = 1000.0f / (float)frameIntervalMs;
+    const float release = std::exp(-1.0f / (releaseSeconds * framesPerSecond));
+    const float normalise = 4.0f / (float)fftSize;
+
+    for (size_t bin = 0; bin < smoothedDb.size(); ++bin)
+    {
+        const float db = juce::Decibels::gainToDecibels(fftData[bin] * normalise, floorDb);
+        smoothedDb[bin] = db > smoothedDb[bin] ? db : db + (smoothedDb[bin] - db) * release;
+    }
+
+    computeBars(sampleRate.load());
+
+    const juce::SpinLock::ScopedLockType lock(frameLock);
+    latestFrame = workFrame;
+    hasNewFrame = true;
+}
+
+void SpectrumAnalyser::computeBars(double currentSampleRate)
+{
+    float edges[ParameterSnapshot::numBandSlots + 1] = {};
+    int slots[ParameterSnapshot::numBandSlots] = {};
+    const double nyquist = currentSampleRate * 0.5;
+    const int bands = juce::jlimit(3, 5, numBands.load(std::memory_order_relaxed));
+
+    switch (bands)
+    {
+        case 4:  getBandRanges<4>(nyquist, edges, slots); break;
+        case 5:  getBandRanges<5>(nyquist, edges, slots); break;
+        default: getBandRanges<3>(nyquist, edges, slots); break;
+    }
+
+    workFrame = {};
+
+    const double binsPerHz = (double)fftSize / currentSampleRate;
+    const int lastBin = (int)smoothedDb.size() - 1;
+
+    for (int b = 0; b < bands; ++b)
+    {
+        const double logLow = std::log((double)edges[b]);
+        const double logStep = (std::log((double)edges[b + 1]) - logLow) / numBars;
+        float* bars = workFrame.bars[slots[b]];
+
+        for (int bar = 0; bar < numBars; ++bar)
+        {
+            // The loudest bin in the bar's range, or the nearest bin if the range
+            // falls between two (low frequencies)
+            const double from = std::exp(logLow + logStep * bar) * binsPerHz;
+            const double to = std::exp(logLow + logStep * (bar + 1)) * binsPerHz;
+            const int firstBin = juce::jlimit(0, lastBin, (int)std::ceil(from));
+            const int endBin = juce::jlimit(0, lastBin, (int)std::floor(to));
+
+            float db = smoothedDb[(size_t)juce::jlimit(0, lastBin, juce::roundToInt((from + to) * 0.5))];
+            for (int bin = firstBin; bin <= endBin; ++bin)
+                db = juce::jmax(db, smoothedDb[(size_t)bin]);
+
+            bars[bar] = juce::jlimit(0.0f, 1.0f, (db - floorDb) / -floorDb);
+        }
+    }
+}
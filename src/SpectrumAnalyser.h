@@ -0,0 +1,85 @@
+#pragma once
+#include <juce_dsp/juce_dsp.h>
+#include "ParameterSnapshot.h"
+
+// FFT spectrum of the processor's output, split into the bands of the current
+// crossover layout, for the editor's band displays.
+//
+// The audio thread only copies a mono mix into a lock-free FIFO, and only while
+// the analyser runs. A background thread windows the latest fftSize samples at a
+// fixed frame rate, transforms them, smooths the bins and reduces each band's
+// frequency range to numBars log-spaced bars. The editor starts the analyser when
+// it opens and stops it when it closes, so a closed editor costs the audio thread
+// one atomic load per block.
+class SpectrumAnalyser : private juce::Thread
+{
+public:
+    static constexpr int fftOrder = 12;
+    static constexpr int fftSize = 1 << fftOrder;
+    static constexpr int numBars = 30;
+
+    // Bars per band slot, 0 (floor) to 1 (0 dBFS); slots outside the layout stay 0
+    struct Frame
+    {
+        float bars[ParameterSnapshot::numBandSlots][numBars] = {};
+    };
+
+    SpectrumAnalyser();
+    ~SpectrumAnalyser() override;
+
+    // Message thread: starts or stops the analysis thread and the audio-thread copy
+    void start(int framesPerSecond);
+    void stop();
+    bool isRunning() const noexcept { return active.load(std::memory_order_relaxed); }
+
+    // Call from prepareToPlay
+    void setSampleRate(double newSampleRate) noexcept { sampleRate.store(newSampleRate); }
+
+    // Audio thread: the band layout the bars are split by (3, 4 or 5 bands)
+    void setNumBands(int newNumBands) noexcept { numBands.store(newNumBands, std::memory_order_relaxed); }
+
+    // Audio thread: mixes the first numChannels channels of buffer into the FIFO.
+    // Returns at once while the analyser is stopped; drops samples if it is full.
+    // Instantiated for float and double.
+    template <typename SampleType>
+    void pushSamples(const juce::AudioBuffer<SampleType>& buffer, int numChannels) noexcept;
+
+    // Copies the latest frame; returns false if none arrived since the last call
+    bool getLatestFrame(Frame& destination);
+
+private:
+    static constexpr int fifoSize = 4 * fftSize;
+    static constexpr float floorDb = -90.0f;
+    static constexpr float releaseSeconds = 0.3f;
+
+    std::atomic<bool> active { false };
+    std::atomic<double> sampleRate { 48000.0 };
+    std::atomic<int> numBands { 3 };
+    int frameIntervalMs = 33;
+
+    // Audio thread -> analysis thread
+    juce::AbstractFifo fifo { fifoSize };
+    std::vector<float> fifoBuffer;
+
+    // Analysis thread only
+    juce::dsp::FFT fft { fftOrder };
+    juce::dsp::WindowingFunction<float> window { (size_t)fftSize, juce::dsp::WindowingFunction<float>::hann, false };
+    std::vector<float> history;      // last fftSize samples, oldest first
+    std::vector<float> fftData;      // 2 * fftSize, as performFrequencyOnlyForwardTransform needs
+    std::vector<float> smoothedDb;   // fftSize / 2 + 1 bins
+    Frame workFrame;
+
+    // Analysis thread -> message thread
+    juce::SpinLock frameLock;
+    Frame latestFrame;                // guarded by frameLock
+    bool hasNewFrame = false;         // guarded by frameLock
+
+    void run() override;
+
+    // Reads what the audio thread queued; returns false if there was nothing
+    bool readFifo();
+    void analyse();
+    void computeBars(double currentSampleRate);
+
+    JUCE_DECLARE_NON_COPYABLE(SpectrumAnalyser)
+};
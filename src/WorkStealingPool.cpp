@@ -0,0 +1,192 @@
+#include "WorkStealingPool.h"
+
+namespace
+{
+    // Identifies a pool's worker threads, so nested parallelFor calls use their own range
+    thread_local const WorkStealingPool* currentPool = nullptr;
+    thread_local int currentSlot = -1;
+
+    constexpr juce::uint64 packRange(juce::uint32 begin, juce::uint32 end) noexcept
+    {
+        return (juce::uint64)begin | ((juce::uint64)end << 32);
+    }
+}
+
+WorkStealingPool::WorkStealingPool(int numThreads)
+{
+    for (int slot = 0; slot < numThreads - 1; ++slot)
+        workers.emplace_back([this, slot] { workerLoop(slot); });
+}
+
+WorkStealingPool::~WorkStealingPool()
+{
+    {
+        const std::lock_guard<std::mutex> lock(mutex);
+        shouldExit = true;
+    }
+
+    wakeUp.notify_all();
+
+    for (auto& worker : workers)
+        worker.join();
+}
+
+int WorkStealingPool::getCallerSlot() const noexcept
+{
+    return currentPool == this ? currentSlot : (int)workers.size();
+}
+
+void WorkStealingPool::run(int numTasks, Invoke invoke, void* context)
+{
+    const int numSlots = getNumThreads();
+
+    Job job;
+    job.invoke = invoke;
+    job.context = context;
+    job.ranges = std::vector<std::atomic<juce::uint64>>((size_t)numSlots);
+    job.remaining = numTasks;
+
+    // Equal contiguous ranges; stealing evens out tasks of different cost
+    for (int slot = 0; slot < numSlots; ++slot)
+        job.ranges[(size_t)slot] = packRange((juce::uint32)(numTasks * slot / numSlots),
+                                             (juce::uint32)(numTasks * (slot + 1) / numSlots));
+
+    {
+        const std::lock_guard<std::mutex> lock(mutex);
+        activeJobs.push_back(&job);
+    }
+
+    wakeUp.notify_all();
+
+    work(job, getCallerSlot());
+
+    // Everything is claimed; wait for tasks still running on workers
+    while (job.remaining.load(std::memory_order_acquire) > 0)
+        std::this_thread::yield();
+
+    {
+        const std::lock_guard<std::mutex> lock(mutex);
+        activeJobs.erase(std::find(activeJobs.begin(), activeJobs.end(), &job));
+    }
+
+    // No worker can pick the job up any more; let the ones inside leave
+    while (job.visitors.load(std::memory_order_acquire) > 0)
+        std::this_thread::yield();
+}
+
+void WorkStealingPool::workerLoop(int slot)
+{
+    currentPool = this;
+    currentSlot = slot;
+
+    std::unique_lock<std::mutex> lock(mutex);
+
+    while (! shouldExit)
+    {
+        Job* job = nullptr;
+        for (auto* candidate : activeJobs)
+        {
+            if (hasWork(*candidate))
+            {
+                job = candidate;
+                break;
+            }
+        }
+
+        if (job == nullptr)
+        {
+            wakeUp.wait(lock);
+            continue;
+        }
+
+        job->visitors.fetch_add(1, std::memory_order_relaxed);
+        lock.unlock();
+
+        work(*job, slot);
+
+        job->visitors.fetch_sub(1, std::memory_order_release);
+        lock.lock();
+    }
+}
+
+void WorkStealingPool::work(Job& job, int slot) noexcept
+{
+    const int numSlots = (int)job.ranges.size();
+    int index = 0;
+
+    auto runTask = [&job](int taskIndex)
+    {
+        job.invoke(job.context, taskIndex);
+        job.remaining.fetch_sub(1, std::memory_order_release);
+    };
+
+    while (claimFront(job.ranges[(size_t)slot], index))
+        runTask(index);
+
+    // Own range is empty: steal single tasks from the back of the others
+    for (bool stole = true; stole;)
+    {
+        stole = false;
+
+        for (int offset = 1; offset < numSlots && ! stole; ++offset)
+        {
+            if (claimBack(job.ranges[(size_t)((slot + offset) % numSlots)], index))
+            {
+                runTask(index);
+                stole = true;
+            }
+        }
+    }
+}
+
+bool WorkStealingPool::hasWork(const Job& job) noexcept
+{
+    for (const auto& range : job.ranges)
+    {
+        const auto packed = range.load(std::memory_order_relaxed);
+        if ((juce::uint32)packed < (juce::uint32)(packed >> 32))
+            return true;
+    }
+
+    return false;
+}
+
+bool WorkStealingPool::claimFront(std::atomic<juce::uint64>& range, int& index) noexcept
+{
+    auto packed = range.load(std::memory_order_acquire);
+
+    for (;;)
+    {
+        const auto begin = (juce::uint32)packed;
+        const auto end = (juce::uint32)(packed >> 32);
+
+        if (begin >= end)
+            return false;
+
+        if (range.compare_exchange_weak(packed, packRange(begin + 1, end), std::memory_order_acq_rel))
+        {
+            index = (int)begin;
+            return true;
+        }
+    }
+}
+
+bool WorkStealingPool::claimBack(std::atomic<juce::uint64>& range, int& index) noexcept
+{
+    auto packed = range.load(std::memory_order_acquire);
+
+    for (;;)
+    {
+        const auto begin = (juce::uint32)packed;
+        const auto end = (juce::uint32)(packed >> 32);
+
+        if (begin >= end)
+            return false;
+
+        if (range.compare_exchange_weak(packed, packRange(begin, end - 1), std::memory_order_acq_rel))
+        {
+            index = (int)end - 1;
+            return true;
+        }
+    }
+}
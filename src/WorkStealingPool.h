@@ -0,0 +1,79 @@
+#pragma once
+#include <juce_core/juce_core.h>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Fixed set of worker threads for splitting one offline block into independent
+// tasks (channel groups, band/channel lanes).
+//
+// parallelFor() deals the task indices out as one contiguous range per thread;
+// each thread takes tasks from the front of its own range and, once that is
+// empty, steals from the back of the others'. The calling thread works too, and
+// a task may itself call parallelFor() (nested jobs share the same workers).
+//
+// Tasks must write disjoint data. The pool only changes which thread runs a
+// task, never what it computes, so results match a serial loop bit for bit.
+// It blocks and locks, so it is for non-realtime processing only.
+class WorkStealingPool
+{
+public:
+    // numThreads includes the calling thread, so 1 means no workers
+    explicit WorkStealingPool(int numThreads);
+    ~WorkStealingPool();
+
+    int getNumThreads() const noexcept { return (int)workers.size() + 1; }
+
+    // Calls task(index) for every index in [0, numTasks) and returns when all are done
+    template <typename Task>
+    void parallelFor(int numTasks, Task&& task)
+    {
+        if (numTasks <= 1 || workers.empty())
+        {
+            for (int i = 0; i < numTasks; ++i)
+                task(i);
+
+            return;
+        }
+
+        run(numTasks, [](void* context, int index) { (*static_cast<std::remove_reference_t<Task>*>(context))(index); },
+            (void*)std::addressof(task));
+    }
+
+private:
+    using Invoke = void (*)(void* context, int index);
+
+    // One parallelFor call. Each slot (thread) owns a range [begin, end), packed
+    // into one atomic so that the owner (front) and thieves (back) never race.
+    struct Job
+    {
+        Invoke invoke = nullptr;
+        void* context = nullptr;
+        std::vector<std::atomic<juce::uint64>> ranges;
+        std::atomic<int> remaining { 0 };
+        std::atomic<int> visitors { 0 }; // workers currently inside this job
+    };
+
+    std::vector<std::thread> workers;
+
+    std::mutex mutex;
+    std::condition_variable wakeUp;
+    std::vector<Job*> activeJobs; // guarded by mutex
+    bool shouldExit = false;      // guarded by mutex
+
+    void run(int numTasks, Invoke invoke, void* context);
+    void workerLoop(int slot);
+
+    // The calling thread's range: its own if it is one of this pool's workers
+    int getCallerSlot() const noexcept;
+
+    // Runs tasks of job from slot's range, then steals; returns when none are left to claim
+    static void work(Job& job, int slot) noexcept;
+    static bool hasWork(const Job& job) noexcept;
+    static bool claimFront(std::atomic<juce::uint64>& range, int& index) noexcept;
+    static bool claimBack(std::atomic<juce::uint64>& range, int& index) noexcept;
+
+    JUCE_DECLARE_NON_COPYABLE(WorkStealingPool)
+};
@@ -0,0 +1,386 @@
+// Offline batch renderer for MakeItHappenOTTProcessor.
+//
+// Renders every input file through its own processor instance, restored from a
+// saved plugin state (the getStateInformation() blob), on a fixed-size thread
+// pool. Files are started longest first so the pool stays busy until the end.
+// Output is WAV at the input's sample rate, channel count and bit depth, with
+// the processor's latency removed. With fewer files than threads, the spare
+// threads go to each processor's offline pool (setOfflineThreads), which splits
+// a file's channel groups and bands without changing its output.
+//
+//   MakeItHappenOTTBatchRenderer --output DIR [--state FILE] [--threads N] [--block B]
+//                                [--control-interval N] INPUT...
+//
+// INPUT may be audio files or directories (searched recursively). Files found in
+// a directory keep their path below it in DIR. Nothing is rendered if two inputs
+// would write the same output, or an output would overwrite an input.
+
+#include "../src/PluginProcessor.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <map>
+#include <set>
+#include <vector>
+
+namespace
+{
+    struct RenderTask
+    {
+        juce::File input;
+        juce::File output;
+        double sampleRate = 0.0;
+        int numChannels = 0;
+        int bitsPerSample = 24;
+        juce::int64 lengthInSamples = 0;
+
+        double getSeconds() const { return sampleRate > 0.0 ? (double)lengthInSamples / sampleRate : 0.0; }
+    };
+
+    struct Progress
+    {
+        std::atomic<juce::int64> microsecondsRendered { 0 }; // of input audio
+        std::atomic<int> filesDone { 0 };
+        std::atomic<int> filesFailed { 0 };
+        juce::CriticalSection printLock;
+    };
+
+    void printUsage()
+    {
+        std::printf("usage: MakeItHappenOTTBatchRenderer --output DIR [--state FILE] [--threads N] [--block B]\n"
+                    "                                    [--control-interval N] INPUT...\n"
+                    "  INPUT     audio files, or directories searched recursively (their subdirectories\n"
+                    "            are kept under --output)\n"
+                    "  --state   plugin state saved by the plugin (getStateInformation); defaults if omitted\n"
+                    "  --threads worker threads (default: one per core)\n"
+                    "  --block   processing block size (default 512)\n"
+                    "  --control-interval\n"
+                    "            samples per gain computer update: 1 (default, exact), 4, 8, 16 or 32 (faster)\n");
+    }
+
+    // Bus layout the processor gets for a file's channel count
+    juce::AudioChannelSet getLayoutForChannels(int numChannels)
+    {
+        switch (numChannels)
+        {
+            case 6:  return juce::AudioChannelSet::create5point1();
+            case 8:  return juce::AudioChannelSet::create7point1();
+            case 12: return juce::AudioChannelSet::create7point1point4();
+            default: break;
+        }
+
+        return juce::AudioChannelSet::canonicalChannelSet(numChannels);
+    }
+
+    struct InputFile
+    {
+        juce::File file;
+        juce::String relativePath; // below the directory it was found in, or the file name
+    };
+
+    void addInputFiles(const juce::File& file, const juce::String& wildcard, std::vector<InputFile>& files)
+    {
+        if (file.isDirectory())
+        {
+            for (const auto& entry : juce::RangedDirectoryIterator(file, true, wildcard, juce::File::findFiles))
+                files.push_back({ entry.getFile(), entry.getFile().getRelativePathFrom(file) });
+        }
+        else if (file.existsAsFile())
+        {
+            files.push_back({ file, file.getFileName() });
+        }
+        else
+        {
+            std::printf("skipping %s: not found\n", file.getFullPathName().toRawUTF8());
+        }
+    }
+
+    // A path to compare files by, case-folded where the file system ignores case
+    juce::String getPathKey(const juce::File& file)
+    {
+        const auto path = file.getFullPathName();
+        return juce::File::areFileNamesCaseSensitive() ? path : path.toLowerCase();
+    }
+
+    // Renders one file; returns an error message, or an empty string on success
+    juce::String render(const RenderTask& task, const juce::MemoryBlock& state, int blockSize, int controlInterval,
+                        int threadsPerFile, Progress& progress)
+    {
+        juce::AudioFormatManager formats;
+        formats.registerBasicFormats();
+
+        std::unique_ptr<juce::AudioFormatReader> reader(formats.createReaderFor(task.input));
+        if (reader == nullptr)
+            return "cannot read file";
+
+        MakeItHappenOTTProcessor processor;
+
+        juce::AudioProcessor::BusesLayout buses;
+        buses.inputBuses.add(getLayoutForChannels(task.numChannels));
+        buses.outputBuses.add(getLayoutForChannels(task.numChannels));
+        if (! processor.setBusesLayout(buses))
+            return "unsupported channel count " + juce::String(task.numChannels);
+
+        if (! state.isEmpty())
+            processor.setStateInformation(state.getData(), (int)state.getSize());
+
+        // Non-realtime before prepareToPlay, so the linear-phase kernels are ready
+        // and the offline pool is created
+        processor.setOfflineThreads(threadsPerFile);
+        processor.setGainControlInterval(controlInterval);
+        processor.setNonRealtime(true);
+        processor.setRateAndBufferSizeDetails(task.sampleRate, blockSize);
+        processor.prepareToPlay(task.sampleRate, blockSize);
+
+        if (! task.output.getParentDirectory().createDirectory())
+            return "cannot create " + task.output.getParentDirectory().getFullPathName();
+
+        task.output.deleteFile();
+        auto stream = task.output.createOutputStream();
+        if (stream == nullptr)
+            return "cannot create " + task.output.getFullPathName();
+
+        juce::WavAudioFormat wav;
+        std::unique_ptr<juce::AudioFormatWriter> writer(wav.createWriterFor(stream.get(), task.sampleRate,
+                                                                            (unsigned int)task.numChannels,
+                                                                            task.bitsPerSample, {}, 0));
+        if (writer == nullptr)
+            return "cannot write WAV with these settings";
+
+        stream.release(); // now owned by the writer
+
+        // Feed latency's worth of extra silence and drop as much from the start,
+        // so the output lines up with the input
+        int samplesToSkip = processor.getLatencySamples();
+        juce::AudioBuffer<float> buffer(task.numChannels, blockSize);
+        juce::MidiBuffer midi;
+        juce::int64 readPosition = 0, written = 0;
+
+        while (written < task.lengthInSamples)
+        {
+            buffer.clear();
+
+            const int available = (int)juce::jlimit((juce::int64)0, (juce::int64)blockSize, task.lengthInSamples - readPosition);
+            if (available > 0)
+                reader->read(&buffer, 0, available, readPosition, true, true);
+
+            readPosition += blockSize;
+            processor.processBlock(buffer, midi);
+
+            const int skipped = juce::jmin(samplesToSkip, blockSize);
+            samplesToSkip -= skipped;
+
+            const int count = (int)juce::jmin((juce::int64)(blockSize - skipped), task.lengthInSamples - written);
+            if (count > 0 && ! writer->writeFromAudioSampleBuffer(buffer, skipped, count))
+                return "write failed";
+
+            written += juce::jmax(0, count);
+            progress.microsecondsRendered += (juce::int64)((double)available * 1.0e6 / task.sampleRate);
+        }
+
+        processor.releaseResources();
+        return {};
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    juce::ScopedJuceInitialiser_GUI juceInitialiser;
+    juce::ArgumentList args(argc, argv);
+
+    if (args.containsOption("--help|-h") || ! args.containsOption("--output"))
+    {
+        printUsage();
+        return args.containsOption("--help|-h") ? 0 : 1;
+    }
+
+    const auto outputDirectory = args.getFileForOptionAndRemove("--output");
+    if (! outputDirectory.createDirectory())
+    {
+        std::printf("cannot create output directory %s\n", outputDirectory.getFullPathName().toRawUTF8());
+        return 1;
+    }
+
+    juce::MemoryBlock state;
+    if (args.containsOption("--state"))
+    {
+        const auto stateFile = args.getFileForOptionAndRemove("--state");
+        if (! stateFile.loadFileAsData(state))
+        {
+            std::printf("cannot read state %s\n", stateFile.getFullPathName().toRawUTF8());
+            return 1;
+        }
+    }
+
+    int numThreads = juce::SystemStats::getNumCpus();
+    if (args.containsOption("--threads"))
+        numThreads = juce::jmax(1, args.removeValueForOption("--threads").getIntValue());
+
+    int blockSize = 512;
+    if (args.containsOption("--block"))
+        blockSize = juce::jmax(16, args.removeValueForOption("--block").getIntValue());
+
+    int controlInterval = 1;
+    if (args.containsOption("--control-interval"))
+        controlInterval = juce::jlimit(1, CompressorKernelBase::maxControlInterval,
+                                       juce::nextPowerOfTwo(args.removeValueForOption("--control-interval").getIntValue()));
+
+    // Everything left is an input
+    juce::AudioFormatManager formats;
+    formats.registerBasicFormats();
+
+    std::vector<InputFile> inputFiles;
+    for (const auto& argument : args.arguments)
+        addInputFiles(argument.resolveAsFile(), formats.getWildcardForAllFormats(), inputFiles);
+
+    // Every input, also the unreadable ones, so no output can replace any of them
+    std::set<juce::String> inputPaths;
+    for (const auto& input : inputFiles)
+        inputPaths.insert(getPathKey(input.file));
+
+    std::vector<RenderTask> tasks;
+    std::set<juce::String> queued;
+    double totalSeconds = 0.0;
+
+    for (const auto& [file, relativePath] : inputFiles)
+    {
+        // Named twice (or also through its directory): rendered once
+        if (! queued.insert(getPathKey(file)).second)
+            continue;
+
+        std::unique_ptr<juce::AudioFormatReader> reader(formats.createReaderFor(file));
+        if (reader == nullptr)
+        {
+            std::printf("skipping %s: not a readable audio file\n", file.getFullPathName().toRawUTF8());
+            continue;
+        }
+
+        RenderTask task;
+        task.input = file;
+        task.output = outputDirectory.getChildFile(relativePath).withFileExtension("wav");
+        task.sampleRate = reader->sampleRate;
+        task.numChannels = (int)reader->numChannels;
+        task.bitsPerSample = reader->bitsPerSample <= 16 ? 16 : (reader->bitsPerSample <= 24 ? 24 : 32);
+        task.lengthInSamples = reader->lengthInSamples;
+
+        totalSeconds += task.getSeconds();
+        tasks.push_back(task);
+    }
+
+    if (tasks.empty())
+    {
+        std::printf("no input files\n");
+        return 1;
+    }
+
+    // Checked before anything is written: an output must neither replace an input
+    // nor be written by two inputs
+    std::map<juce::String, const RenderTask*> outputs;
+    bool conflicting = false;
+
+    for (const auto& task : tasks)
+    {
+        const auto key = getPathKey(task.output);
+
+        if (inputPaths.count(key) > 0)
+        {
+            std::printf("%s would overwrite an input (%s); choose another --output\n",
+                        task.output.getFullPathName().toRawUTF8(), task.input.getFullPathName().toRawUTF8());
+            conflicting = true;
+        }
+        else if (const auto [existing, added] = outputs.emplace(key, &task); ! added)
+        {
+            std::printf("%s and %s would both write %s\n", existing->second->input.getFullPathName().toRawUTF8(),
+                        task.input.getFullPathName().toRawUTF8(), task.output.getFullPathName().toRawUTF8());
+            conflicting = true;
+        }
+    }
+
+    if (conflicting)
+        return 1;
+
+    // Longest first, so no long file starts last on an otherwise idle pool
+    std::sort(tasks.begin(), tasks.end(), [](const RenderTask& a, const RenderTask& b)
+    {
+        return a.lengthInSamples > b.lengthInSamples;
+    });
+
+    const int numFiles = (int)tasks.size();
+    const int threadsPerFile = juce::jmax(1, numThreads / numFiles);
+    const int numFileThreads = juce::jmin(numThreads, numFiles);
+
+    std::printf("rendering %d files (%.1f s of audio) on %d threads", numFiles, totalSeconds, numFileThreads * threadsPerFile);
+    if (threadsPerFile > 1)
+        std::printf(" (%d per file)", threadsPerFile);
+    std::printf("\n");
+
+    Progress progress;
+    const auto startTicks = juce::Time::getHighResolutionTicks();
+    auto elapsedSeconds = [startTicks]
+    {
+        return juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - startTicks);
+    };
+
+    {
+        juce::ThreadPool pool(numFileThreads);
+
+        for (const auto& task : tasks)
+        {
+            pool.addJob([&task, &state, &progress, blockSize, controlInterval, threadsPerFile, numFiles]
+            {
+                const auto fileStart = juce::Time::getHighResolutionTicks();
+                const auto error = render(task, state, blockSize, controlInterval, threadsPerFile, progress);
+                const double seconds = juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - fileStart);
+
+                const juce::ScopedLock sl(progress.printLock);
+                const int done = ++progress.filesDone;
+
+                if (error.isEmpty())
+                {
+                    std::printf("[%*d/%d] %s  %.1f s in %.2f s (%.1fx realtime)\n", juce::String(numFiles).length(), done, numFiles,
+                                task.input.getFileName().toRawUTF8(), task.getSeconds(), seconds,
+                                seconds > 0.0 ? task.getSeconds() / seconds : 0.0);
+                }
+                else
+                {
+                    ++progress.filesFailed;
+                    std::printf("[%*d/%d] %s  FAILED: %s\n", juce::String(numFiles).length(), done, numFiles,
+                                task.input.getFileName().toRawUTF8(), error.toRawUTF8());
+                }
+
+                std::fflush(stdout);
+            });
+        }
+
+        // Overall progress about once a second until the pool drains
+        while (pool.getNumJobs() > 0)
+        {
+            juce::Thread::sleep(1000);
+
+            const double rendered = (double)progress.microsecondsRendered.load() * 1.0e-6;
+            const double elapsed = elapsedSeconds();
+
+            const juce::ScopedLock sl(progress.printLock);
+            std::printf("  progress %5.1f%%  %d/%d files  %.1fx realtime\n",
+                        totalSeconds > 0.0 ? rendered / totalSeconds * 100.0 : 100.0,
+                        progress.filesDone.load(), numFiles, elapsed > 0.0 ? rendered / elapsed : 0.0);
+            std::fflush(stdout);
+        }
+    }
+
+    const double elapsed = elapsedSeconds();
+    const double realtimeFactor = elapsed > 0.0 ? totalSeconds / elapsed : 0.0;
+
+    std::printf("done: %d files, %.1f s of audio in %.2f s: %.1fx realtime (%.1fx per thread)\n",
+                numFiles - progress.filesFailed.load(), totalSeconds, elapsed, realtimeFactor,
+                realtimeFactor / (double)(numFileThreads * threadsPerFile));
+
+    if (progress.filesFailed > 0)
+    {
+        std::printf("%d files failed\n", progress.filesFailed.load());
+        return 1;
+    }
+
+    return 0;
+}
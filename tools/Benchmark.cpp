@@ -0,0 +1,1647 @@
+// Headless DSP micro-benchmark for MakeItHappenOTTProcessor.
+//
+// Runs prepareToPlay/processBlock over a matrix of sample rates, block sizes and
+// parameter presets without creating an editor, and reports per-sample cost and
+// block-time percentiles. Use it to size how many instances fit on a render node.
+//
+//   MakeItHappenOTTBenchmark [--quick] [--csv] [--seconds N] [--rate R] [--block B] [--preset NAME]
+//                            [--scalar] [--precise] [--verify-kernel] [--validate-gain-math] [--crossover]
+//                            [--layout stereo|5.1|7.1|7.1.4] [--verify-offline]
+//                            [--control-interval N] [--control-rate] [--double] [--compare-precision]
+//                            [--idle] [--state] [--programs] [--verify-guard] [--verify-lookahead]
+//                            [--verify-loudness-match]
+
+#include "ToolPresets.h"
+#include "../src/AudioThreadGuard.h"
+#include "../src/Lookahead.h"
+
+#include <algorithm>
+#include <cmath>
+#include <complex>
+#include <cstdio>
+#include <cstring>
+#include <functional>
+#include <numeric>
+#include <thread>
+#include <vector>
+
+#if JUCE_INTEL
+ #if JUCE_MSVC
+  #include <intrin.h>
+ #else
+  #include <x86intrin.h>
+ #endif
+#endif
+
+namespace
+{
+    // Pink-ish noise, a slow log sweep and gated bursts, so that every band sees
+    // both downward and upward compression during the run
+    juce::AudioBuffer<float> makeTestSignal(double sampleRate, int numSamples)
+    {
+        juce::AudioBuffer<float> signal(2, numSamples);
+        juce::Random random(0x07715eed);
+
+        float b0 = 0.0f, b1 = 0.0f, b2 = 0.0f;
+        double phase = 0.0;
+
+        for (int i = 0; i < numSamples; ++i)
+        {
+            const float white = random.nextFloat() * 2.0f - 1.0f;
+            b0 = 0.99765f * b0 + white * 0.0990460f;
+            b1 = 0.96300f * b1 + white * 0.2965164f;
+            b2 = 0.57000f * b2 + white * 1.0526913f;
+            const float pink = (b0 + b1 + b2 + white * 0.1848f) * 0.05f;
+
+            const double t = (double)i / (double)numSamples;
+            const double frequency = 40.0 * std::pow(400.0, t);
+            phase += juce::MathConstants<double>::twoPi * frequency / sampleRate;
+
+            const float gate = ((i / (int)(sampleRate * 0.25)) % 2 == 0) ? 1.0f : 0.02f;
+            const float tone = (float)std::sin(phase) * 0.5f * gate;
+
+            signal.setSample(0, i, tone + pink);
+            signal.setSample(1, i, tone * 0.8f - pink);
+        }
+
+        return signal;
+    }
+
+    inline juce::uint64 readCycleCounter() noexcept
+    {
+#if JUCE_INTEL
+        return (juce::uint64)__rdtsc();
+#else
+        return 0;
+#endif
+    }
+
+    struct Result
+    {
+        double nsPerSample = 0.0;
+        double cyclesPerSample = 0.0;
+        double p50Us = 0.0, p90Us = 0.0, p99Us = 0.0, maxUs = 0.0;
+        double meanLoad = 0.0; // mean block time / block duration
+        double p99Load = 0.0;
+    };
+
+    // Bus layouts selectable with --layout
+    juce::AudioChannelSet getLayout(const juce::String& name)
+    {
+        if (name == "5.1")   return juce::AudioChannelSet::create5point1();
+        if (name == "7.1")   return juce::AudioChannelSet::create7point1();
+        if (name == "7.1.4") return juce::AudioChannelSet::create7point1point4();
+
+        return juce::AudioChannelSet::stereo();
+    }
+
+    // SampleType is the precision the processor is prepared and called with
+    template <typename SampleType>
+    Result runCase(const Preset& preset, const juce::AudioBuffer<float>& source,
+                   double sampleRate, int blockSize, double secondsToMeasure,
+                   CompressorKernelBase::Mode kernelMode, GainMath::Precision precision,
+                   const juce::AudioChannelSet& layout, int controlInterval)
+    {
+        MakeItHappenOTTProcessor processor;
+        processor.setProcessingPrecision(std::is_same_v<SampleType, double> ? juce::AudioProcessor::doublePrecision
+                                                                           : juce::AudioProcessor::singlePrecision);
+        processor.setCompressorMode(kernelMode);
+        processor.setGainPrecision(precision);
+        processor.setGainControlInterval(controlInterval);
+
+        juce::AudioProcessor::BusesLayout buses;
+        buses.inputBuses.add(layout);
+        buses.outputBuses.add(layout);
+        processor.setBusesLayout(buses);
+        processor.setRateAndBufferSizeDetails(sampleRate, blockSize);
+
+        processor.setOfflineThreads(1);  // measure one instance on one thread
+        processor.setNonRealtime(true); // linear-phase kernels are ready before the first block
+        applyPreset(processor, preset);
+        processor.prepareToPlay(sampleRate, blockSize);
+
+        // Channels beyond the test signal's two reuse it
+        const int numChannels = layout.size();
+        juce::AudioBuffer<SampleType> work(numChannels, blockSize);
+        juce::MidiBuffer midi;
+        int readPosition = 0;
+
+        auto fillNextBlock = [&]
+        {
+            for (int i = 0; i < blockSize; ++i)
+            {
+                for (int ch = 0; ch < numChannels; ++ch)
+                    work.setSample(ch, i, (SampleType)source.getSample(ch % 2, readPosition));
+
+                readPosition = (readPosition + 1) % source.getNumSamples();
+            }
+        };
+
+        const int warmUpBlocks = juce::jmax(8, (int)(0.25 * sampleRate) / blockSize);
+        const int measuredBlocks = juce::jmax(32, (int)(secondsToMeasure * sampleRate) / blockSize);
+
+        for (int block = 0; block < warmUpBlocks; ++block)
+        {
+            fillNextBlock();
+            processor.processBlock(work, midi);
+        }
+
+        std::vector<double> blockSeconds;
+        blockSeconds.reserve((size_t)measuredBlocks);
+        juce::uint64 totalCycles = 0;
+
+        for (int block = 0; block < measuredBlocks; ++block)
+        {
+            fillNextBlock();
+
+            const auto startCycles = readCycleCounter();
+            const auto startTicks = juce::Time::getHighResolutionTicks();
+            processor.processBlock(work, midi);
+            const auto endTicks = juce::Time::getHighResolutionTicks();
+            totalCycles += readCycleCounter() - startCycles;
+
+            blockSeconds.push_back(juce::Time::highResolutionTicksToSeconds(endTicks - startTicks));
+        }
+
+        processor.releaseResources();
+
+        const double totalSeconds = std::accumulate(blockSeconds.begin(), blockSeconds.end(), 0.0);
+        const double totalSamples = (double)measuredBlocks * (double)blockSize;
+        const double blockDuration = (double)blockSize / sampleRate;
+
+        std::sort(blockSeconds.begin(), blockSeconds.end());
+        auto percentile = [&](double p)
+        {
+            const auto index = (size_t)std::ceil(p * (double)(blockSeconds.size() - 1));
+            return blockSeconds[index] * 1.0e6;
+        };
+
+        Result result;
+        result.nsPerSample = totalSeconds * 1.0e9 / totalSamples;
+
+#if JUCE_INTEL
+        result.cyclesPerSample = (double)totalCycles / totalSamples;
+#else
+        // No portable cycle counter: estimate from the nominal clock
+        result.cyclesPerSample = result.nsPerSample * juce::SystemStats::getCpuSpeedInMegahertz() * 1.0e-3;
+#endif
+
+        result.p50Us = percentile(0.50);
+        result.p90Us = percentile(0.90);
+        result.p99Us = percentile(0.99);
+        result.maxUs = blockSeconds.back() * 1.0e6;
+        result.meanLoad = (totalSeconds / (double)measuredBlocks) / blockDuration;
+        result.p99Load = result.p99Us * 1.0e-6 / blockDuration;
+        return result;
+    }
+
+    // Renders source through one stereo instance; seconds (if given) receives the
+    // time spent in processBlock
+    juce::AudioBuffer<float> renderWithKernel(const Preset& preset, const juce::AudioBuffer<float>& source,
+                                              double sampleRate, int blockSize, CompressorKernelBase::Mode kernelMode,
+                                              GainMath::Precision precision, int controlInterval = 1,
+                                              double* seconds = nullptr)
+    {
+        MakeItHappenOTTProcessor processor;
+        processor.setCompressorMode(kernelMode);
+        processor.setGainPrecision(precision);
+        processor.setGainControlInterval(controlInterval);
+        processor.setPlayConfigDetails(2, 2, sampleRate, blockSize);
+        processor.setOfflineThreads(1);
+        processor.setNonRealtime(true); // linear-phase kernels are ready before the first block
+        applyPreset(processor, preset);
+        processor.prepareToPlay(sampleRate, blockSize);
+
+        juce::AudioBuffer<float> output(source);
+        juce::MidiBuffer midi;
+        const auto startTicks = juce::Time::getHighResolutionTicks();
+
+        for (int start = 0; start < output.getNumSamples(); start += blockSize)
+        {
+            const int numSamples = juce::jmin(blockSize, output.getNumSamples() - start);
+            juce::AudioBuffer<float> block(output.getArrayOfWritePointers(), 2, start, numSamples);
+            processor.processBlock(block, midi);
+        }
+
+        if (seconds != nullptr)
+            *seconds = juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - startTicks);
+
+        return output;
+    }
+
+    // Renders every preset with the gain computer at each control interval and
+    // reports the processing time against the per-sample path (interval 1), and
+    // the output error relative to it: the residual's RMS against the reference's
+    // RMS, and its peak in dBFS
+    void measureControlRates()
+    {
+        const double sampleRate = 48000.0;
+        const int blockSize = 512;
+        const auto source = makeTestSignal(sampleRate, (int)sampleRate * 8);
+        const auto kernelMode = CompressorKernelBase::Mode::vector;
+        const auto precision = GainMath::defaultPrecision;
+
+        std::printf("%-15s %8s %10s %8s %12s %12s\n", "preset", "interval", "ns/sample", "speed-up", "residual dB", "peak dBFS");
+
+        for (const auto& preset : getPresets())
+        {
+            // Best of a few runs, so the comparison isn't thrown by one slow pass
+            auto render = [&](int interval, double& bestSeconds)
+            {
+                juce::AudioBuffer<float> output;
+                bestSeconds = 1.0e30;
+
+                for (int run = 0; run < 3; ++run)
+                {
+                    double seconds = 0.0;
+                    output = renderWithKernel(preset, source, sampleRate, blockSize, kernelMode, precision, interval, &seconds);
+                    bestSeconds = juce::jmin(bestSeconds, seconds);
+                }
+
+                return output;
+            };
+
+            double referenceSeconds = 0.0;
+            const auto reference = render(1, referenceSeconds);
+            const double samples = (double)source.getNumSamples();
+
+            std::printf("%-15s %8d %10.2f %8s %12s %12s\n", preset.name, 1, referenceSeconds * 1.0e9 / samples,
+                        "1.00x", "reference", "reference");
+
+            for (int interval : { 4, 8, 16, 32 })
+            {
+                double seconds = 0.0;
+                const auto output = render(interval, seconds);
+
+                double error = 0.0, power = 0.0, peak = 0.0;
+                for (int ch = 0; ch < 2; ++ch)
+                {
+                    for (int i = 0; i < source.getNumSamples(); ++i)
+                    {
+                        const double r = reference.getSample(ch, i);
+                        const double e = (double)output.getSample(ch, i) - r;
+                        error += e * e;
+                        power += r * r;
+                        peak = juce::jmax(peak, std::abs(e));
+                    }
+                }
+
+                std::printf("%-15s %8d %10.2f %7.2fx %12.1f %12.1f\n", preset.name, interval, seconds * 1.0e9 / samples,
+                            seconds > 0.0 ? referenceSeconds / seconds : 0.0,
+                            10.0 * std::log10((error + 1.0e-30) / (power + 1.0e-30)),
+                            20.0 * std::log10(peak + 1.0e-30));
+                std::fflush(stdout);
+            }
+        }
+    }
+
+    // Renders source, widened to double, the way a double-precision host would
+    // drive the processor: natively in double, or (nativeDouble false) through a
+    // float processor with the conversion passes a host or wrapper adds around it.
+    // seconds receives the time spent per block, conversions included.
+    juce::AudioBuffer<double> renderForDoubleHost(const Preset& preset, const juce::AudioBuffer<float>& source,
+                                                  double sampleRate, int blockSize, bool nativeDouble, double& seconds)
+    {
+        MakeItHappenOTTProcessor processor;
+        processor.setProcessingPrecision(nativeDouble ? juce::AudioProcessor::doublePrecision
+                                                      : juce::AudioProcessor::singlePrecision);
+        processor.setPlayConfigDetails(2, 2, sampleRate, blockSize);
+        processor.setOfflineThreads(1);
+        processor.setNonRealtime(true);
+        applyPreset(processor, preset);
+        processor.prepareToPlay(sampleRate, blockSize);
+
+        juce::AudioBuffer<double> output(2, source.getNumSamples());
+        for (int ch = 0; ch < 2; ++ch)
+            for (int i = 0; i < source.getNumSamples(); ++i)
+                output.setSample(ch, i, (double)source.getSample(ch, i));
+
+        juce::AudioBuffer<float> floatBlock(2, blockSize);
+        juce::MidiBuffer midi;
+        const auto startTicks = juce::Time::getHighResolutionTicks();
+
+        for (int start = 0; start < output.getNumSamples(); start += blockSize)
+        {
+            const int numSamples = juce::jmin(blockSize, output.getNumSamples() - start);
+            juce::AudioBuffer<double> block(output.getArrayOfWritePointers(), 2, start, numSamples);
+
+            if (nativeDouble)
+            {
+                processor.processBlock(block, midi);
+                continue;
+            }
+
+            floatBlock.setSize(2, numSamples, false, false, true);
+
+            for (int ch = 0; ch < 2; ++ch)
+                juce::FloatVectorOperations::convertDoubleToFloat(floatBlock.getWritePointer(ch), block.getReadPointer(ch), (size_t)numSamples);
+
+            processor.processBlock(floatBlock, midi);
+
+            for (int ch = 0; ch < 2; ++ch)
+                juce::FloatVectorOperations::convertFloatToDouble(block.getWritePointer(ch), floatBlock.getReadPointer(ch), (size_t)numSamples);
+        }
+
+        seconds = juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - startTicks);
+        return output;
+    }
+
+    // For a double-precision host: the float processor behind conversion passes
+    // against the native double path, in ns/sample (best of 3), and how far the
+    // float output is from the double one (residual RMS against the output's RMS)
+    void comparePrecisions()
+    {
+        const double sampleRate = 48000.0;
+        const int blockSize = 512;
+        const auto source = makeTestSignal(sampleRate, (int)sampleRate * 8);
+        const double samples = (double)source.getNumSamples();
+
+        std::printf("%-15s %14s %14s %8s %12s\n", "preset", "float+conv ns", "double ns", "dbl/flt", "residual dB");
+
+        for (const auto& preset : getPresets())
+        {
+            auto render = [&](bool nativeDouble, double& bestSeconds)
+            {
+                juce::AudioBuffer<double> output;
+                bestSeconds = 1.0e30;
+
+                for (int run = 0; run < 3; ++run)
+                {
+                    double seconds = 0.0;
+                    output = renderForDoubleHost(preset, source, sampleRate, blockSize, nativeDouble, seconds);
+                    bestSeconds = juce::jmin(bestSeconds, seconds);
+                }
+
+                return output;
+            };
+
+            double floatSeconds = 0.0, doubleSeconds = 0.0;
+            const auto floatOut = render(false, floatSeconds);
+            const auto doubleOut = render(true, doubleSeconds);
+
+            double error = 0.0, power = 0.0;
+            for (int ch = 0; ch < 2; ++ch)
+            {
+                for (int i = 0; i < source.getNumSamples(); ++i)
+                {
+                    const double r = doubleOut.getSample(ch, i);
+                    const double e = floatOut.getSample(ch, i) - r;
+                    error += e * e;
+                    power += r * r;
+                }
+            }
+
+            std::printf("%-15s %14.2f %14.2f %7.2fx %12.1f\n", preset.name,
+                        floatSeconds * 1.0e9 / samples, doubleSeconds * 1.0e9 / samples,
+                        floatSeconds > 0.0 ? doubleSeconds / floatSeconds : 0.0,
+                        10.0 * std::log10((error + 1.0e-30) / (power + 1.0e-30)));
+            std::fflush(stdout);
+        }
+    }
+
+    // An instance on a track that goes quiet: one second of the test signal, then
+    // silence. Reports ns/sample over the silent part with sleep mode off and on,
+    // how long after the signal stopped the processor fell asleep, and the tail
+    // it reports to the host.
+    void measureIdle()
+    {
+        const double sampleRate = 48000.0;
+        const int blockSize = 512;
+        const auto source = makeTestSignal(sampleRate, (int)sampleRate);
+        const int silentBlocks = (int)(sampleRate * 30.0) / blockSize;
+
+        std::printf("%-15s %12s %12s %10s %12s\n", "preset", "awake ns", "asleep ns", "sleeps at", "tail s");
+
+        for (const auto& preset : getPresets())
+        {
+            double nsPerSample[2] = {};
+            double sleepSeconds = -1.0, tailSeconds = 0.0;
+
+            for (int sleep = 0; sleep < 2; ++sleep)
+            {
+                MakeItHappenOTTProcessor processor;
+                processor.setSleepEnabled(sleep != 0);
+                processor.setPlayConfigDetails(2, 2, sampleRate, blockSize);
+                processor.setOfflineThreads(1);
+                processor.setNonRealtime(true);
+                applyPreset(processor, preset);
+                processor.prepareToPlay(sampleRate, blockSize);
+
+                juce::AudioBuffer<float> block(2, blockSize);
+                juce::MidiBuffer midi;
+
+                for (int start = 0; start + blockSize <= source.getNumSamples(); start += blockSize)
+                {
+                    for (int ch = 0; ch < 2; ++ch)
+                        block.copyFrom(ch, 0, source, ch, start, blockSize);
+
+                    processor.processBlock(block, midi);
+                }
+
+                double seconds = 0.0;
+
+                for (int b = 0; b < silentBlocks; ++b)
+                {
+                    block.clear();
+
+                    const auto startTicks = juce::Time::getHighResolutionTicks();
+                    processor.processBlock(block, midi);
+                    seconds += juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - startTicks);
+
+                    if (sleep != 0 && sleepSeconds < 0.0 && processor.isAsleep())
+                        sleepSeconds = (double)(b + 1) * blockSize / sampleRate;
+                }
+
+                nsPerSample[sleep] = seconds * 1.0e9 / ((double)silentBlocks * blockSize);
+                tailSeconds = processor.getTailLengthSeconds();
+            }
+
+            std::printf("%-15s %12.2f %12.2f %9.2fs %12.2f\n", preset.name, nsPerSample[0], nsPerSample[1],
+                        sleepSeconds, tailSeconds);
+            std::fflush(stdout);
+        }
+    }
+
+    // Per-instance cost of saving and restoring the session state: the binary
+    // format against the XML older versions wrote (which restore still reads).
+    // Restores alternate between the preset and the defaults, so every one of
+    // them changes parameters. Fails if either format doesn't round-trip.
+    bool measureState()
+    {
+        const int iterations = 2000;
+        bool allRestored = true;
+
+        auto writeXml = [](MakeItHappenOTTProcessor& processor, juce::MemoryBlock& destination)
+        {
+            const auto xml = processor.apvts.copyState().createXml();
+            juce::AudioProcessor::copyXmlToBinary(*xml, destination);
+        };
+
+        auto sameValues = [](MakeItHappenOTTProcessor& a, MakeItHappenOTTProcessor& b)
+        {
+            const auto& pa = a.getParameters();
+            const auto& pb = b.getParameters();
+
+            for (int i = 0; i < pa.size(); ++i)
+                if (pa[i]->getValue() != pb[i]->getValue())
+                    return false;
+
+            return pa.size() == pb.size();
+        };
+
+        auto microseconds = [](juce::int64 startTicks, int count)
+        {
+            return juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - startTicks) * 1.0e6 / count;
+        };
+
+        MakeItHappenOTTProcessor defaults;
+        juce::MemoryBlock defaultBinary, defaultXml;
+        defaults.getStateInformation(defaultBinary);
+        writeXml(defaults, defaultXml);
+
+        std::printf("%-15s %8s %8s %10s %10s %10s %10s %9s\n", "preset", "bin B", "xml B",
+                    "bin save", "bin load", "xml save", "xml load", "restored");
+
+        for (const auto& preset : getPresets())
+        {
+            MakeItHappenOTTProcessor source, target;
+            applyPreset(source, preset);
+
+            juce::MemoryBlock binary, xml;
+
+            auto start = juce::Time::getHighResolutionTicks();
+            for (int i = 0; i < iterations; ++i)
+                source.getStateInformation(binary);
+            const double binarySave = microseconds(start, iterations);
+
+            start = juce::Time::getHighResolutionTicks();
+            for (int i = 0; i < iterations; ++i)
+                writeXml(source, xml);
+            const double xmlSave = microseconds(start, iterations);
+
+            start = juce::Time::getHighResolutionTicks();
+            for (int i = 0; i < iterations; ++i)
+            {
+                target.setStateInformation(defaultBinary.getData(), (int)defaultBinary.getSize());
+                target.setStateInformation(binary.getData(), (int)binary.getSize());
+            }
+            const double binaryLoad = microseconds(start, 2 * iterations);
+            const bool binaryRestored = sameValues(source, target);
+
+            start = juce::Time::getHighResolutionTicks();
+            for (int i = 0; i < iterations; ++i)
+            {
+                target.setStateInformation(defaultXml.getData(), (int)defaultXml.getSize());
+                target.setStateInformation(xml.getData(), (int)xml.getSize());
+            }
+            const double xmlLoad = microseconds(start, 2 * iterations);
+            const bool xmlRestored = sameValues(source, target);
+
+            allRestored = allRestored && binaryRestored && xmlRestored;
+
+            std::printf("%-15s %8d %8d %8.2fus %8.2fus %8.2fus %8.2fus %9s\n", preset.name,
+                        (int)binary.getSize(), (int)xml.getSize(), binarySave, binaryLoad, xmlSave, xmlLoad,
+                        binaryRestored && xmlRestored ? "yes" : "NO");
+            std::fflush(stdout);
+        }
+
+        return allRestored;
+    }
+
+    // Host program changes from the first preset to every factory preset, mid-signal:
+    // the cost of setCurrentProgram itself, and the largest step between adjacent
+    // output samples around the change when it jumps ("morphTime" 0) and when it
+    // morphs (the default). Then the A/B morph between the first two presets, with
+    // "abPosition" automated across the run, against the same run without it.
+    // Fails unless a user preset and its name survive a session state round trip.
+    bool measurePrograms()
+    {
+        const double sampleRate = 48000.0;
+        const int blockSize = 512;
+        const auto source = makeTestSignal(sampleRate, (int)sampleRate * 2);
+        const int numBlocks = source.getNumSamples() / blockSize;
+        const int changeBlock = numBlocks / 2;
+
+        auto setParameter = [](MakeItHappenOTTProcessor& processor, const char* parameterID, float value)
+        {
+            auto* parameter = processor.apvts.getParameter(parameterID);
+            parameter->setValueNotifyingHost(parameter->convertTo0to1(value));
+        };
+
+        // Renders the signal, calling change before block changeBlock; returns the
+        // largest sample step in the 50 ms after it and the change's cost in us
+        auto render = [&](float morphMs, const std::function<void(MakeItHappenOTTProcessor&)>& change)
+        {
+            MakeItHappenOTTProcessor processor;
+            processor.setPlayConfigDetails(2, 2, sampleRate, blockSize);
+            setParameter(processor, "morphTime", morphMs);
+            processor.prepareToPlay(sampleRate, blockSize);
+
+            juce::AudioBuffer<float> block(2, blockSize);
+            juce::MidiBuffer midi;
+            float previous[2] = {}, largestStep = 0.0f;
+            double changeMicroseconds = 0.0;
+            const int watchedBlocks = juce::roundToInt(0.05 * sampleRate / blockSize) + 1;
+
+            for (int b = 0; b < numBlocks; ++b)
+            {
+                for (int ch = 0; ch < 2; ++ch)
+                    block.copyFrom(ch, 0, source, ch, b * blockSize, blockSize);
+
+                if (b == changeBlock)
+                {
+                    const auto startTicks = juce::Time::getHighResolutionTicks();
+                    change(processor);
+                    changeMicroseconds = juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - startTicks) * 1.0e6;
+                }
+
+                processor.processBlock(block, midi);
+
+                for (int ch = 0; ch < 2; ++ch)
+                {
+                    const float* data = block.getReadPointer(ch);
+
+                    for (int i = 0; i < blockSize; ++i)
+                    {
+                        if (b >= changeBlock && b < changeBlock + watchedBlocks)
+                            largestStep = juce::jmax(largestStep, std::abs(data[i] - previous[ch]));
+
+                        previous[ch] = data[i];
+                    }
+                }
+            }
+
+            return std::make_pair(largestStep, changeMicroseconds);
+        };
+
+        // The same change from another thread, as from a host's audio thread: the
+        // parameters are left to the message thread, so this is all that thread pays
+        auto changeOffMessageThread = [](int program)
+        {
+            MakeItHappenOTTProcessor processor;
+            double microseconds = 0.0;
+
+            std::thread([&processor, &microseconds, program]
+            {
+                const auto startTicks = juce::Time::getHighResolutionTicks();
+                processor.setCurrentProgram(program);
+                microseconds = juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - startTicks) * 1.0e6;
+            }).join();
+
+            return microseconds;
+        };
+
+        std::printf("%-15s %12s %12s %12s %12s\n", "program", "change us", "audio us", "jump step", "morph step");
+
+        const auto names = PresetBank::getDefaultNames();
+        for (int program = 1; program < PresetBank::getNumFactoryPresets(); ++program)
+        {
+            auto change = [program](MakeItHappenOTTProcessor& processor) { processor.setCurrentProgram(program); };
+            const auto jump = render(0.0f, change);
+            const auto morph = render(100.0f, change);
+
+            std::printf("%-15s %10.2fus %10.2fus %12.4f %12.4f\n", names[program].toRawUTF8(),
+                        morph.second, changeOffMessageThread(program), jump.first, morph.first);
+            std::fflush(stdout);
+        }
+
+        // A/B: the position sweeps 0-100% over the run, one automation step per block
+        auto timeRun = [&](bool ab)
+        {
+            MakeItHappenOTTProcessor processor;
+            processor.setPlayConfigDetails(2, 2, sampleRate, blockSize);
+            setParameter(processor, "abMorph", ab ? 1.0f : 0.0f);
+            setParameter(processor, "abPresetA", 1.0f);
+            setParameter(processor, "abPresetB", 2.0f);
+            processor.prepareToPlay(sampleRate, blockSize);
+
+            juce::AudioBuffer<float> block(2, blockSize);
+            juce::MidiBuffer midi;
+            double seconds = 0.0;
+
+            for (int b = 0; b < numBlocks; ++b)
+            {
+                for (int ch = 0; ch < 2; ++ch)
+                    block.copyFrom(ch, 0, source, ch, b * blockSize, blockSize);
+
+                setParameter(processor, "abPosition", 100.0f * (float)b / (float)numBlocks);
+
+                const auto startTicks = juce::Time::getHighResolutionTicks();
+                processor.processBlock(block, midi);
+                seconds += juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - startTicks);
+            }
+
+            return seconds * 1.0e9 / ((double)numBlocks * blockSize);
+        };
+
+        std::printf("\nA/B morph sweep: %.2f ns/sample (A/B off: %.2f ns/sample)\n", timeRun(true), timeRun(false));
+
+        // A user preset, its name and the current program go with the session
+        MakeItHappenOTTProcessor saved, restored;
+        const int userPreset = PresetBank::getNumFactoryPresets();
+        setParameter(saved, "depth", 42.0f);
+        saved.storeUserPreset(userPreset, "Round Trip");
+
+        juce::MemoryBlock state;
+        saved.getStateInformation(state);
+        restored.setStateInformation(state.getData(), (int)state.getSize());
+
+        // The A/B choices show the stored name too
+        const int column = restored.presets.getColumn("depth");
+        auto* presetA = restored.apvts.getParameter("abPresetA");
+        const bool roundTrip = restored.getCurrentProgram() == userPreset
+                            && restored.getProgramName(userPreset) == "Round Trip"
+                            && restored.presets.getValue(userPreset, column) == 42.0f
+                            && presetA->getText(presetA->convertTo0to1((float)userPreset), 64) == "Round Trip";
+
+        std::printf("user preset round trip: %s\n", roundTrip ? "yes" : "NO");
+        return roundTrip;
+    }
+
+    // The SIMD kernel must match the scalar fallback bit for bit, with either gain math
+    bool verifyKernelModes()
+    {
+        const double sampleRate = 48000.0;
+        const auto source = makeTestSignal(sampleRate, (int)sampleRate * 2);
+        bool allIdentical = true;
+
+        for (auto precision : { GainMath::Precision::fast, GainMath::Precision::precise })
+        {
+            for (const auto& preset : getPresets())
+            {
+                const auto vectorOut = renderWithKernel(preset, source, sampleRate, 256, CompressorKernelBase::Mode::vector, precision);
+                const auto scalarOut = renderWithKernel(preset, source, sampleRate, 256, CompressorKernelBase::Mode::scalar, precision);
+
+                int mismatches = 0;
+                for (int ch = 0; ch < 2; ++ch)
+                    for (int i = 0; i < source.getNumSamples(); ++i)
+                        if (std::memcmp(vectorOut.getReadPointer(ch) + i, scalarOut.getReadPointer(ch) + i, sizeof(float)) != 0)
+                            ++mismatches;
+
+                std::printf("%-15s %-8s %s (%d mismatching samples)\n", preset.name,
+                            precision == GainMath::Precision::fast ? "fast" : "precise",
+                            mismatches == 0 ? "identical" : "DIFFERENT", mismatches);
+                allIdentical = allIdentical && mismatches == 0;
+            }
+        }
+
+        return allIdentical;
+    }
+
+    // Renders source (channels beyond two reuse it) through one instance on the
+    // given layout. numThreads > 1 renders offline on the processor's worker pool;
+    // 1 prepares offline, for the kernels, then processes as a realtime host would.
+    juce::AudioBuffer<float> renderLayout(const Preset& preset, const juce::AudioBuffer<float>& source,
+                                          double sampleRate, int blockSize, const juce::AudioChannelSet& layout,
+                                          int numThreads, double& seconds)
+    {
+        MakeItHappenOTTProcessor processor;
+
+        juce::AudioProcessor::BusesLayout buses;
+        buses.inputBuses.add(layout);
+        buses.outputBuses.add(layout);
+        processor.setBusesLayout(buses);
+        processor.setRateAndBufferSizeDetails(sampleRate, blockSize);
+
+        processor.setOfflineThreads(numThreads);
+        processor.setNonRealtime(true);
+        applyPreset(processor, preset);
+        processor.prepareToPlay(sampleRate, blockSize);
+        processor.setNonRealtime(numThreads > 1);
+
+        const int numChannels = layout.size();
+        juce::AudioBuffer<float> output(numChannels, source.getNumSamples());
+        for (int ch = 0; ch < numChannels; ++ch)
+            output.copyFrom(ch, 0, source, ch % 2, 0, source.getNumSamples());
+
+        juce::MidiBuffer midi;
+        const auto startTicks = juce::Time::getHighResolutionTicks();
+
+        for (int start = 0; start < output.getNumSamples(); start += blockSize)
+        {
+            const int numSamples = juce::jmin(blockSize, output.getNumSamples() - start);
+            juce::AudioBuffer<float> block(output.getArrayOfWritePointers(), numChannels, start, numSamples);
+            processor.processBlock(block, midi);
+        }
+
+        seconds = juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - startTicks);
+        return output;
+    }
+
+    // Offline rendering on the worker pool must match the single-threaded realtime
+    // path bit for bit; also reports the speed-up
+    bool verifyOfflineRendering()
+    {
+        const double sampleRate = 48000.0;
+        const int blockSize = 512;
+        const int numThreads = juce::SystemStats::getNumCpus();
+        const auto source = makeTestSignal(sampleRate, (int)sampleRate * 4);
+        bool allIdentical = true;
+
+        std::printf("realtime vs offline on %d threads\n", numThreads);
+
+        for (const char* layoutName : { "stereo", "7.1.4" })
+        {
+            const auto layout = getLayout(layoutName);
+
+            for (const auto& preset : getPresets())
+            {
+                double realtimeSeconds = 0.0, offlineSeconds = 0.0;
+                const auto realtimeOut = renderLayout(preset, source, sampleRate, blockSize, layout, 1, realtimeSeconds);
+                const auto offlineOut = renderLayout(preset, source, sampleRate, blockSize, layout, numThreads, offlineSeconds);
+
+                int mismatches = 0;
+                for (int ch = 0; ch < realtimeOut.getNumChannels(); ++ch)
+                    for (int i = 0; i < realtimeOut.getNumSamples(); ++i)
+                        if (std::memcmp(realtimeOut.getReadPointer(ch) + i, offlineOut.getReadPointer(ch) + i, sizeof(float)) != 0)
+                            ++mismatches;
+
+                std::printf("%-6s %-15s %s (%d mismatching samples)  %.3f s -> %.3f s (%.2fx)\n", layoutName, preset.name,
+                            mismatches == 0 ? "identical" : "DIFFERENT", mismatches, realtimeSeconds, offlineSeconds,
+                            offlineSeconds > 0.0 ? realtimeSeconds / offlineSeconds : 0.0);
+                std::fflush(stdout);
+                allIdentical = allIdentical && mismatches == 0;
+            }
+        }
+
+        return allIdentical;
+    }
+
+    // Run in a child process by --verify-guard; returns only if the guard missed
+    // the allocation (juce::HeapBlock, behind AudioBuffer, uses std::malloc)
+    int allocateOnAudioThread()
+    {
+        AudioThreadGuard::Scope audioThread;
+        juce::AudioBuffer<float> buffer(2, 512);
+        buffer.clear();
+
+        std::printf("AudioBuffer allocation inside a guarded scope was not caught\n");
+        return 1;
+    }
+
+    // Needs -DMIH_AUDIO_THREAD_GUARD=ON. Every preset renders through processBlock
+    // without tripping the guard, and a child process that builds an AudioBuffer
+    // inside a guarded scope must abort with the guard's report.
+    bool verifyAudioThreadGuard()
+    {
+        if (! AudioThreadGuard::isCompiledIn())
+        {
+            std::printf("the audio-thread guard is not compiled in; configure with -DMIH_AUDIO_THREAD_GUARD=ON\n");
+            return false;
+        }
+
+        const double sampleRate = 48000.0;
+        const auto source = makeTestSignal(sampleRate, (int)sampleRate);
+
+        // processBlock holds the guard itself, so a violation aborts right here
+        for (const auto& preset : getPresets())
+        {
+            renderWithKernel(preset, source, sampleRate, 256, CompressorKernelBase::Mode::vector, GainMath::defaultPrecision);
+            std::printf("%-15s processBlock clean\n", preset.name);
+            std::fflush(stdout);
+        }
+
+        const auto executable = juce::File::getSpecialLocation(juce::File::currentExecutableFile).getFullPathName();
+        juce::ChildProcess child;
+
+        if (! child.start(juce::StringArray { executable, "--allocate-on-audio-thread" },
+                          juce::ChildProcess::wantStdOut | juce::ChildProcess::wantStdErr))
+        {
+            std::printf("could not start %s\n", executable.toRawUTF8());
+            return false;
+        }
+
+        // JUCE reports 0 for a child killed by a signal, so go by what it printed
+        const auto output = child.readAllProcessOutput();
+        const bool caught = output.contains("AudioThreadGuard: heap allocation") && ! output.contains("not caught");
+
+        std::printf("AudioBuffer inside a guarded scope: %s\n", caught ? "aborted" : "NOT CAUGHT");
+        return caught;
+    }
+
+    // Checks the lookahead from its building blocks up to the reported latency:
+    //  - SlidingMaximum against a brute-force maximum while the window grows and
+    //    shrinks between calls and the sample counter wraps
+    //  - LookaheadDelay swept 0 -> max -> max/3 -> 0 over a sine: no output step
+    //    beyond the input's largest step plus what the crossfade itself adds
+    //  - the latency the processor reports lines the output up with its input
+    bool verifyLookahead()
+    {
+        bool passed = true;
+
+        // A sample j is still in the deque at t if no call from j to t had it
+        // outside its window, so the reference is the maximum over
+        // [max over t' <= t of (t' - window(t')), t]
+        {
+            constexpr int numLanes = 2;
+            constexpr int maxWindow = 700;
+            constexpr int numSamples = 48000;
+
+            SlidingMaximum<numLanes> peaks;
+            peaks.prepare(maxWindow);
+            peaks.reset(0xffffffffu - 5000u);
+
+            juce::Random random(0x5a1d3e);
+            juce::AudioBuffer<float> input(numLanes, numSamples), output(numLanes, numSamples);
+
+            // Quiet noise with sparse loud samples, so the maximum changes often
+            for (int lane = 0; lane < numLanes; ++lane)
+                for (int i = 0; i < numSamples; ++i)
+                    input.setSample(lane, i, (random.nextFloat() * 2.0f - 1.0f) * (random.nextInt(64) == 0 ? 1.0f : 0.1f));
+
+            std::vector<int> windowAt((size_t)numSamples);
+            int window = maxWindow / 2;
+
+            for (int start = 0; start < numSamples;)
+            {
+                const int count = juce::jmin(1 + random.nextInt(300), numSamples - start);
+
+                // Mostly small moves, sometimes a jump anywhere in the range
+                window = random.nextInt(4) == 0 ? random.nextInt(maxWindow + 1)
+                                                : juce::jlimit(0, maxWindow, window + random.nextInt(61) - 30);
+
+                const float* in[numLanes] { input.getReadPointer(0, start), input.getReadPointer(1, start) };
+                float* out[numLanes] { output.getWritePointer(0, start), output.getWritePointer(1, start) };
+                peaks.process(in, out, count, window);
+
+                std::fill(windowAt.begin() + start, windowAt.begin() + start + count, window);
+                start += count;
+            }
+
+            int mismatches = 0;
+            for (int lane = 0; lane < numLanes; ++lane)
+            {
+                int oldest = 0;
+
+                for (int t = 0; t < numSamples; ++t)
+                {
+                    oldest = juce::jmax(oldest, t - windowAt[(size_t)t]);
+
+                    float expected = 0.0f;
+                    for (int j = oldest; j <= t; ++j)
+                        expected = juce::jmax(expected, std::abs(input.getSample(lane, j)));
+
+                    mismatches += output.getSample(lane, t) != expected ? 1 : 0;
+                }
+            }
+
+            std::printf("%-22s %s (%d mismatching samples, counter wraps)\n", "sliding maximum", mismatches == 0 ? "ok  " : "FAIL", mismatches);
+            passed = passed && mismatches == 0;
+        }
+
+        // Output = the two read positions mixed by a weight moving 1/fade per
+        // sample, so a step can exceed the input's by at most
+        // (delay change / fade) x the input's largest step; a jump would be far more
+        {
+            const double sampleRate = 48000.0;
+            const int blockSize = 64;
+            const int fade = juce::roundToInt(ParameterSnapshot::rampSeconds * sampleRate);
+            const int maxDelay = ParameterSnapshot::lookaheadToSamples(ParameterSnapshot::maxLookaheadMs, sampleRate);
+            const int delays[] { 0, maxDelay, maxDelay / 3, 0 };
+            const int hold = (4 * fade / blockSize) * blockSize; // each delay held well past its fade
+
+            LookaheadDelay<1> delay;
+            delay.prepare(maxDelay, fade);
+
+            std::vector<float> signal((size_t)(hold * 4));
+            for (size_t i = 0; i < signal.size(); ++i)
+                signal[i] = 0.5f * (float)std::sin(juce::MathConstants<double>::twoPi * 220.0 * (double)i / sampleRate);
+
+            std::vector<float> output(signal);
+            for (int start = 0; start < (int)output.size(); start += blockSize)
+            {
+                float* lanes[] { output.data() + start };
+                delay.process(lanes, blockSize, delays[start / hold]);
+            }
+
+            float inputStep = 0.0f, outputStep = 0.0f;
+            for (size_t i = 1; i < signal.size(); ++i)
+            {
+                inputStep = juce::jmax(inputStep, std::abs(signal[i] - signal[i - 1]));
+                outputStep = juce::jmax(outputStep, std::abs(output[i] - output[i - 1]));
+            }
+
+            const float allowed = inputStep * (1.0f + (float)maxDelay / (float)fade) * 1.001f;
+            const bool smooth = outputStep <= allowed;
+
+            std::printf("%-22s %s (largest step %.5f, input %.5f, allowed %.5f)\n", "delay sweep", smooth ? "ok  " : "FAIL",
+                        outputStep, inputStep, allowed);
+            passed = passed && smooth;
+        }
+
+        // Latency: at depth 0 the output is the dry path, which is the input
+        // through the crossover and the lookahead delay
+        {
+            const double sampleRate = 48000.0;
+            const int blockSize = 512;
+            const auto source = makeTestSignal(sampleRate, (int)sampleRate);
+            const int lookahead = ParameterSnapshot::lookaheadToSamples(5.0f, sampleRate);
+
+            auto render = [&](const Preset& preset, int& latency)
+            {
+                MakeItHappenOTTProcessor processor;
+                processor.setPlayConfigDetails(2, 2, sampleRate, blockSize);
+                processor.setOfflineThreads(1);
+                processor.setNonRealtime(true);
+                applyPreset(processor, preset);
+                processor.prepareToPlay(sampleRate, blockSize);
+                latency = processor.getLatencySamples();
+
+                juce::AudioBuffer<float> output(source);
+                juce::MidiBuffer midi;
+
+                for (int start = 0; start < output.getNumSamples(); start += blockSize)
+                {
+                    const int numSamples = juce::jmin(blockSize, output.getNumSamples() - start);
+                    juce::AudioBuffer<float> block(output.getArrayOfWritePointers(), 2, start, numSamples);
+                    processor.processBlock(block, midi);
+                }
+
+                return output;
+            };
+
+            // Zero-latency crossover: the lookahead render is the plain one,
+            // later by exactly the latency it adds
+            int plainLatency = 0, aheadLatency = 0;
+            const auto plain = render({ "dry", { { "depth", 0.0f } } }, plainLatency);
+            const auto ahead = render({ "dry-lookahead", { { "depth", 0.0f }, { "lookahead", 5.0f } } }, aheadLatency);
+
+            float peakDifference = 0.0f;
+            const int shift = aheadLatency - plainLatency;
+            for (int ch = 0; ch < 2; ++ch)
+                for (int i = 0; i + juce::jmax(0, shift) < source.getNumSamples(); ++i)
+                    peakDifference = juce::jmax(peakDifference, std::abs(ahead.getSample(ch, i + juce::jmax(0, shift)) - plain.getSample(ch, i)));
+
+            const bool aligned = plainLatency == 0 && shift == lookahead && peakDifference <= 1.0e-6f;
+            std::printf("%-22s %s (reports %d, lookahead %d samples, peak diff %.1f dBFS)\n", "latency dry-lookahead", aligned ? "ok  " : "FAIL",
+                        aheadLatency, lookahead, juce::Decibels::gainToDecibels(peakDifference, -200.0f));
+            passed = passed && aligned;
+
+            // Linear-phase crossover plus lookahead, dry and compressing: the
+            // output correlates best with the input at the reported latency
+            for (const auto& preset : { Preset { "lp-dry", { { "depth", 0.0f }, { "crossoverMode", 1.0f }, { "lookahead", 5.0f } } },
+                                        Preset { "lp-compressed", { { "crossoverMode", 1.0f }, { "lookahead", 5.0f } } } })
+            {
+                int latency = 0;
+                const auto output = render(preset, latency);
+
+                int bestLag = -1;
+                double bestCorrelation = 0.0;
+
+                for (int lag = 0; lag <= 2 * latency; ++lag)
+                {
+                    double correlation = 0.0;
+                    for (int ch = 0; ch < 2; ++ch)
+                    {
+                        const float* in = source.getReadPointer(ch);
+                        const float* out = output.getReadPointer(ch) + lag;
+
+                        for (int i = 0; i + lag < source.getNumSamples(); ++i)
+                            correlation += (double)in[i] * (double)out[i];
+                    }
+
+                    if (bestLag < 0 || correlation > bestCorrelation)
+                    {
+                        bestLag = lag;
+                        bestCorrelation = correlation;
+                    }
+                }
+
+                const bool lined = bestLag == latency;
+                std::printf("latency %-14s %s (reports %d, output lines up at %d)\n", preset.name, lined ? "ok  " : "FAIL",
+                            latency, bestLag);
+                passed = passed && lined;
+            }
+        }
+
+        return passed;
+    }
+
+    // LoudnessMatch against ITU-R BS.1770:
+    //  - the K-weighting designed at 48 and 96 kHz has the response of the
+    //    standard's 48 kHz reference coefficients up to 16 kHz
+    //  - a compressed sine and compressed pink noise come out within 0.1 dB of
+    //    the dry loudness, measured independently with the reference filter
+    //  - after ten minutes alternating loud and quiet, then silence, the
+    //    compensated window sums are back at zero
+    bool verifyLoudnessMatch()
+    {
+        struct Biquad { double b0, b1, b2, a1, a2; };
+
+        // BS.1770-4 table 1 and 2, at 48 kHz
+        constexpr Biquad referenceShelf { 1.53512485958697, -2.69169618940638, 1.19839281085285, -1.69065929318241, 0.73248077421585 };
+        constexpr Biquad referenceHighPass { 1.0, -2.0, 1.0, -1.99004745483398, 0.99007225036621 };
+
+        bool passed = true;
+        const int blockSize = 480;
+
+        {
+            auto magnitude = [](const Biquad& f, double w)
+            {
+                const std::complex<double> z = std::polar(1.0, -w);
+                return std::abs((f.b0 + z * (f.b1 + z * f.b2)) / (1.0 + z * (f.a1 + z * f.a2)));
+            };
+
+            for (double sampleRate : { 48000.0, 96000.0 })
+            {
+                LoudnessMatch match;
+                match.prepare(sampleRate, blockSize, 2);
+
+                // The reference is warped by the bilinear transform at 48 kHz, the
+                // 96 kHz design by less, so that one is allowed a few hundredths of a dB
+                double worstDb = 0.0, worstFrequency = 0.0;
+                for (double frequency = 20.0; frequency <= 16000.0; frequency *= 1.01)
+                {
+                    const double w = juce::MathConstants<double>::twoPi * frequency / 48000.0;
+                    const double expectedDb = 20.0 * std::log10(magnitude(referenceShelf, w) * magnitude(referenceHighPass, w));
+                    const double error = std::abs(match.getKWeightingDb(frequency) - expectedDb);
+
+                    if (error > worstDb)
+                    {
+                        worstDb = error;
+                        worstFrequency = frequency;
+                    }
+                }
+
+                const double allowedDb = sampleRate == 48000.0 ? 0.001 : 0.05;
+                const bool ok = worstDb <= allowedDb;
+                std::printf("K-weighting %6.0f Hz  %s (largest error %.4f dB at %.0f Hz, allowed %.3f)\n", sampleRate,
+                            ok ? "ok  " : "FAIL", worstDb, worstFrequency, allowedDb);
+                passed = passed && ok;
+            }
+        }
+
+        const double sampleRate = 48000.0;
+
+        // Mean square of the K-weighted signal, both channels summed, with the
+        // reference filters; loudness is this in dB (minus 0.691)
+        auto meanSquare = [&](const juce::AudioBuffer<float>& buffer, int start)
+        {
+            double sum = 0.0;
+
+            for (int ch = 0; ch < buffer.getNumChannels(); ++ch)
+            {
+                double shelf[2] {}, highPass[2] {};
+
+                auto run = [](const Biquad& f, double (&z)[2], double x)
+                {
+                    const double y = f.b0 * x + z[0];
+                    z[0] = f.b1 * x - f.a1 * y + z[1];
+                    z[1] = f.b2 * x - f.a2 * y;
+                    return y;
+                };
+
+                for (int i = 0; i < buffer.getNumSamples(); ++i)
+                {
+                    const double weighted = run(referenceHighPass, highPass, run(referenceShelf, shelf, buffer.getSample(ch, i)));
+                    if (i >= start)
+                        sum += weighted * weighted;
+                }
+            }
+
+            return sum / (double)(buffer.getNumSamples() - start);
+        };
+
+        auto process = [&](LoudnessMatch& match, juce::AudioBuffer<float>& wet, const juce::AudioBuffer<float>& dry)
+        {
+            for (int start = 0; start < wet.getNumSamples(); start += blockSize)
+            {
+                const int numSamples = juce::jmin(blockSize, wet.getNumSamples() - start);
+                juce::AudioBuffer<float> wetBlock(wet.getArrayOfWritePointers(), 2, start, numSamples);
+                juce::AudioBuffer<float> dryBlock(const_cast<float* const*>(dry.getArrayOfReadPointers()), 2, start, numSamples);
+                match.process(wetBlock, dryBlock, 2);
+            }
+        };
+
+        auto makePink = [&](int numSamples, juce::int64 seed)
+        {
+            juce::AudioBuffer<float> signal(2, numSamples);
+            juce::Random random(seed);
+
+            for (int ch = 0; ch < 2; ++ch)
+            {
+                float b0 = 0.0f, b1 = 0.0f, b2 = 0.0f;
+
+                for (int i = 0; i < numSamples; ++i)
+                {
+                    const float white = random.nextFloat() * 2.0f - 1.0f;
+                    b0 = 0.99765f * b0 + white * 0.0990460f;
+                    b1 = 0.96300f * b1 + white * 0.2965164f;
+                    b2 = 0.57000f * b2 + white * 1.0526913f;
+                    signal.setSample(ch, i, (b0 + b1 + b2 + white * 0.1848f) * 0.1f);
+                }
+            }
+
+            return signal;
+        };
+
+        // Four seconds, the last two measured; the "compressor" is a static
+        // tanh curve that changes both level and crest factor
+        {
+            const int numSamples = (int)sampleRate * 4;
+
+            juce::AudioBuffer<float> sine(2, numSamples);
+            for (int i = 0; i < numSamples; ++i)
+            {
+                const double phase = juce::MathConstants<double>::twoPi * 1000.0 * (double)i / sampleRate;
+                sine.setSample(0, i, 0.5f * (float)std::sin(phase));
+                sine.setSample(1, i, 0.5f * (float)std::sin(phase - juce::MathConstants<double>::halfPi));
+            }
+
+            const std::pair<const char*, juce::AudioBuffer<float>> signals[] { { "sine", sine }, { "pink noise", makePink(numSamples, 0x10d) } };
+
+            for (const auto& [name, dry] : signals)
+            {
+                juce::AudioBuffer<float> wet(dry);
+                for (int ch = 0; ch < 2; ++ch)
+                    for (int i = 0; i < numSamples; ++i)
+                        wet.setSample(ch, i, 0.15f * std::tanh(8.0f * dry.getSample(ch, i)));
+
+                const double unmatchedDb = 10.0 * std::log10(meanSquare(wet, numSamples / 2) / meanSquare(dry, numSamples / 2));
+
+                LoudnessMatch match;
+                match.prepare(sampleRate, blockSize, 2);
+                process(match, wet, dry);
+
+                const double errorDb = 10.0 * std::log10(meanSquare(wet, numSamples / 2) / meanSquare(dry, numSamples / 2));
+                const bool ok = std::abs(errorDb) <= 0.1;
+                std::printf("matched %-13s %s (%+.3f dB from dry, %+.2f dB unmatched)\n", name, ok ? "ok  " : "FAIL",
+                            errorDb, unmatchedDb);
+                passed = passed && ok;
+            }
+        }
+
+        // Ten minutes of one second at full level, one 60 dB down, then ten
+        // seconds of silence: by then the filters have decayed to exact zeros, so
+        // every energy the sums got has been removed again
+        {
+            const int sectionLength = (int)sampleRate;
+            const auto loud = makePink(sectionLength, 0x5e55);
+            LoudnessMatch match;
+            match.prepare(sampleRate, blockSize, 2);
+
+            double loudMeanSquare = 0.0;
+            for (int section = 0; section < 600; ++section)
+            {
+                juce::AudioBuffer<float> dry(loud);
+                dry.applyGain(section % 2 == 0 ? 4.0f : 0.004f);
+
+                juce::AudioBuffer<float> wet(dry);
+                wet.applyGain(0.5f);
+                process(match, wet, dry);
+
+                if (section == 0)
+                    loudMeanSquare = match.getDryMeanSquare();
+            }
+
+            juce::AudioBuffer<float> silence(2, (int)sampleRate * 10);
+            silence.clear();
+            juce::AudioBuffer<float> wetSilence(silence);
+            process(match, wetSilence, silence);
+
+            const double residual = juce::jmax(std::abs(match.getDryMeanSquare()), std::abs(match.getWetMeanSquare()));
+            const bool ok = residual <= loudMeanSquare * 1.0e-15;
+            std::printf("window sums         %s (residual %.3g after 10 min, loud windows %.3g)\n", ok ? "ok  " : "FAIL",
+                        residual, loudMeanSquare);
+            passed = passed && ok;
+        }
+
+        return passed;
+    }
+
+    // Sweeps envelope levels over -120..+24 dB and a grid of thresholds and ratios,
+    // comparing the kernel's fast gain against a double-precision reference of the
+    // same static curve. Fails if any gain is off by more than the 0.01 dB budget.
+    bool validateGainMath()
+    {
+        constexpr double budgetDb = 0.01;
+        constexpr double envelopeFloor = 0.00001;
+        const float ratios[] = { 1.0f, 1.5f, 2.0f, 4.0f, 10.0f, 20.0f };
+
+        double maxLog2Error = 0.0, maxExp2Error = 0.0;
+        double maxGainErrorDb = 0.0, maxPreciseErrorDb = 0.0;
+        double worstLevelDb = 0.0;
+        long long points = 0;
+
+        for (double levelDb = -120.0; levelDb <= 24.0; levelDb += 0.01)
+        {
+            const float env = (float)std::pow(10.0, levelDb / 20.0);
+            const double x = (double)env + envelopeFloor;
+
+            maxLog2Error = juce::jmax(maxLog2Error, std::abs((double)GainMath::fastLog2((float)x) - std::log2(x)));
+
+            // exp2 over the range the gain curve can produce
+            const double e = levelDb / 6.0;
+            maxExp2Error = juce::jmax(maxExp2Error, std::abs((double)GainMath::fastExp2((float)e) / std::exp2(e) - 1.0));
+
+            for (float threshDownDb = -60.0f; threshDownDb <= 0.0f; threshDownDb += 5.0f)
+            {
+                for (auto ratio : ratios)
+                {
+                    CompressorKernelBase::LaneParameters p;
+                    p.threshDownDb = threshDownDb;
+                    p.threshUpDb = threshDownDb - 20.0f;
+                    p.slopeDown = 1.0f - 1.0f / ratio;
+                    p.slopeUp = 1.0f - 1.0f / ratio;
+
+                    const double level = std::log2(x);
+                    const double boost = juce::jmax((double)p.threshUpDb / GainMath::decibelsPerLog2 - level, 0.0) * p.slopeUp;
+                    const double cut = juce::jmax(level - (double)p.threshDownDb / GainMath::decibelsPerLog2, 0.0) * p.slopeDown;
+                    const double referenceDb = (boost - cut) * GainMath::decibelsPerLog2;
+
+                    auto errorDb = [&](GainMath::Precision precision)
+                    {
+                        const double gain = CompressorKernelBase::computeGain(env, p, precision);
+                        return std::abs(20.0 * std::log10(gain) - referenceDb);
+                    };
+
+                    const double fastError = errorDb(GainMath::Precision::fast);
+                    if (fastError > maxGainErrorDb)
+                    {
+                        maxGainErrorDb = fastError;
+                        worstLevelDb = levelDb;
+                    }
+
+                    maxPreciseErrorDb = juce::jmax(maxPreciseErrorDb, errorDb(GainMath::Precision::precise));
+                    ++points;
+                }
+            }
+        }
+
+        const bool passed = maxGainErrorDb <= budgetDb;
+
+        std::printf("gain math sweep: %lld points, envelope -120..+24 dB\n", points);
+        std::printf("  fastLog2 max abs error   %.3g log2 units\n", maxLog2Error);
+        std::printf("  fastExp2 max rel error   %.3g\n", maxExp2Error);
+        std::printf("  fast gain max error      %.3g dB (at %.2f dB)\n", maxGainErrorDb, worstLevelDb);
+        std::printf("  precise gain max error   %.3g dB\n", maxPreciseErrorDb);
+        std::printf("%s (budget %.2f dB)\n", passed ? "PASS" : "FAIL", budgetDb);
+        return passed;
+    }
+}
+
+namespace
+{
+    // The pre-fusion crossover: every band filters its own copy of the input with
+    // separate juce::dsp::LinkwitzRileyFilters and no phase compensation
+    template <int NumBands>
+    struct CopyPerBandCrossover
+    {
+        juce::dsp::LinkwitzRileyFilter<float> lowPass[NumBands - 1], highPass[NumBands - 1];
+        juce::AudioBuffer<float> bands;
+
+        void prepare(double sampleRate, int blockSize)
+        {
+            const juce::dsp::ProcessSpec spec { sampleRate, (juce::uint32)blockSize, 2 };
+
+            for (int k = 0; k < NumBands - 1; ++k)
+            {
+                lowPass[k].setType(juce::dsp::LinkwitzRileyFilterType::lowpass);
+                lowPass[k].setCutoffFrequency(BandLayout<NumBands>::crossovers[k]);
+                lowPass[k].prepare(spec);
+                highPass[k].setType(juce::dsp::LinkwitzRileyFilterType::highpass);
+                highPass[k].setCutoffFrequency(BandLayout<NumBands>::crossovers[k]);
+                highPass[k].prepare(spec);
+            }
+
+            bands.setSize(NumBands * 2, blockSize);
+        }
+
+        void process(const juce::AudioBuffer<float>& input, int numSamples)
+        {
+            for (int b = 0; b < NumBands; ++b)
+            {
+                for (int ch = 0; ch < 2; ++ch)
+                    bands.copyFrom(b * 2 + ch, 0, input, ch, 0, numSamples);
+
+                juce::dsp::AudioBlock<float> block(bands.getArrayOfWritePointers() + b * 2, 2, (size_t)numSamples);
+                juce::dsp::ProcessContextReplacing<float> context(block);
+
+                if (b > 0)
+                    highPass[b - 1].process(context);
+
+                if (b < NumBands - 1)
+                    lowPass[b].process(context);
+            }
+        }
+    };
+
+    // RMS of (a - b) relative to the RMS of reference, in dB
+    double residualDb(const std::vector<float>& a, const std::vector<float>& b, const std::vector<float>& reference)
+    {
+        double error = 0.0, power = 0.0;
+        for (size_t i = 0; i < a.size(); ++i)
+        {
+            error += ((double)a[i] - (double)b[i]) * ((double)a[i] - (double)b[i]);
+            power += (double)reference[i] * (double)reference[i];
+        }
+
+        return 10.0 * std::log10((error + 1.0e-30) / (power + 1.0e-30));
+    }
+
+    // Times the copy-per-band and fused crossovers at 48 kHz stereo, and checks
+    // how well each one's band sum nulls: the copy path against the raw input, the
+    // fused path against the input through an independent allpass chain
+    template <int NumBands>
+    void benchmarkCrossover(const juce::AudioBuffer<float>& source, double sampleRate, int blockSize)
+    {
+        const int numSamples = source.getNumSamples() / blockSize * blockSize;
+
+        CopyPerBandCrossover<NumBands> copyPath;
+        copyPath.prepare(sampleRate, blockSize);
+
+        LinkwitzRileyCrossover<NumBands, 2> fused;
+        fused.prepare(sampleRate, BandLayout<NumBands>::crossovers);
+        juce::AudioBuffer<float> fusedBands(NumBands * 2, blockSize), fusedDry(2, blockSize);
+
+        juce::dsp::LinkwitzRileyFilter<float> allpass[NumBands - 1];
+        for (int k = 0; k < NumBands - 1; ++k)
+        {
+            allpass[k].setType(juce::dsp::LinkwitzRileyFilterType::allpass);
+            allpass[k].setCutoffFrequency(BandLayout<NumBands>::crossovers[k]);
+            allpass[k].prepare({ sampleRate, (juce::uint32)blockSize, 1 });
+        }
+
+        std::vector<float> input, copySum, fusedSum, allpassed;
+        double copySeconds = 0.0, fusedSeconds = 0.0;
+
+        for (int start = 0; start < numSamples; start += blockSize)
+        {
+            juce::AudioBuffer<float> block(const_cast<float* const*>(source.getArrayOfReadPointers()), 2, start, blockSize);
+
+            auto startTicks = juce::Time::getHighResolutionTicks();
+            copyPath.process(block, blockSize);
+            copySeconds += juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - startTicks);
+
+            startTicks = juce::Time::getHighResolutionTicks();
+            fused.process(block.getArrayOfReadPointers(), fusedBands.getArrayOfWritePointers(),
+                          fusedDry.getArrayOfWritePointers(), blockSize);
+            fusedSeconds += juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - startTicks);
+
+            // Null checks on the left channel
+            for (int i = 0; i < blockSize; ++i)
+            {
+                float copyTotal = 0.0f, fusedTotal = 0.0f;
+                for (int b = 0; b < NumBands; ++b)
+                {
+                    copyTotal += copyPath.bands.getSample(b * 2, i);
+                    fusedTotal += fusedBands.getSample(b * 2, i);
+                }
+
+                float reference = block.getSample(0, i);
+                for (auto& filter : allpass)
+                    reference = filter.processSample(0, reference);
+
+                input.push_back(block.getSample(0, i));
+                copySum.push_back(copyTotal);
+                fusedSum.push_back(fusedTotal);
+                allpassed.push_back(reference);
+            }
+        }
+
+        const double samples = (double)numSamples * 2.0;
+        std::printf("%d bands  copy-per-band %7.2f ns/sample  fused %7.2f ns/sample  (%.2fx)\n", NumBands,
+                    copySeconds * 1.0e9 / samples, fusedSeconds * 1.0e9 / samples, copySeconds / fusedSeconds);
+        std::printf("         band sum vs input: copy-per-band %7.1f dB   fused (vs allpassed input) %7.1f dB\n",
+                    residualDb(copySum, input, input), residualDb(fusedSum, allpassed, input));
+    }
+
+    // Times the linear-phase crossover at a small block size, reporting its worst
+    // block against the block duration, and checks that its band sum nulls
+    // against the input delayed by the reported latency
+    template <int NumBands>
+    void benchmarkLinearPhaseCrossover(const juce::AudioBuffer<float>& source, double sampleRate, int blockSize)
+    {
+        const int numSamples = source.getNumSamples() / blockSize * blockSize;
+        const int latency = LinearPhaseKernels::getLatencySamples(sampleRate);
+
+        const auto buildStart = juce::Time::getHighResolutionTicks();
+        const auto kernels = LinearPhaseKernels::build(sampleRate, BandLayout<NumBands>::crossovers, NumBands);
+        const double buildSeconds = juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - buildStart);
+
+        LinearPhaseCrossover<NumBands, 2> crossover;
+        crossover.prepare(sampleRate);
+        crossover.setKernels(kernels.get());
+        juce::AudioBuffer<float> bands(NumBands * 2, blockSize), dry(2, blockSize);
+
+        std::vector<float> delayed, bandSum;
+        double totalSeconds = 0.0, worstSeconds = 0.0;
+
+        for (int start = 0; start < numSamples; start += blockSize)
+        {
+            juce::AudioBuffer<float> block(const_cast<float* const*>(source.getArrayOfReadPointers()), 2, start, blockSize);
+
+            const auto startTicks = juce::Time::getHighResolutionTicks();
+            crossover.process(block.getArrayOfReadPointers(), bands.getArrayOfWritePointers(),
+                              dry.getArrayOfWritePointers(), blockSize);
+            const double seconds = juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - startTicks);
+            totalSeconds += seconds;
+            worstSeconds = juce::jmax(worstSeconds, seconds);
+
+            for (int i = 0; i < blockSize; ++i)
+            {
+                const int n = start + i;
+                if (n < latency)
+                    continue;
+
+                float total = 0.0f;
+                for (int b = 0; b < NumBands; ++b)
+                    total += bands.getSample(b * 2, i);
+
+                delayed.push_back(source.getSample(0, n - latency));
+                bandSum.push_back(total);
+            }
+        }
+
+        const double blockDuration = (double)blockSize / sampleRate;
+        std::printf("%d bands  linear-phase %7.2f ns/sample at %d-sample blocks, worst block %.1f%% of realtime\n", NumBands,
+                    totalSeconds * 1.0e9 / ((double)numSamples * 2.0), blockSize, worstSeconds / blockDuration * 100.0);
+        std::printf("         latency %d samples, kernels built in %.1f ms, band sum vs delayed input %7.1f dB\n",
+                    latency, buildSeconds * 1.0e3, residualDb(bandSum, delayed, delayed));
+    }
+
+    void benchmarkCrossovers()
+    {
+        const double sampleRate = 48000.0;
+        const auto source = makeTestSignal(sampleRate, (int)sampleRate * 8);
+
+        benchmarkCrossover<3>(source, sampleRate, 512);
+        benchmarkCrossover<4>(source, sampleRate, 512);
+        benchmarkCrossover<5>(source, sampleRate, 512);
+
+        benchmarkLinearPhaseCrossover<3>(source, sampleRate, 128);
+        benchmarkLinearPhaseCrossover<4>(source, sampleRate, 128);
+        benchmarkLinearPhaseCrossover<5>(source, sampleRate, 128);
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    juce::ScopedJuceInitialiser_GUI juceInitialiser;
+    juce::ArgumentList args(argc, argv);
+
+    if (args.containsOption("--verify-kernel"))
+        return verifyKernelModes() ? 0 : 1;
+
+    if (args.containsOption("--verify-offline"))
+        return verifyOfflineRendering() ? 0 : 1;
+
+    if (args.containsOption("--verify-guard"))
+        return verifyAudioThreadGuard() ? 0 : 1;
+
+    if (args.containsOption("--verify-lookahead"))
+        return verifyLookahead() ? 0 : 1;
+
+    if (args.containsOption("--verify-loudness-match"))
+        return verifyLoudnessMatch() ? 0 : 1;
+
+    if (args.containsOption("--allocate-on-audio-thread"))
+        return allocateOnAudioThread();
+
+    if (args.containsOption("--validate-gain-math"))
+        return validateGainMath() ? 0 : 1;
+
+    if (args.containsOption("--crossover"))
+    {
+        benchmarkCrossovers();
+        return 0;
+    }
+
+    if (args.containsOption("--control-rate"))
+    {
+        measureControlRates();
+        return 0;
+    }
+
+    if (args.containsOption("--compare-precision"))
+    {
+        comparePrecisions();
+        return 0;
+    }
+
+    if (args.containsOption("--idle"))
+    {
+        measureIdle();
+        return 0;
+    }
+
+    if (args.containsOption("--state"))
+        return measureState() ? 0 : 1;
+
+    if (args.containsOption("--programs"))
+        return measurePrograms() ? 0 : 1;
+
+    const bool quick = args.containsOption("--quick");
+    const bool csv = args.containsOption("--csv");
+    const auto kernelMode = args.containsOption("--scalar") ? CompressorKernelBase::Mode::scalar
+                                                            : CompressorKernelBase::Mode::vector;
+    const auto precision = args.containsOption("--precise") ? GainMath::Precision::precise
+                                                            : GainMath::Precision::fast;
+    const bool doublePrecision = args.containsOption("--double");
+
+    int controlInterval = 1;
+    if (args.containsOption("--control-interval"))
+        controlInterval = juce::jlimit(1, CompressorKernelBase::maxControlInterval,
+                                       juce::nextPowerOfTwo(args.getValueForOption("--control-interval").getIntValue()));
+
+    double secondsToMeasure = quick ? 0.5 : 2.0;
+    if (args.containsOption("--seconds"))
+        secondsToMeasure = juce::jmax(0.05, args.getValueForOption("--seconds").getDoubleValue());
+
+    std::vector<double> sampleRates { 44100.0, 48000.0, 88200.0, 96000.0, 176400.0, 192000.0 };
+    std::vector<int> blockSizes { 16, 32, 64, 128, 256, 512, 1024, 2048, 4096, 8192 };
+
+    if (quick)
+    {
+        sampleRates = { 48000.0, 192000.0 };
+        blockSizes = { 16, 128, 1024, 8192 };
+    }
+
+    if (args.containsOption("--rate"))
+        sampleRates = { args.getValueForOption("--rate").getDoubleValue() };
+
+    if (args.containsOption("--block"))
+        blockSizes = { args.getValueForOption("--block").getIntValue() };
+
+    const auto presetFilter = args.getValueForOption("--preset");
+    const auto layout = getLayout(args.getValueForOption("--layout"));
+
+    if (csv)
+        std::printf("preset,sample_rate,block_size,ns_per_sample,cycles_per_sample,p50_us,p90_us,p99_us,max_us,mean_load,p99_load\n");
+    else
+        std::printf("%-15s %8s %6s %10s %12s %9s %9s %9s %9s %8s %10s\n",
+                    "preset", "rate", "block", "ns/sample", "cycles/smp", "p50 us", "p90 us", "p99 us",
+                    "max us", "load %", "inst/core");
+
+    for (const auto& preset : getPresets())
+    {
+        if (presetFilter.isNotEmpty() && presetFilter != preset.name)
+            continue;
+
+        for (auto sampleRate : sampleRates)
+        {
+            const auto source = makeTestSignal(sampleRate, (int)sampleRate * 4);
+
+            for (auto blockSize : blockSizes)
+            {
+                const auto r = doublePrecision
+                    ? runCase<double>(preset, source, sampleRate, blockSize, secondsToMeasure, kernelMode, precision, layout, controlInterval)
+                    : runCase<float>(preset, source, sampleRate, blockSize, secondsToMeasure, kernelMode, precision, layout, controlInterval);
+
+                if (csv)
+                    std::printf("%s,%.0f,%d,%.3f,%.2f,%.3f,%.3f,%.3f,%.3f,%.5f,%.5f\n",
+                                preset.name, sampleRate, blockSize, r.nsPerSample, r.cyclesPerSample,
+                                r.p50Us, r.p90Us, r.p99Us, r.maxUs, r.meanLoad, r.p99Load);
+                else
+                    std::printf("%-15s %8.0f %6d %10.2f %12.1f %9.2f %9.2f %9.2f %9.2f %8.3f %10.0f\n",
+                                preset.name, sampleRate, blockSize, r.nsPerSample, r.cyclesPerSample,
+                                r.p50Us, r.p90Us, r.p99Us, r.maxUs, r.meanLoad * 100.0,
+                                r.p99Load > 0.0 ? 1.0 / r.p99Load : 0.0);
+
+                std::fflush(stdout);
+            }
+        }
+    }
+
+    return 0;
+}
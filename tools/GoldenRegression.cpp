@@ -0,0 +1,521 @@
+// Golden-output regression suite for MakeItHappenOTTProcessor.
+//
+// Renders a fixed corpus of synthetic signals (sines, a log sweep, pink noise,
+// transients, silence, DC) through the processor under each preset, and compares
+// the output with golden files rendered by a reference build. Each preset also has
+// an ns/sample budget. The run fails if any output drifts past the tolerance or
+// any preset renders slower than its budget, so a DSP change has to be both
+// equivalent and no slower before it goes in. The corpus is also rendered once
+// through the double-precision path and compared with the same goldens, at a
+// looser tolerance since that path rounds differently.
+//
+// --update writes the goldens. Per preset, the golden directory gets:
+//   state.bin    the processor state rendered from; later runs restore it, so the
+//                goldens stay tied to the exact parameter values
+//   SIGNAL.wav   one 32-bit float WAV per corpus signal
+//   budget.json  the measured ns/sample and the budget (measured x headroom)
+//
+//   MakeItHappenOTTRegression --golden DIR [--update] [--preset NAME] [--tolerance DB]
+//                             [--double-tolerance DB] [--headroom X] [--budget-scale X]
+//                             [--no-budget] [--runs N]
+
+#include "ToolPresets.h"
+
+#include <cmath>
+#include <cstdio>
+#include <functional>
+#include <vector>
+
+namespace
+{
+    constexpr double sampleRate = 48000.0;
+    constexpr int blockSize = 512;
+
+    struct TestSignal
+    {
+        const char* name;
+        std::function<juce::AudioBuffer<float>()> generate;
+    };
+
+    juce::AudioBuffer<float> makeSine(double frequency, float gainDb, double seconds)
+    {
+        juce::AudioBuffer<float> signal(2, (int)(seconds * sampleRate));
+        const float amplitude = juce::Decibels::decibelsToGain(gainDb);
+
+        // The right channel lags by a quarter cycle, so width processing has a side signal
+        for (int i = 0; i < signal.getNumSamples(); ++i)
+        {
+            const double phase = juce::MathConstants<double>::twoPi * frequency * (double)i / sampleRate;
+            signal.setSample(0, i, amplitude * (float)std::sin(phase));
+            signal.setSample(1, i, amplitude * (float)std::sin(phase - juce::MathConstants<double>::halfPi));
+        }
+
+        return signal;
+    }
+
+    // Logarithmic sweep over 20 Hz..20 kHz at -12 dBFS
+    juce::AudioBuffer<float> makeSweep(double seconds)
+    {
+        juce::AudioBuffer<float> signal(2, (int)(seconds * sampleRate));
+        const float amplitude = juce::Decibels::decibelsToGain(-12.0f);
+        double phase = 0.0;
+
+        for (int i = 0; i < signal.getNumSamples(); ++i)
+        {
+            const double frequency = 20.0 * std::pow(1000.0, (double)i / (double)signal.getNumSamples());
+            phase += juce::MathConstants<double>::twoPi * frequency / sampleRate;
+
+            signal.setSample(0, i, amplitude * (float)std::sin(phase));
+            signal.setSample(1, i, amplitude * 0.7f * (float)std::sin(phase));
+        }
+
+        return signal;
+    }
+
+    // Paul Kellet's pink filter over seeded white noise; the channels are uncorrelated
+    juce::AudioBuffer<float> makePinkNoise(double seconds)
+    {
+        juce::AudioBuffer<float> signal(2, (int)(seconds * sampleRate));
+        juce::Random random(0x9017de4);
+
+        for (int ch = 0; ch < 2; ++ch)
+        {
+            float b0 = 0.0f, b1 = 0.0f, b2 = 0.0f, b3 = 0.0f, b4 = 0.0f, b5 = 0.0f, b6 = 0.0f;
+
+            for (int i = 0; i < signal.getNumSamples(); ++i)
+            {
+                const float white = random.nextFloat() * 2.0f - 1.0f;
+                b0 = 0.99886f * b0 + white * 0.0555179f;
+                b1 = 0.99332f * b1 + white * 0.0750759f;
+                b2 = 0.96900f * b2 + white * 0.1538520f;
+                b3 = 0.86650f * b3 + white * 0.3104856f;
+                b4 = 0.55000f * b4 + white * 0.5329522f;
+                b5 = -0.7616f * b5 - white * 0.0168980f;
+                const float pink = b0 + b1 + b2 + b3 + b4 + b5 + b6 + white * 0.5362f;
+                b6 = white * 0.115926f;
+
+                signal.setSample(ch, i, pink * 0.05f);
+            }
+        }
+
+        return signal;
+    }
+
+    // Kick-like decaying 55 Hz bursts every 250 ms with a click on top, then a
+    // loud snare-like noise burst every 500 ms: fast attacks and full releases
+    juce::AudioBuffer<float> makeTransients(double seconds)
+    {
+        juce::AudioBuffer<float> signal(2, (int)(seconds * sampleRate));
+        juce::Random random(0x7a2b51);
+        const int kickPeriod = (int)(0.25 * sampleRate);
+        const int snareOffset = kickPeriod / 2;
+
+        for (int i = 0; i < signal.getNumSamples(); ++i)
+        {
+            const int sinceKick = i % kickPeriod;
+            const double t = (double)sinceKick / sampleRate;
+            const float kick = (float)(std::exp(-t * 18.0) * std::sin(juce::MathConstants<double>::twoPi * 55.0 * t)) * 0.8f
+                             + (sinceKick < 48 ? 0.5f * (1.0f - (float)sinceKick / 48.0f) : 0.0f);
+
+            const int sinceSnare = (i + snareOffset) % (2 * kickPeriod);
+            const float snare = sinceSnare < kickPeriod
+                              ? (random.nextFloat() * 2.0f - 1.0f) * 0.6f * (float)std::exp(-(double)sinceSnare / sampleRate * 30.0)
+                              : 0.0f;
+
+            signal.setSample(0, i, kick + snare);
+            signal.setSample(1, i, kick - 0.5f * snare);
+        }
+
+        return signal;
+    }
+
+    juce::AudioBuffer<float> makeSilence(double seconds)
+    {
+        juce::AudioBuffer<float> signal(2, (int)(seconds * sampleRate));
+        signal.clear();
+        return signal;
+    }
+
+    // A constant offset on the left and a step from 0 to -0.5 half way on the right
+    juce::AudioBuffer<float> makeDC(double seconds)
+    {
+        juce::AudioBuffer<float> signal(2, (int)(seconds * sampleRate));
+
+        for (int i = 0; i < signal.getNumSamples(); ++i)
+        {
+            signal.setSample(0, i, 0.25f);
+            signal.setSample(1, i, i < signal.getNumSamples() / 2 ? 0.0f : -0.5f);
+        }
+
+        return signal;
+    }
+
+    const std::vector<TestSignal>& getCorpus()
+    {
+        static const std::vector<TestSignal> corpus {
+            { "sine-100",       [] { return makeSine(100.0, -12.0f, 1.0); } },
+            { "sine-1k",        [] { return makeSine(1000.0, -6.0f, 1.0); } },
+            { "sine-10k",       [] { return makeSine(10000.0, -18.0f, 1.0); } },
+            { "sine-1k-quiet",  [] { return makeSine(1000.0, -50.0f, 1.0); } },
+            { "sweep",          [] { return makeSweep(2.0); } },
+            { "pink-noise",     [] { return makePinkNoise(1.5); } },
+            { "transients",     [] { return makeTransients(1.5); } },
+            { "silence",        [] { return makeSilence(1.0); } },
+            { "dc",             [] { return makeDC(1.0); } },
+        };
+
+        return corpus;
+    }
+
+    struct Rendering
+    {
+        std::vector<juce::AudioBuffer<float>> outputs;       // one per corpus signal
+        std::vector<juce::AudioBuffer<float>> doubleOutputs; // the same through processBlock(AudioBuffer<double>&)
+        double nsPerSample = 0.0;                            // fastest of the runs
+    };
+
+    // A fresh processor restored from state, prepared offline so the linear-phase
+    // kernels are ready, then left to process as a realtime host would on one thread
+    void prepareProcessor(MakeItHappenOTTProcessor& processor, const juce::MemoryBlock& state,
+                          juce::AudioProcessor::ProcessingPrecision precision)
+    {
+        processor.setProcessingPrecision(precision);
+        processor.setPlayConfigDetails(2, 2, sampleRate, blockSize);
+        processor.setStateInformation(state.getData(), (int)state.getSize());
+        processor.setOfflineThreads(1);
+        processor.setNonRealtime(true);
+        processor.prepareToPlay(sampleRate, blockSize);
+        processor.setNonRealtime(false);
+    }
+
+    // Renders one signal through the double-precision path; the result is
+    // narrowed back to float for comparison with the goldens
+    juce::AudioBuffer<float> renderDouble(const juce::MemoryBlock& state, const juce::AudioBuffer<float>& input)
+    {
+        MakeItHappenOTTProcessor processor;
+        prepareProcessor(processor, state, juce::AudioProcessor::doublePrecision);
+
+        juce::AudioBuffer<double> output(input.getNumChannels(), input.getNumSamples());
+        for (int ch = 0; ch < input.getNumChannels(); ++ch)
+            juce::FloatVectorOperations::convertFloatToDouble(output.getWritePointer(ch), input.getReadPointer(ch),
+                                                              (size_t)input.getNumSamples());
+
+        juce::MidiBuffer midi;
+
+        for (int start = 0; start < output.getNumSamples(); start += blockSize)
+        {
+            const int numSamples = juce::jmin(blockSize, output.getNumSamples() - start);
+            juce::AudioBuffer<double> block(output.getArrayOfWritePointers(), 2, start, numSamples);
+            processor.processBlock(block, midi);
+        }
+
+        processor.releaseResources();
+
+        juce::AudioBuffer<float> narrowed(output.getNumChannels(), output.getNumSamples());
+        for (int ch = 0; ch < output.getNumChannels(); ++ch)
+            juce::FloatVectorOperations::convertDoubleToFloat(narrowed.getWritePointer(ch), output.getReadPointer(ch),
+                                                              (size_t)output.getNumSamples());
+        return narrowed;
+    }
+
+    // Renders every corpus signal through a fresh processor restored from state,
+    // runs times; keeps the first run's output and the fastest run's cost. With
+    // withDouble, also renders each signal once in double precision (untimed).
+    Rendering renderCorpus(const juce::MemoryBlock& state, const std::vector<juce::AudioBuffer<float>>& inputs, int runs,
+                           bool withDouble)
+    {
+        Rendering rendering;
+        double bestSeconds = 0.0;
+        double totalSamples = 0.0;
+
+        for (int run = 0; run < runs; ++run)
+        {
+            double seconds = 0.0;
+            totalSamples = 0.0;
+
+            for (const auto& input : inputs)
+            {
+                MakeItHappenOTTProcessor processor;
+                prepareProcessor(processor, state, juce::AudioProcessor::singlePrecision);
+
+                juce::AudioBuffer<float> output(input);
+                juce::MidiBuffer midi;
+                const auto startTicks = juce::Time::getHighResolutionTicks();
+
+                for (int start = 0; start < output.getNumSamples(); start += blockSize)
+                {
+                    const int numSamples = juce::jmin(blockSize, output.getNumSamples() - start);
+                    juce::AudioBuffer<float> block(output.getArrayOfWritePointers(), 2, start, numSamples);
+                    processor.processBlock(block, midi);
+                }
+
+                seconds += juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - startTicks);
+                totalSamples += (double)output.getNumSamples();
+                processor.releaseResources();
+
+                if (run == 0)
+                    rendering.outputs.push_back(std::move(output));
+            }
+
+            bestSeconds = run == 0 ? seconds : juce::jmin(bestSeconds, seconds);
+        }
+
+        rendering.nsPerSample = totalSamples > 0.0 ? bestSeconds * 1.0e9 / totalSamples : 0.0;
+
+        if (withDouble)
+            for (const auto& input : inputs)
+                rendering.doubleOutputs.push_back(renderDouble(state, input));
+
+        return rendering;
+    }
+
+    bool writeWav(const juce::File& file, const juce::AudioBuffer<float>& buffer)
+    {
+        file.deleteFile();
+        auto stream = file.createOutputStream();
+        if (stream == nullptr)
+            return false;
+
+        // 32 bits per sample is IEEE float, so the golden round-trips exactly
+        juce::WavAudioFormat wav;
+        std::unique_ptr<juce::AudioFormatWriter> writer(wav.createWriterFor(stream.get(), sampleRate,
+                                                                            (unsigned int)buffer.getNumChannels(), 32, {}, 0));
+        if (writer == nullptr)
+            return false;
+
+        stream.release(); // now owned by the writer
+        return writer->writeFromAudioSampleBuffer(buffer, 0, buffer.getNumSamples());
+    }
+
+    bool readWav(const juce::File& file, juce::AudioBuffer<float>& buffer)
+    {
+        if (! file.existsAsFile())
+            return false;
+
+        juce::WavAudioFormat wav;
+        std::unique_ptr<juce::AudioFormatReader> reader(wav.createReaderFor(file.createInputStream().release(), true));
+        if (reader == nullptr)
+            return false;
+
+        buffer.setSize((int)reader->numChannels, (int)reader->lengthInSamples);
+        return reader->read(&buffer, 0, buffer.getNumSamples(), 0, true, true);
+    }
+
+    struct Difference
+    {
+        bool finite = true;
+        double peak = 0.0;       // largest sample difference, linear
+        double residualDb = 0.0; // RMS of the difference relative to the golden's RMS
+    };
+
+    Difference compare(const juce::AudioBuffer<float>& output, const juce::AudioBuffer<float>& golden)
+    {
+        Difference difference;
+        double error = 0.0, power = 0.0;
+
+        for (int ch = 0; ch < output.getNumChannels(); ++ch)
+        {
+            const float* out = output.getReadPointer(ch);
+            const float* ref = golden.getReadPointer(ch);
+
+            for (int i = 0; i < output.getNumSamples(); ++i)
+            {
+                difference.finite = difference.finite && std::isfinite(out[i]);
+
+                const double delta = (double)out[i] - (double)ref[i];
+                difference.peak = juce::jmax(difference.peak, std::abs(delta));
+                error += delta * delta;
+                power += (double)ref[i] * (double)ref[i];
+            }
+        }
+
+        difference.residualDb = 10.0 * std::log10((error + 1.0e-30) / (power + 1.0e-30));
+        return difference;
+    }
+
+    void printUsage()
+    {
+        std::printf("usage: MakeItHappenOTTRegression --golden DIR [--update] [--preset NAME] [--tolerance DB]\n"
+                    "                                 [--double-tolerance DB] [--headroom X] [--budget-scale X]\n"
+                    "                                 [--no-budget] [--runs N]\n"
+                    "  --golden        directory of golden files, one subdirectory per preset\n"
+                    "  --update        render and write the goldens and budgets instead of checking them\n"
+                    "  --preset        only this preset\n"
+                    "  --tolerance     largest allowed sample difference, dBFS (default -90)\n"
+                    "  --double-tolerance  the same for the double-precision pass (default -80)\n"
+                    "  --headroom      with --update: budget = measured ns/sample x this (default 1.25)\n"
+                    "  --budget-scale  multiply the stored budgets, e.g. on a slower machine (default 1)\n"
+                    "  --no-budget     check the output only\n"
+                    "  --runs          renders per preset; the fastest is timed (default 3)\n");
+    }
+
+    // Renders the preset's goldens and budget from the preset's values
+    bool updatePreset(const Preset& preset, const juce::File& directory, const std::vector<juce::AudioBuffer<float>>& inputs,
+                      int runs, double headroom)
+    {
+        MakeItHappenOTTProcessor processor;
+        applyPreset(processor, preset);
+
+        juce::MemoryBlock state;
+        processor.getStateInformation(state);
+
+        if (! directory.createDirectory() || ! directory.getChildFile("state.bin").replaceWithData(state.getData(), state.getSize()))
+        {
+            std::printf("%-15s cannot write to %s\n", preset.name, directory.getFullPathName().toRawUTF8());
+            return false;
+        }
+
+        const auto rendering = renderCorpus(state, inputs, runs, false);
+
+        for (size_t s = 0; s < inputs.size(); ++s)
+        {
+            if (! writeWav(directory.getChildFile(juce::String(getCorpus()[s].name) + ".wav"), rendering.outputs[s]))
+            {
+                std::printf("%-15s cannot write %s.wav\n", preset.name, getCorpus()[s].name);
+                return false;
+            }
+        }
+
+        auto* budget = new juce::DynamicObject();
+        budget->setProperty("referenceNsPerSample", rendering.nsPerSample);
+        budget->setProperty("budgetNsPerSample", rendering.nsPerSample * headroom);
+
+        if (! directory.getChildFile("budget.json").replaceWithText(juce::JSON::toString(juce::var(budget))))
+        {
+            std::printf("%-15s cannot write budget.json\n", preset.name);
+            return false;
+        }
+
+        std::printf("%-15s %zu goldens written, %.2f ns/sample, budget %.2f\n", preset.name, inputs.size(),
+                    rendering.nsPerSample, rendering.nsPerSample * headroom);
+        return true;
+    }
+
+    // Renders from the stored state and checks output and cost against the goldens
+    bool checkPreset(const Preset& preset, const juce::File& directory, const std::vector<juce::AudioBuffer<float>>& inputs,
+                     int runs, double toleranceDb, double doubleToleranceDb, double budgetScale, bool checkBudget)
+    {
+        juce::MemoryBlock state;
+        if (! directory.getChildFile("state.bin").loadFileAsData(state))
+        {
+            std::printf("%-15s FAIL: no golden state in %s (run with --update)\n", preset.name, directory.getFullPathName().toRawUTF8());
+            return false;
+        }
+
+        const auto rendering = renderCorpus(state, inputs, runs, true);
+        bool passed = true;
+
+        auto check = [&](const char* signalName, const char* pass, const juce::AudioBuffer<float>& output,
+                         const juce::AudioBuffer<float>& golden, double limitDb)
+        {
+            const auto difference = compare(output, golden);
+            const bool ok = difference.finite && difference.peak <= juce::Decibels::decibelsToGain(limitDb, -1000.0);
+
+            std::printf("%-15s %-14s %-6s %s  peak diff %7.1f dBFS  residual %7.1f dB%s\n", preset.name, signalName, pass,
+                        ok ? "ok  " : "FAIL", juce::Decibels::gainToDecibels(difference.peak, -200.0),
+                        difference.residualDb, difference.finite ? "" : "  (non-finite output)");
+            passed = passed && ok;
+        };
+
+        for (size_t s = 0; s < inputs.size(); ++s)
+        {
+            const auto* signalName = getCorpus()[s].name;
+            juce::AudioBuffer<float> golden;
+
+            if (! readWav(directory.getChildFile(juce::String(signalName) + ".wav"), golden))
+            {
+                std::printf("%-15s %-14s FAIL: golden missing\n", preset.name, signalName);
+                passed = false;
+                continue;
+            }
+
+            const auto& output = rendering.outputs[s];
+            if (golden.getNumChannels() != output.getNumChannels() || golden.getNumSamples() != output.getNumSamples())
+            {
+                std::printf("%-15s %-14s FAIL: golden is %d ch x %d samples, output %d ch x %d\n", preset.name, signalName,
+                            golden.getNumChannels(), golden.getNumSamples(), output.getNumChannels(), output.getNumSamples());
+                passed = false;
+                continue;
+            }
+
+            check(signalName, "float", output, golden, toleranceDb);
+            check(signalName, "double", rendering.doubleOutputs[s], golden, doubleToleranceDb);
+        }
+
+        const auto budget = juce::JSON::parse(directory.getChildFile("budget.json"));
+        const double reference = budget.getProperty("referenceNsPerSample", 0.0);
+        const double limit = (double)budget.getProperty("budgetNsPerSample", 0.0) * budgetScale;
+
+        if (checkBudget && limit <= 0.0)
+        {
+            std::printf("%-15s FAIL: no budget in budget.json\n", preset.name);
+            passed = false;
+        }
+        else if (checkBudget)
+        {
+            const bool withinBudget = rendering.nsPerSample <= limit;
+            std::printf("%-15s %-14s %-6s %s  %.2f ns/sample, budget %.2f (reference %.2f, %.2fx)\n", preset.name, "cost", "float",
+                        withinBudget ? "ok  " : "FAIL", rendering.nsPerSample, limit, reference,
+                        rendering.nsPerSample > 0.0 ? reference / rendering.nsPerSample : 0.0);
+            passed = passed && withinBudget;
+        }
+
+        std::fflush(stdout);
+        return passed;
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    juce::ScopedJuceInitialiser_GUI juceInitialiser;
+    juce::ArgumentList args(argc, argv);
+
+    if (args.containsOption("--help|-h") || ! args.containsOption("--golden"))
+    {
+        printUsage();
+        return args.containsOption("--help|-h") ? 0 : 1;
+    }
+
+    const auto goldenDirectory = args.getFileForOption("--golden");
+    const bool update = args.containsOption("--update");
+    const auto presetFilter = args.getValueForOption("--preset");
+
+    const double toleranceDb = args.containsOption("--tolerance") ? args.getValueForOption("--tolerance").getDoubleValue() : -90.0;
+    const double doubleToleranceDb = args.containsOption("--double-tolerance")
+                                   ? args.getValueForOption("--double-tolerance").getDoubleValue() : -80.0;
+    const double headroom = args.containsOption("--headroom") ? juce::jmax(1.0, args.getValueForOption("--headroom").getDoubleValue()) : 1.25;
+    const double budgetScale = args.containsOption("--budget-scale") ? args.getValueForOption("--budget-scale").getDoubleValue() : 1.0;
+    const bool checkBudget = ! args.containsOption("--no-budget");
+    const int runs = args.containsOption("--runs") ? juce::jmax(1, args.getValueForOption("--runs").getIntValue()) : 3;
+
+    std::vector<juce::AudioBuffer<float>> inputs;
+    for (const auto& signal : getCorpus())
+        inputs.push_back(signal.generate());
+
+    int failed = 0, checked = 0;
+
+    for (const auto& preset : getPresets())
+    {
+        if (presetFilter.isNotEmpty() && presetFilter != preset.name)
+            continue;
+
+        const auto directory = goldenDirectory.getChildFile(preset.name);
+        const bool passed = update ? updatePreset(preset, directory, inputs, runs, headroom)
+                                   : checkPreset(preset, directory, inputs, runs, toleranceDb, doubleToleranceDb,
+                                                 budgetScale, checkBudget);
+        ++checked;
+        failed += passed ? 0 : 1;
+    }
+
+    if (checked == 0)
+    {
+        std::printf("no preset named %s\n", presetFilter.toRawUTF8());
+        return 1;
+    }
+
+    if (! update)
+        std::printf("%s: %d of %d presets passed (tolerance %.1f dBFS, double %.1f dBFS)\n", failed == 0 ? "PASS" : "FAIL",
+                    checked - failed, checked, toleranceDb, doubleToleranceDb);
+
+    return failed == 0 ? 0 : 1;
+}
@@ -0,0 +1,50 @@
+#pragma once
+#include "../src/PluginProcessor.h"
+
+#include <utility>
+#include <vector>
+
+// Parameter presets shared by the headless tools: named sets of values that
+// differ from the defaults, chosen so every band mode, crossover and detector
+// option is exercised by at least one of them.
+struct Preset
+{
+    const char* name;
+    std::vector<std::pair<const char*, float>> values;
+};
+
+inline const std::vector<Preset>& getPresets()
+{
+    static const std::vector<Preset> presets {
+        { "default", {} },
+        { "gentle", { { "depth", 30.0f },
+                      { "lowRatioDown", 2.0f }, { "midRatioDown", 2.0f }, { "highRatioDown", 2.0f },
+                      { "lowRatioUp", 1.5f }, { "midRatioUp", 1.5f }, { "highRatioUp", 1.5f } } },
+        { "aggressive", { { "depth", 100.0f }, { "time", 50.0f },
+                          { "lowThreshDown", -35.0f }, { "midThreshDown", -35.0f }, { "highThreshDown", -35.0f },
+                          { "lowRatioDown", 20.0f }, { "midRatioDown", 20.0f }, { "highRatioDown", 20.0f },
+                          { "lowRatioUp", 10.0f }, { "midRatioUp", 10.0f }, { "highRatioUp", 10.0f },
+                          { "lowWidth", 150.0f }, { "highWidth", 200.0f } } },
+        { "gainmatch-solo", { { "gainMatch", 1.0f }, { "midSolo", 1.0f }, { "depth", 80.0f } } },
+        { "4-band", { { "bandMode", 1.0f } } },
+        { "5-band", { { "bandMode", 2.0f }, { "highMidWidth", 150.0f } } },
+        { "linear-phase", { { "crossoverMode", 1.0f } } },
+        { "linear-phase-5", { { "crossoverMode", 1.0f }, { "bandMode", 2.0f } } },
+        { "linked", { { "linkedDetection", 1.0f } } },
+        { "lookahead", { { "lookahead", 5.0f } } },
+        { "lookahead-linked", { { "lookahead", 5.0f }, { "linkedDetection", 1.0f } } },
+    };
+
+    return presets;
+}
+
+// Resets every parameter to its default, then applies the preset's values
+inline void applyPreset(MakeItHappenOTTProcessor& processor, const Preset& preset)
+{
+    for (auto* parameter : processor.getParameters())
+        parameter->setValueNotifyingHost(parameter->getDefaultValue());
+
+    for (const auto& [parameterID, value] : preset.values)
+        if (auto* parameter = processor.apvts.getParameter(parameterID))
+            parameter->setValueNotifyingHost(parameter->convertTo0to1(value));
+}